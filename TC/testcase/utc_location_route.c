@@ -19,7 +19,13 @@
 #include <route_service.h>
 #include <route_preference.h>
 #include <route.h>
+#include <route_tracker.h>
+#include <route_store.h>
 #include <glib.h>
+#include <stdlib.h>
+#include <stdio.h>
+
+#define ROUTE_STORE_TEST_PATH "/tmp/utc_location_route_store"
 
 enum {
 	POSITIVE_TC_IDX = 0x01,
@@ -33,9 +39,15 @@ void (*tet_startup) (void) = startup;
 void (*tet_cleanup) (void) = cleanup;
 
 static void utc_location_route_clone_p(void);
+static void utc_location_route_clone_p_02(void);
 static void utc_location_route_clone_n(void);
 static void utc_location_route_destroy_p(void);
 static void utc_location_route_destroy_n(void);
+static void utc_location_route_retain_p(void);
+static void utc_location_route_retain_p_02(void);
+static void utc_location_route_retain_n(void);
+static void utc_location_route_release_p(void);
+static void utc_location_route_release_n(void);
 static void utc_location_route_get_request_id_p(void);
 static void utc_location_route_get_request_id_n(void);
 static void utc_location_route_get_request_id_n_02(void);
@@ -64,6 +76,55 @@ static void utc_location_route_foreach_properties_n_02(void);
 static void utc_location_route_foreach_segments_p(void);
 static void utc_location_route_foreach_segments_n(void);
 static void utc_location_route_foreach_segments_n_02(void);
+static void utc_location_route_get_polyline_p(void);
+static void utc_location_route_get_polyline_n(void);
+static void utc_location_route_get_polyline_n_02(void);
+static void utc_location_route_simplify_geometry_p(void);
+static void utc_location_route_simplify_geometry_n(void);
+static void utc_location_route_simplify_geometry_n_02(void);
+static void utc_location_route_encode_polyline_p(void);
+static void utc_location_route_encode_polyline_n(void);
+static void utc_location_route_decode_polyline_p(void);
+static void utc_location_route_decode_polyline_n(void);
+static void utc_location_route_find_nearest_position_p(void);
+static void utc_location_route_find_nearest_position_n(void);
+static void utc_location_route_find_nearest_position_n_02(void);
+static void utc_location_route_get_polyline_distances_p(void);
+static void utc_location_route_get_polyline_distances_n(void);
+static void utc_location_route_get_position_at_distance_p(void);
+static void utc_location_route_get_position_at_distance_n(void);
+static void utc_location_route_get_elapsed_time_at_distance_p(void);
+static void utc_location_route_get_elapsed_time_at_distance_n(void);
+static void utc_location_route_get_elapsed_time_at_position_p(void);
+static void utc_location_route_get_elapsed_time_at_position_n(void);
+static void utc_location_route_get_similarity_p(void);
+static void utc_location_route_get_similarity_n(void);
+static void utc_location_route_foreach_steps_in_bounds_p(void);
+static void utc_location_route_foreach_steps_in_bounds_p_02(void);
+static void utc_location_route_foreach_steps_in_bounds_n(void);
+static void utc_location_route_foreach_steps_in_bounds_n_02(void);
+static void utc_location_route_serialize_p(void);
+static void utc_location_route_serialize_n(void);
+static void utc_location_route_deserialize_n(void);
+static void utc_location_route_deserialize_n_02(void);
+static void utc_location_route_store_open_p(void);
+static void utc_location_route_store_open_n(void);
+static void utc_location_route_store_append_p(void);
+static void utc_location_route_store_append_n(void);
+static void utc_location_route_store_get_route_p(void);
+static void utc_location_route_store_get_route_n(void);
+static void utc_location_route_write_geojson_p(void);
+static void utc_location_route_write_geojson_n(void);
+static void utc_location_route_write_geojson_to_fd_p(void);
+static void utc_location_route_write_geojson_to_fd_n(void);
+static void utc_location_route_clone_compact_p(void);
+static void utc_location_route_clone_compact_p_02(void);
+static void utc_location_route_clone_compact_n(void);
+static void utc_location_route_tracker_create_p(void);
+static void utc_location_route_tracker_create_n(void);
+static void utc_location_route_tracker_update_p(void);
+static void utc_location_route_tracker_update_p_02(void);
+static void utc_location_route_tracker_update_n(void);
 static void utc_location_route_segment_clone_p(void);
 static void utc_location_route_segment_clone_n(void);
 static void utc_location_route_segment_destroy_p(void);
@@ -119,15 +180,23 @@ static void utc_location_route_step_get_instruction_n_02(void);
 static void utc_location_route_step_foreach_geometries_p(void);
 static void utc_location_route_step_foreach_geometries_n(void);
 static void utc_location_route_step_foreach_geometries_n_02(void);
+static void utc_location_route_step_encode_polyline_p(void);
+static void utc_location_route_step_encode_polyline_n(void);
 static void utc_location_route_step_foreach_properties_p(void);
 static void utc_location_route_step_foreach_properties_n(void);
 static void utc_location_route_step_foreach_properties_n_02(void);
 
 struct tet_testlist tet_testlist[] = {
 	{utc_location_route_clone_p, POSITIVE_TC_IDX},
+	{utc_location_route_clone_p_02, POSITIVE_TC_IDX},
 	{utc_location_route_clone_n, NEGATIVE_TC_IDX},
 	{utc_location_route_destroy_p, POSITIVE_TC_IDX},
 	{utc_location_route_destroy_n, NEGATIVE_TC_IDX},
+	{utc_location_route_retain_p, POSITIVE_TC_IDX},
+	{utc_location_route_retain_p_02, POSITIVE_TC_IDX},
+	{utc_location_route_retain_n, NEGATIVE_TC_IDX},
+	{utc_location_route_release_p, POSITIVE_TC_IDX},
+	{utc_location_route_release_n, NEGATIVE_TC_IDX},
 	{utc_location_route_get_request_id_p, POSITIVE_TC_IDX},
 	{utc_location_route_get_request_id_n, NEGATIVE_TC_IDX},
 	{utc_location_route_get_request_id_n_02, NEGATIVE_TC_IDX},
@@ -156,6 +225,55 @@ struct tet_testlist tet_testlist[] = {
 	{utc_location_route_foreach_segments_p, POSITIVE_TC_IDX},
 	{utc_location_route_foreach_segments_n, NEGATIVE_TC_IDX},
 	{utc_location_route_foreach_segments_n_02, NEGATIVE_TC_IDX},
+	{utc_location_route_get_polyline_p, POSITIVE_TC_IDX},
+	{utc_location_route_get_polyline_n, NEGATIVE_TC_IDX},
+	{utc_location_route_get_polyline_n_02, NEGATIVE_TC_IDX},
+	{utc_location_route_simplify_geometry_p, POSITIVE_TC_IDX},
+	{utc_location_route_simplify_geometry_n, NEGATIVE_TC_IDX},
+	{utc_location_route_simplify_geometry_n_02, NEGATIVE_TC_IDX},
+	{utc_location_route_encode_polyline_p, POSITIVE_TC_IDX},
+	{utc_location_route_encode_polyline_n, NEGATIVE_TC_IDX},
+	{utc_location_route_decode_polyline_p, POSITIVE_TC_IDX},
+	{utc_location_route_decode_polyline_n, NEGATIVE_TC_IDX},
+	{utc_location_route_find_nearest_position_p, POSITIVE_TC_IDX},
+	{utc_location_route_find_nearest_position_n, NEGATIVE_TC_IDX},
+	{utc_location_route_find_nearest_position_n_02, NEGATIVE_TC_IDX},
+	{utc_location_route_get_polyline_distances_p, POSITIVE_TC_IDX},
+	{utc_location_route_get_polyline_distances_n, NEGATIVE_TC_IDX},
+	{utc_location_route_get_position_at_distance_p, POSITIVE_TC_IDX},
+	{utc_location_route_get_position_at_distance_n, NEGATIVE_TC_IDX},
+	{utc_location_route_get_elapsed_time_at_distance_p, POSITIVE_TC_IDX},
+	{utc_location_route_get_elapsed_time_at_distance_n, NEGATIVE_TC_IDX},
+	{utc_location_route_get_elapsed_time_at_position_p, POSITIVE_TC_IDX},
+	{utc_location_route_get_elapsed_time_at_position_n, NEGATIVE_TC_IDX},
+	{utc_location_route_get_similarity_p, POSITIVE_TC_IDX},
+	{utc_location_route_get_similarity_n, NEGATIVE_TC_IDX},
+	{utc_location_route_foreach_steps_in_bounds_p, POSITIVE_TC_IDX},
+	{utc_location_route_foreach_steps_in_bounds_p_02, POSITIVE_TC_IDX},
+	{utc_location_route_foreach_steps_in_bounds_n, NEGATIVE_TC_IDX},
+	{utc_location_route_foreach_steps_in_bounds_n_02, NEGATIVE_TC_IDX},
+	{utc_location_route_serialize_p, POSITIVE_TC_IDX},
+	{utc_location_route_serialize_n, NEGATIVE_TC_IDX},
+	{utc_location_route_deserialize_n, NEGATIVE_TC_IDX},
+	{utc_location_route_deserialize_n_02, NEGATIVE_TC_IDX},
+	{utc_location_route_store_open_p, POSITIVE_TC_IDX},
+	{utc_location_route_store_open_n, NEGATIVE_TC_IDX},
+	{utc_location_route_store_append_p, POSITIVE_TC_IDX},
+	{utc_location_route_store_append_n, NEGATIVE_TC_IDX},
+	{utc_location_route_store_get_route_p, POSITIVE_TC_IDX},
+	{utc_location_route_store_get_route_n, NEGATIVE_TC_IDX},
+	{utc_location_route_write_geojson_p, POSITIVE_TC_IDX},
+	{utc_location_route_write_geojson_n, NEGATIVE_TC_IDX},
+	{utc_location_route_write_geojson_to_fd_p, POSITIVE_TC_IDX},
+	{utc_location_route_write_geojson_to_fd_n, NEGATIVE_TC_IDX},
+	{utc_location_route_clone_compact_p, POSITIVE_TC_IDX},
+	{utc_location_route_clone_compact_p_02, POSITIVE_TC_IDX},
+	{utc_location_route_clone_compact_n, NEGATIVE_TC_IDX},
+	{utc_location_route_tracker_create_p, POSITIVE_TC_IDX},
+	{utc_location_route_tracker_create_n, NEGATIVE_TC_IDX},
+	{utc_location_route_tracker_update_p, POSITIVE_TC_IDX},
+	{utc_location_route_tracker_update_p_02, POSITIVE_TC_IDX},
+	{utc_location_route_tracker_update_n, NEGATIVE_TC_IDX},
 	{utc_location_route_segment_clone_p, POSITIVE_TC_IDX},
 	{utc_location_route_segment_clone_n, NEGATIVE_TC_IDX},
 	{utc_location_route_segment_destroy_p, POSITIVE_TC_IDX},
@@ -211,6 +329,8 @@ struct tet_testlist tet_testlist[] = {
 	{utc_location_route_step_foreach_geometries_p, POSITIVE_TC_IDX},
 	{utc_location_route_step_foreach_geometries_n, NEGATIVE_TC_IDX},
 	{utc_location_route_step_foreach_geometries_n_02, NEGATIVE_TC_IDX},
+	{utc_location_route_step_encode_polyline_p, POSITIVE_TC_IDX},
+	{utc_location_route_step_encode_polyline_n, NEGATIVE_TC_IDX},
 	{utc_location_route_step_foreach_properties_p, POSITIVE_TC_IDX},
 	{utc_location_route_step_foreach_properties_n, NEGATIVE_TC_IDX},
 	{utc_location_route_step_foreach_properties_n_02, NEGATIVE_TC_IDX},
@@ -398,6 +518,12 @@ static bool capi_step_foreach_property_cb(const char *key, const char *value, vo
 	return TRUE;
 }
 
+static bool capi_steps_in_bounds_cb(route_step_h step, int segment_index, int step_index, void *user_data)
+{
+	(*(int *)user_data)++;
+	return TRUE;
+}
+
 static void utc_location_route_clone_p(void)
 {
 	int ret = ROUTE_ERROR_NONE;
@@ -407,6 +533,27 @@ static void utc_location_route_clone_p(void)
 	validate_eq(__func__, ret, ROUTE_ERROR_NONE);
 }
 
+static void utc_location_route_clone_p_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_h cloned;
+	route_h cloned_again;
+	double distance = 0;
+	double cloned_distance = 0;
+
+	ret = route_clone(&cloned, g_route);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_clone() is failed");
+
+	ret = route_clone(&cloned_again, cloned);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_clone() is failed");
+
+	route_destroy(cloned);
+	route_get_total_distance(g_route, &distance);
+	route_get_total_distance(cloned_again, &cloned_distance);
+	route_destroy(cloned_again);
+	validate_eq(__func__, cloned_distance == distance, true);
+}
+
 static void utc_location_route_clone_n(void)
 {
 	int ret = ROUTE_ERROR_NONE;
@@ -435,6 +582,106 @@ static void utc_location_route_destroy_n(void)
 	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
 }
 
+static void utc_location_route_retain_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+
+	ret = route_retain(g_route);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_retain() is failed");
+
+	ret = route_release(g_route);
+	validate_eq(__func__, ret, ROUTE_ERROR_NONE);
+}
+
+/* The route of the found callback retained by two threads at once, and the results of their route_retain() */
+static route_h concurrent_route;
+static int concurrent_retain_results[2];
+static bool concurrent_retain_done = FALSE;
+
+static gpointer capi_route_retain_thread(gpointer data)
+{
+	int *result = (int *)data;
+
+	*result = route_retain(concurrent_route);
+	return NULL;
+}
+
+static bool capi_route_retain_concurrently_cb(route_error_e error, int index, int total, route_h route, void *user_data)
+{
+	GThread *threads[2];
+	int i;
+
+	if (error == ROUTE_ERROR_NONE && index == 0) {
+		concurrent_route = route;
+		for (i = 0; i < 2; i++) {
+			threads[i] = g_thread_create(capi_route_retain_thread, &concurrent_retain_results[i], 1, NULL);
+		}
+		for (i = 0; i < 2; i++) {
+			g_thread_join(threads[i]);
+		}
+	}
+	concurrent_retain_done = TRUE;
+	return FALSE;
+}
+
+static void utc_location_route_retain_p_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int timeout = 0;
+	int request_id;
+	double distance = 0;
+	location_coords_s origin = { 37.564263, 126.974676 };
+	location_coords_s destination = { 37.55712, 126.99241 };
+
+	route_service_clear_cache(g_service);
+	ret = route_service_find(g_service, origin, destination, NULL, 0, capi_route_retain_concurrently_cb, NULL,
+				 &request_id);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_find() is failed");
+	for (timeout; timeout < 180 && !concurrent_retain_done; timeout++) {
+		sleep(1);
+	}
+	validate_and_next(__func__, concurrent_route != NULL, TRUE, "No route is found");
+	validate_and_next(__func__, concurrent_retain_results[0], ROUTE_ERROR_NONE, "route_retain() is failed");
+	validate_and_next(__func__, concurrent_retain_results[1], ROUTE_ERROR_NONE, "route_retain() is failed");
+
+	/* Both handles outlive the callback, each one with its own reference */
+	ret = route_release(concurrent_route);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_release() is failed");
+	ret = route_get_total_distance(concurrent_route, &distance);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_get_total_distance() is failed");
+	validate_and_next(__func__, distance > 0, TRUE, "The retained route is not valid");
+	ret = route_release(concurrent_route);
+	validate_eq(__func__, ret, ROUTE_ERROR_NONE);
+}
+
+static void utc_location_route_retain_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+
+	ret = route_retain(NULL);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_release_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_h cloned;
+
+	ret = route_clone(&cloned, g_route);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_clone() is failed");
+
+	ret = route_release(cloned);
+	validate_eq(__func__, ret, ROUTE_ERROR_NONE);
+}
+
+static void utc_location_route_release_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+
+	ret = route_release(NULL);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
 static void utc_location_route_get_request_id_p(void)
 {
 	int ret = ROUTE_ERROR_NONE;
@@ -689,6 +936,718 @@ static void utc_location_route_foreach_segments_n_02(void)
 	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
 }
 
+static void utc_location_route_get_polyline_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	const double *latitudes;
+	const double *longitudes;
+	int count = 0;
+
+	ret = route_get_polyline(g_route, &latitudes, &longitudes, &count);
+	validate_eq(__func__, ret, ROUTE_ERROR_NONE);
+}
+
+static void utc_location_route_get_polyline_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	const double *latitudes;
+	const double *longitudes;
+	int count = 0;
+
+	ret = route_get_polyline(NULL, &latitudes, &longitudes, &count);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_get_polyline_n_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	const double *latitudes;
+	const double *longitudes;
+
+	ret = route_get_polyline(g_route, &latitudes, &longitudes, NULL);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_simplify_geometry_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	const double *latitudes;
+	const double *longitudes;
+	double *simplified_latitudes;
+	double *simplified_longitudes;
+	int count = 0;
+	int simplified_count = 0;
+	bool ends_kept;
+
+	route_get_polyline(g_route, &latitudes, &longitudes, &count);
+	ret = route_simplify_geometry(g_route, 10, ROUTE_SIMPLIFY_DOUGLAS_PEUCKER, &simplified_latitudes, &simplified_longitudes, &simplified_count);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_simplify_geometry() is failed");
+
+	dts_message(__func__, "%d of %d points kept", simplified_count, count);
+	ends_kept = simplified_count <= count && simplified_latitudes[0] == latitudes[0]
+		&& simplified_longitudes[simplified_count - 1] == longitudes[count - 1];
+	free(simplified_latitudes);
+	free(simplified_longitudes);
+	validate_eq(__func__, ends_kept, true);
+}
+
+static void utc_location_route_simplify_geometry_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	double *latitudes;
+	double *longitudes;
+	int count = 0;
+
+	ret = route_simplify_geometry(NULL, 10, ROUTE_SIMPLIFY_DOUGLAS_PEUCKER, &latitudes, &longitudes, &count);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_simplify_geometry_n_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	double *latitudes;
+	double *longitudes;
+	int count = 0;
+
+	ret = route_simplify_geometry(g_route, -1, ROUTE_SIMPLIFY_VISVALINGAM_WHYATT, &latitudes, &longitudes, &count);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_encode_polyline_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	char *encoded = NULL;
+
+	ret = route_encode_polyline(g_route, ROUTE_POLYLINE_PRECISION_5, &encoded);
+	free(encoded);
+	validate_eq(__func__, ret, ROUTE_ERROR_NONE);
+}
+
+static void utc_location_route_encode_polyline_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	char *encoded;
+
+	ret = route_encode_polyline(g_route, 7, &encoded);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_decode_polyline_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	double *latitudes;
+	double *longitudes;
+	int count = 0;
+	bool decoded;
+
+	ret = route_decode_polyline("_p~iF~ps|U_ulLnnqC_mqNvxq`@", ROUTE_POLYLINE_PRECISION_5, &latitudes, &longitudes, &count);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_decode_polyline() is failed");
+
+	decoded = count == 3 && latitudes[0] == 38.5 && longitudes[0] == -120.2
+		&& latitudes[2] == 43.252 && longitudes[2] == -126.453;
+	free(latitudes);
+	free(longitudes);
+	validate_eq(__func__, decoded, true);
+}
+
+static void utc_location_route_decode_polyline_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	double *latitudes;
+	double *longitudes;
+	int count = 0;
+
+	ret = route_decode_polyline("_p~iF~ps|U_", ROUTE_POLYLINE_PRECISION_5, &latitudes, &longitudes, &count);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_find_nearest_position_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	location_coords_s origin;
+	location_coords_s snapped;
+	int segment_index = -1;
+	int step_index = -1;
+	double offset = -1;
+
+	route_get_origin(g_route, &origin);
+	ret = route_find_nearest_position(g_route, origin, &snapped, &segment_index, &step_index, &offset);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_find_nearest_position() is failed");
+
+	dts_message(__func__, "segment %d, step %d, offset %f", segment_index, step_index, offset);
+	validate_eq(__func__, segment_index, 0);
+}
+
+static void utc_location_route_find_nearest_position_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	location_coords_s coords = { 37.560000, 126.980000 };
+	location_coords_s snapped;
+	int segment_index;
+	int step_index;
+	double offset;
+
+	ret = route_find_nearest_position(NULL, coords, &snapped, &segment_index, &step_index, &offset);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_find_nearest_position_n_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	location_coords_s coords = { 37.560000, 126.980000 };
+	int segment_index;
+	int step_index;
+	double offset;
+
+	ret = route_find_nearest_position(g_route, coords, NULL, &segment_index, &step_index, &offset);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_get_polyline_distances_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	const double *distances;
+	int count = 0;
+
+	ret = route_get_polyline_distances(g_route, &distances, &count);
+	validate_eq(__func__, ret, ROUTE_ERROR_NONE);
+}
+
+static void utc_location_route_get_polyline_distances_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	const double *distances;
+	int count = 0;
+
+	ret = route_get_polyline_distances(NULL, &distances, &count);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_get_position_at_distance_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	const double *distances;
+	int count = 0;
+	location_coords_s position;
+	int segment_index;
+	int step_index;
+
+	ret = route_get_polyline_distances(g_route, &distances, &count);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_get_polyline_distances() is failed");
+
+	ret = route_get_position_at_distance(g_route, distances[count - 1] / 2, &position, &segment_index, &step_index);
+	validate_eq(__func__, ret, ROUTE_ERROR_NONE);
+}
+
+static void utc_location_route_get_position_at_distance_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	location_coords_s position;
+	int segment_index;
+	int step_index;
+
+	ret = route_get_position_at_distance(g_route, -1, &position, &segment_index, &step_index);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_get_elapsed_time_at_distance_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	const double *distances;
+	int count = 0;
+	long elapsed = 0;
+	long duration = 0;
+
+	ret = route_get_polyline_distances(g_route, &distances, &count);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_get_polyline_distances() is failed");
+	ret = route_get_total_duration(g_route, &duration);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_get_total_duration() is failed");
+
+	ret = route_get_elapsed_time_at_distance(g_route, distances[count - 1] / 2, &elapsed);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_get_elapsed_time_at_distance() is failed");
+	validate_eq(__func__, elapsed >= 0 && elapsed <= duration, TRUE);
+}
+
+static void utc_location_route_get_elapsed_time_at_distance_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	long elapsed;
+
+	ret = route_get_elapsed_time_at_distance(g_route, -1, &elapsed);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_get_elapsed_time_at_position_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	location_coords_s origin = { 37.564263, 126.974676 };
+	long elapsed = -1;
+	long duration = 0;
+
+	ret = route_get_total_duration(g_route, &duration);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_get_total_duration() is failed");
+
+	ret = route_get_elapsed_time_at_position(g_route, origin, &elapsed);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_get_elapsed_time_at_position() is failed");
+	validate_eq(__func__, elapsed >= 0 && elapsed <= duration, TRUE);
+}
+
+static void utc_location_route_get_elapsed_time_at_position_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	location_coords_s origin = { 37.564263, 126.974676 };
+
+	ret = route_get_elapsed_time_at_position(g_route, origin, NULL);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_get_similarity_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	double similarity = 0;
+
+	ret = route_get_similarity(g_route, g_route, &similarity);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_get_similarity() is failed");
+	validate_eq(__func__, similarity == 1, TRUE);
+}
+
+static void utc_location_route_get_similarity_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	double similarity;
+
+	ret = route_get_similarity(g_route, NULL, &similarity);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_foreach_steps_in_bounds_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	location_coords_s top_left = { 90, -180 };
+	location_coords_s bottom_right = { -90, 180 };
+	int count = 0;
+
+	ret = route_foreach_steps_in_bounds(g_route, top_left, bottom_right, capi_steps_in_bounds_cb, &count);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_foreach_steps_in_bounds() is failed");
+	validate_eq(__func__, count > 0, TRUE);
+}
+
+typedef struct {
+	int count;
+	double distance;
+} capi_steps_in_bounds_s;
+
+static bool capi_steps_in_bounds_sum_cb(route_step_h step, int segment_index, int step_index, void *user_data)
+{
+	capi_steps_in_bounds_s *sum = (capi_steps_in_bounds_s *) user_data;
+	double distance = 0;
+
+	route_step_get_distance(step, &distance);
+	sum->count++;
+	sum->distance += distance;
+	return TRUE;
+}
+
+/* The route of the found callback, retained once its steps are indexed, and the steps found then */
+static route_h indexed_route;
+static capi_steps_in_bounds_s indexed_steps;
+static bool indexed_route_done = FALSE;
+
+static bool capi_route_index_then_retain_cb(route_error_e error, int index, int total, route_h route, void *user_data)
+{
+	location_coords_s top_left = { 90, -180 };
+	location_coords_s bottom_right = { -90, 180 };
+
+	if (error == ROUTE_ERROR_NONE && index == 0) {
+		/* Indexes the steps of the route before route_retain() moves it */
+		if (route_foreach_steps_in_bounds(route, top_left, bottom_right, capi_steps_in_bounds_sum_cb,
+						  &indexed_steps) == ROUTE_ERROR_NONE && route_retain(route) == ROUTE_ERROR_NONE) {
+			indexed_route = route;
+		}
+	}
+	indexed_route_done = TRUE;
+	return FALSE;
+}
+
+static void utc_location_route_foreach_steps_in_bounds_p_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int timeout = 0;
+	int request_id;
+	location_coords_s origin = { 37.564263, 126.974676 };
+	location_coords_s destination = { 37.55712, 126.99241 };
+	location_coords_s top_left = { 90, -180 };
+	location_coords_s bottom_right = { -90, 180 };
+	capi_steps_in_bounds_s sum = { 0, 0 };
+
+	route_service_clear_cache(g_service);
+	ret = route_service_find(g_service, origin, destination, NULL, 0, capi_route_index_then_retain_cb, NULL,
+				 &request_id);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_find() is failed");
+	for (timeout; timeout < 180 && !indexed_route_done; timeout++) {
+		sleep(1);
+	}
+	validate_and_next(__func__, indexed_route != NULL, TRUE, "No route is indexed and retained");
+
+	/* The index built in the found callback still gives the steps of the retained route */
+	ret = route_foreach_steps_in_bounds(indexed_route, top_left, bottom_right, capi_steps_in_bounds_sum_cb, &sum);
+	route_release(indexed_route);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_foreach_steps_in_bounds() is failed");
+	validate_and_next(__func__, sum.count, indexed_steps.count, "The retained route has other steps");
+	validate_eq(__func__, sum.distance == indexed_steps.distance, TRUE);
+}
+
+static void utc_location_route_foreach_steps_in_bounds_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	location_coords_s top_left = { 90, -180 };
+	location_coords_s bottom_right = { -90, 180 };
+
+	ret = route_foreach_steps_in_bounds(g_route, top_left, bottom_right, NULL, NULL);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_foreach_steps_in_bounds_n_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	location_coords_s top_left = { -90, -180 };
+	location_coords_s bottom_right = { 90, 180 };
+	int count = 0;
+
+	ret = route_foreach_steps_in_bounds(g_route, top_left, bottom_right, capi_steps_in_bounds_cb, &count);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_serialize_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	unsigned char *buffer = NULL;
+	int length = 0;
+	route_h route = NULL;
+	double distance = 0;
+	double expected = 0;
+
+	ret = route_serialize(g_route, &buffer, &length);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_serialize() is failed");
+
+	ret = route_deserialize(buffer, length, &route);
+	free(buffer);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_deserialize() is failed");
+
+	route_get_total_distance(g_route, &expected);
+	route_get_total_distance(route, &distance);
+	route_destroy(route);
+	validate_eq(__func__, distance == expected, TRUE);
+}
+
+static void utc_location_route_serialize_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int length = 0;
+
+	ret = route_serialize(g_route, NULL, &length);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_deserialize_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_h route = NULL;
+
+	ret = route_deserialize(NULL, 16, &route);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_deserialize_n_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	unsigned char *buffer = NULL;
+	int length = 0;
+	route_h route = NULL;
+
+	ret = route_serialize(g_route, &buffer, &length);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_serialize() is failed");
+
+	ret = route_deserialize(buffer, length - 1, &route);
+	free(buffer);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void __remove_store(void)
+{
+	remove(ROUTE_STORE_TEST_PATH);
+	remove(ROUTE_STORE_TEST_PATH ".idx");
+}
+
+static void utc_location_route_store_open_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_store_h store = NULL;
+	int count = -1;
+
+	__remove_store();
+	ret = route_store_open(ROUTE_STORE_TEST_PATH, &store);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_store_open() is failed");
+
+	ret = route_store_get_count(store, &count);
+	route_store_close(store);
+	__remove_store();
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_store_get_count() is failed");
+	validate_eq(__func__, count, 0);
+}
+
+static void utc_location_route_store_open_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_store_h store = NULL;
+
+	ret = route_store_open(NULL, &store);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_store_append_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_store_h store = NULL;
+	int index = -1;
+
+	__remove_store();
+	ret = route_store_open(ROUTE_STORE_TEST_PATH, &store);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_store_open() is failed");
+
+	route_store_append(store, g_route, &index);
+	ret = route_store_append(store, g_route, &index);
+	route_store_close(store);
+	__remove_store();
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_store_append() is failed");
+	validate_eq(__func__, index, 1);
+}
+
+static void utc_location_route_store_append_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int index = -1;
+
+	ret = route_store_append(NULL, g_route, &index);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_store_get_route_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_store_h store = NULL;
+	route_h route = NULL;
+	int index = -1;
+	double distance = 0;
+	double expected = 0;
+
+	__remove_store();
+	ret = route_store_open(ROUTE_STORE_TEST_PATH, &store);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_store_open() is failed");
+
+	route_store_append(store, g_route, &index);
+	ret = route_store_get_route(store, index, &route);
+	route_store_close(store);
+	__remove_store();
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_store_get_route() is failed");
+
+	route_get_total_distance(g_route, &expected);
+	route_get_total_distance(route, &distance);
+	route_destroy(route);
+	validate_eq(__func__, distance == expected, TRUE);
+}
+
+static void utc_location_route_store_get_route_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_store_h store = NULL;
+	route_h route = NULL;
+
+	__remove_store();
+	ret = route_store_open(ROUTE_STORE_TEST_PATH, &store);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_store_open() is failed");
+
+	ret = route_store_get_route(store, 0, &route);
+	route_store_close(store);
+	__remove_store();
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_write_geojson_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	char *buffer = NULL;
+	int length = 0;
+	int written = 0;
+
+	ret = route_write_geojson(g_route, NULL, 0, &length);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_write_geojson() is failed");
+
+	buffer = (char *) malloc(length + 1);
+	ret = route_write_geojson(g_route, buffer, length + 1, &written);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_write_geojson() is failed");
+
+	ret = written == length && buffer[0] == '{' && buffer[length - 1] == '}' && buffer[length] == '\0';
+	free(buffer);
+	validate_eq(__func__, ret, TRUE);
+}
+
+static void utc_location_route_write_geojson_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int length = 0;
+
+	ret = route_write_geojson(g_route, NULL, 16, &length);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_write_geojson_to_fd_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	FILE *file = tmpfile();
+	int length = 0;
+
+	ret = route_write_geojson_to_fd(g_route, fileno(file));
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_write_geojson_to_fd() is failed");
+
+	route_write_geojson(g_route, NULL, 0, &length);
+	fseek(file, 0, SEEK_END);
+	ret = ftell(file) == length;
+	fclose(file);
+	validate_eq(__func__, ret, TRUE);
+}
+
+static void utc_location_route_write_geojson_to_fd_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+
+	ret = route_write_geojson_to_fd(g_route, -1);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_clone_compact_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_h compact;
+	double distance = 0;
+	double compact_distance = 0;
+
+	ret = route_clone_compact(&compact, g_route);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_clone_compact() is failed");
+
+	route_get_total_distance(g_route, &distance);
+	route_get_total_distance(compact, &compact_distance);
+	route_destroy(compact);
+	validate_eq(__func__, compact_distance == distance, true);
+}
+
+static void utc_location_route_clone_compact_p_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_h compact;
+	location_coords_s top_left = { 90, -180 };
+	location_coords_s bottom_right = { -90, 180 };
+	double distance = 0;
+	long elapsed = -1;
+	long compact_elapsed = -1;
+	int count = 0;
+	int compact_count = 0;
+
+	/* The step lookups of a compact route read it in place, and find what those of the route find */
+	ret = route_clone_compact(&compact, g_route);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_clone_compact() is failed");
+
+	route_get_total_distance(g_route, &distance);
+	route_get_elapsed_time_at_distance(g_route, distance / 2, &elapsed);
+	route_get_elapsed_time_at_distance(compact, distance / 2, &compact_elapsed);
+	route_foreach_steps_in_bounds(g_route, top_left, bottom_right, capi_steps_in_bounds_cb, &count);
+	ret = route_foreach_steps_in_bounds(compact, top_left, bottom_right, capi_steps_in_bounds_cb, &compact_count);
+	route_destroy(compact);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_foreach_steps_in_bounds() is failed");
+	validate_and_next(__func__, compact_count, count, "The compact route has other steps");
+	validate_eq(__func__, labs(compact_elapsed - elapsed) <= 1, TRUE);
+}
+
+static void utc_location_route_clone_compact_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_h compact;
+
+	ret = route_clone_compact(&compact, NULL);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_tracker_create_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_tracker_h tracker;
+
+	ret = route_tracker_create(g_route, 50, &tracker);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_tracker_create() is failed");
+
+	ret = route_tracker_destroy(tracker);
+	validate_eq(__func__, ret, ROUTE_ERROR_NONE);
+}
+
+static void utc_location_route_tracker_create_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_tracker_h tracker;
+
+	ret = route_tracker_create(g_route, 0, &tracker);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_tracker_update_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_tracker_h tracker;
+	location_coords_s destination;
+	double distance = -1;
+	bool off_route = true;
+
+	ret = route_tracker_create(g_route, 50, &tracker);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_tracker_create() is failed");
+
+	route_get_destination(g_route, &destination);
+	ret = route_tracker_update(tracker, destination);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_tracker_update() is failed");
+
+	route_tracker_get_remaining_distance(tracker, &distance);
+	route_tracker_is_off_route(tracker, &off_route);
+	route_tracker_destroy(tracker);
+
+	dts_message(__func__, "%f remaining at the destination", distance);
+	validate_eq(__func__, off_route, false);
+}
+
+static void utc_location_route_tracker_update_p_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_tracker_h tracker;
+	location_coords_s far_away = { 35.179554, 129.075642 };
+	bool off_route = false;
+
+	ret = route_tracker_create(g_route, 50, &tracker);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_tracker_create() is failed");
+
+	ret = route_tracker_update(tracker, far_away);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_tracker_update() is failed");
+
+	route_tracker_is_off_route(tracker, &off_route);
+	route_tracker_destroy(tracker);
+	validate_eq(__func__, off_route, true);
+}
+
+static void utc_location_route_tracker_update_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	location_coords_s coords = { 37.560000, 126.980000 };
+
+	ret = route_tracker_update(NULL, coords);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
 static void utc_location_route_segment_clone_p(void)
 {
 	int ret = ROUTE_ERROR_NONE;
@@ -1211,6 +2170,25 @@ static void utc_location_route_step_foreach_geometries_n_02(void)
 	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
 }
 
+static void utc_location_route_step_encode_polyline_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	char *encoded = NULL;
+
+	ret = route_step_encode_polyline(g_step, ROUTE_POLYLINE_PRECISION_6, &encoded);
+	free(encoded);
+	validate_eq(__func__, ret, ROUTE_ERROR_NONE);
+}
+
+static void utc_location_route_step_encode_polyline_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	char *encoded;
+
+	ret = route_step_encode_polyline(NULL, ROUTE_POLYLINE_PRECISION_6, &encoded);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
 static void utc_location_route_step_foreach_properties_p(void)
 {
 	int ret = ROUTE_ERROR_NONE;
@@ -0,0 +1,197 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <tet_api.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <route.h>
+#include <route_service.h>
+#include <glib.h>
+
+/*
+ * The walks of a route are checked to allocate nothing, by counting the heap allocations of the calling thread.
+ * The allocator is replaced for the whole process, so these tests are kept apart from the others in this binary.
+ */
+
+enum {
+	POSITIVE_TC_IDX = 0x01,
+	NEGATIVE_TC_IDX,
+};
+
+static void startup(void);
+static void cleanup(void);
+
+void (*tet_startup) (void) = startup;
+void (*tet_cleanup) (void) = cleanup;
+
+static void utc_location_route_allocation_foreach_segments_p(void);
+
+struct tet_testlist tet_testlist[] = {
+	{utc_location_route_allocation_foreach_segments_p, POSITIVE_TC_IDX},
+
+	{NULL, 0},
+};
+
+/* Heap allocations made by the calling thread while counting_allocations is set */
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+
+static __thread gboolean counting_allocations;
+static __thread int allocation_count;
+
+void *malloc(size_t size)
+{
+	if (counting_allocations) {
+		allocation_count++;
+	}
+	return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+	if (counting_allocations) {
+		allocation_count++;
+	}
+	return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	if (counting_allocations) {
+		allocation_count++;
+	}
+	return __libc_realloc(ptr, size);
+}
+
+static GMainLoop *g_mainloop = NULL;
+static GThread *event_thread;
+
+gpointer GmainThread(gpointer data)
+{
+	g_mainloop = g_main_loop_new(NULL, 0);
+	g_main_loop_run(g_mainloop);
+
+	return NULL;
+}
+
+static void validate_and_next(char *api_name, int act_ret, int ext_ret, char *fail_msg)
+{
+	dts_message(api_name, "Actual Result : %d, Expected Result : %d", act_ret, ext_ret);
+	if (act_ret != ext_ret) {
+		dts_message(api_name, "Fail Message: %s", fail_msg);
+		dts_fail(api_name);
+	}
+}
+
+static void validate_eq(char *api_name, int act_ret, int ext_ret)
+{
+	dts_message(api_name, "Actual Result : %d, Expected Result : %d", act_ret, ext_ret);
+	if (act_ret == ext_ret) {
+		dts_pass(api_name);
+	} else {
+		dts_fail(api_name);
+	}
+}
+
+static route_service_h g_service;
+static route_h g_route;
+static bool route_found = FALSE;
+
+static bool route_service_found_callback(route_error_e error, int index, int total, route_h route, void *user_data)
+{
+	if (error == ROUTE_ERROR_NONE && index == 0) {
+		route_clone(&g_route, route);
+	}
+	route_found = TRUE;
+	return FALSE;
+}
+
+static void startup(void)
+{
+	int ret, request_id;
+	int timeout = 0;
+	location_coords_s origin = { 37.564263, 126.974676 };
+	location_coords_s destination = { 37.55712, 126.99241 };
+
+	g_setenv("PKG_NAME", "com.samsung.capi-location-route-allocation-test", 1);
+	g_setenv("LOCATION_TEST_ENABLE", "1", 1);
+
+#if !GLIB_CHECK_VERSION (2, 31, 0)
+	if (!g_thread_supported()) {
+		g_thread_init(NULL);
+	}
+#endif
+
+	event_thread = g_thread_create(GmainThread, NULL, 1, NULL);
+
+	ret = route_service_create(&g_service);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_create() is failed");
+	ret = route_service_find(g_service, origin, destination, NULL, 0, route_service_found_callback, NULL, &request_id);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_find() is failed");
+	for (timeout; timeout < 180 && !route_found; timeout++) {
+		sleep(1);
+	}
+}
+
+static void cleanup(void)
+{
+	if (g_service) {
+		route_service_destroy(g_service);
+	}
+	if (g_route) {
+		route_destroy(g_route);
+	}
+
+	g_main_loop_quit(g_mainloop);
+	g_thread_join(event_thread);
+}
+
+static bool capi_walk_geometry_cb(location_coords_s * geometry, void *user_data)
+{
+	(*(int *)user_data)++;
+	return TRUE;
+}
+
+static bool capi_walk_step_cb(route_step_h step, void *user_data)
+{
+	route_step_foreach_geometries(step, capi_walk_geometry_cb, user_data);
+	return TRUE;
+}
+
+static bool capi_walk_segment_cb(route_segment_h segment, void *user_data)
+{
+	route_segment_foreach_steps(segment, capi_walk_step_cb, user_data);
+	return TRUE;
+}
+
+static void utc_location_route_allocation_foreach_segments_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int point_count = 0;
+
+	validate_and_next(__func__, g_route != NULL, TRUE, "No route is found");
+
+	allocation_count = 0;
+	counting_allocations = TRUE;
+	ret = route_foreach_segments(g_route, capi_walk_segment_cb, &point_count);
+	counting_allocations = FALSE;
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_foreach_segments() is failed");
+
+	dts_message(__func__, "%d points walked", point_count);
+	validate_eq(__func__, allocation_count, 0);
+}
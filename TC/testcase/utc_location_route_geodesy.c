@@ -0,0 +1,229 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <tet_api.h>
+
+#include <route.h>
+#include <route_geodesy.h>
+#include <glib.h>
+#include <math.h>
+
+enum {
+	POSITIVE_TC_IDX = 0x01,
+	NEGATIVE_TC_IDX,
+};
+
+static void startup(void);
+static void cleanup(void);
+
+void (*tet_startup) (void) = startup;
+void (*tet_cleanup) (void) = cleanup;
+
+static void utc_location_route_geodesy_get_distance_p(void);
+static void utc_location_route_geodesy_get_distance_p_02(void);
+static void utc_location_route_geodesy_get_distance_n(void);
+static void utc_location_route_geodesy_get_distance_n_02(void);
+static void utc_location_route_geodesy_get_distances_p(void);
+static void utc_location_route_geodesy_get_distances_n(void);
+static void utc_location_route_geodesy_get_distances_n_02(void);
+static void utc_location_route_geodesy_get_coords_distances_p(void);
+static void utc_location_route_geodesy_get_coords_distances_n(void);
+
+struct tet_testlist tet_testlist[] = {
+	{utc_location_route_geodesy_get_distance_p, POSITIVE_TC_IDX},
+	{utc_location_route_geodesy_get_distance_p_02, POSITIVE_TC_IDX},
+	{utc_location_route_geodesy_get_distance_n, NEGATIVE_TC_IDX},
+	{utc_location_route_geodesy_get_distance_n_02, NEGATIVE_TC_IDX},
+	{utc_location_route_geodesy_get_distances_p, POSITIVE_TC_IDX},
+	{utc_location_route_geodesy_get_distances_n, NEGATIVE_TC_IDX},
+	{utc_location_route_geodesy_get_distances_n_02, NEGATIVE_TC_IDX},
+	{utc_location_route_geodesy_get_coords_distances_p, POSITIVE_TC_IDX},
+	{utc_location_route_geodesy_get_coords_distances_n, NEGATIVE_TC_IDX},
+	{NULL, 0},
+};
+
+#define GEODESY_POINT_COUNT 11
+
+static double g_latitudes[GEODESY_POINT_COUNT];
+static double g_longitudes[GEODESY_POINT_COUNT];
+
+static void startup(void)
+{
+	int i;
+
+	g_setenv("PKG_NAME", "com.samsung.capi-location-route-geodesy-test", 1);
+	g_setenv("LOCATION_TEST_ENABLE", "1", 1);
+
+	/* From 37.564263,126.974676 to 37.55712,126.99241 */
+	for (i = 0; i < GEODESY_POINT_COUNT; i++) {
+		g_latitudes[i] = 37.564263 + (37.55712 - 37.564263) * i / (GEODESY_POINT_COUNT - 1);
+		g_longitudes[i] = 126.974676 + (126.99241 - 126.974676) * i / (GEODESY_POINT_COUNT - 1);
+	}
+}
+
+static void cleanup(void)
+{
+}
+
+static void validate_eq(char *api_name, int act_ret, int ext_ret)
+{
+	dts_message(api_name, "Actual Result : %d, Expected Result : %d", act_ret, ext_ret);
+	if (act_ret == ext_ret) {
+		dts_pass(api_name);
+	} else {
+		dts_fail(api_name);
+	}
+}
+
+static void validate_and_next(char *api_name, int act_ret, int ext_ret, char *fail_msg)
+{
+	dts_message(api_name, "Actual Result : %d, Expected Result : %d", act_ret, ext_ret);
+	if (act_ret != ext_ret) {
+		dts_message(api_name, "Fail Message: %s", fail_msg);
+		dts_fail(api_name);
+	}
+}
+
+static void utc_location_route_geodesy_get_distance_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	location_coords_s from = { -37.95103341, 144.42486789 };
+	location_coords_s to = { -37.65282114, 143.92649554 };
+	double distance = 0;
+
+	ret = route_geodesy_get_distance(from, to, ROUTE_GEODESY_METHOD_VINCENTY, &distance);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_geodesy_get_distance() is failed");
+	dts_message(__func__, "distance : %f", distance);
+	validate_eq(__func__, fabs(distance - 54972.271) < 0.01, TRUE);
+}
+
+static void utc_location_route_geodesy_get_distance_p_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	location_coords_s from = { g_latitudes[0], g_longitudes[0] };
+	location_coords_s to = { g_latitudes[1], g_longitudes[1] };
+	double haversine = 0;
+	double distance = 0;
+
+	ret = route_geodesy_get_distance(from, to, ROUTE_GEODESY_METHOD_HAVERSINE, &haversine);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_geodesy_get_distance() is failed");
+	ret = route_geodesy_get_distance(from, to, ROUTE_GEODESY_METHOD_AUTO, &distance);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_geodesy_get_distance() is failed");
+	dts_message(__func__, "haversine : %f, auto : %f", haversine, distance);
+	validate_eq(__func__, fabs(distance - haversine) < 0.01, TRUE);
+}
+
+static void utc_location_route_geodesy_get_distance_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	location_coords_s from = { g_latitudes[0], g_longitudes[0] };
+	location_coords_s to = { g_latitudes[1], g_longitudes[1] };
+
+	ret = route_geodesy_get_distance(from, to, ROUTE_GEODESY_METHOD_AUTO, NULL);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_geodesy_get_distance_n_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	location_coords_s from = { g_latitudes[0], g_longitudes[0] };
+	location_coords_s to = { g_latitudes[1], g_longitudes[1] };
+	double distance = 0;
+
+	ret = route_geodesy_get_distance(from, to, (route_geodesy_method_e) -1, &distance);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_geodesy_get_distances_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	double distances[GEODESY_POINT_COUNT - 1];
+	double expected = 0;
+	gboolean matched = TRUE;
+	int i;
+
+	ret = route_geodesy_get_distances(g_latitudes, g_longitudes, g_latitudes + 1, g_longitudes + 1, GEODESY_POINT_COUNT - 1,
+					  ROUTE_GEODESY_METHOD_AUTO, distances);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_geodesy_get_distances() is failed");
+
+	for (i = 0; i < GEODESY_POINT_COUNT - 1; i++) {
+		location_coords_s from = { g_latitudes[i], g_longitudes[i] };
+		location_coords_s to = { g_latitudes[i + 1], g_longitudes[i + 1] };
+
+		route_geodesy_get_distance(from, to, ROUTE_GEODESY_METHOD_HAVERSINE, &expected);
+		matched = matched && fabs(distances[i] - expected) < 0.01;
+	}
+	validate_eq(__func__, matched, TRUE);
+}
+
+static void utc_location_route_geodesy_get_distances_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	double distances[GEODESY_POINT_COUNT - 1];
+
+	ret = route_geodesy_get_distances(NULL, g_longitudes, g_latitudes + 1, g_longitudes + 1, GEODESY_POINT_COUNT - 1,
+					  ROUTE_GEODESY_METHOD_AUTO, distances);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_geodesy_get_distances_n_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	double distances[GEODESY_POINT_COUNT - 1];
+
+	ret = route_geodesy_get_distances(g_latitudes, g_longitudes, g_latitudes + 1, g_longitudes + 1, -1,
+					  ROUTE_GEODESY_METHOD_AUTO, distances);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_geodesy_get_coords_distances_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	location_coords_s from[GEODESY_POINT_COUNT - 1];
+	location_coords_s to[GEODESY_POINT_COUNT - 1];
+	double distances[GEODESY_POINT_COUNT - 1];
+	double expected[GEODESY_POINT_COUNT - 1];
+	gboolean matched = TRUE;
+	int i;
+
+	for (i = 0; i < GEODESY_POINT_COUNT - 1; i++) {
+		from[i].latitude = g_latitudes[i];
+		from[i].longitude = g_longitudes[i];
+		to[i].latitude = g_latitudes[i + 1];
+		to[i].longitude = g_longitudes[i + 1];
+	}
+
+	ret = route_geodesy_get_coords_distances(from, to, GEODESY_POINT_COUNT - 1, ROUTE_GEODESY_METHOD_EQUIRECTANGULAR, distances);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_geodesy_get_coords_distances() is failed");
+	ret = route_geodesy_get_distances(g_latitudes, g_longitudes, g_latitudes + 1, g_longitudes + 1, GEODESY_POINT_COUNT - 1,
+					  ROUTE_GEODESY_METHOD_EQUIRECTANGULAR, expected);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_geodesy_get_distances() is failed");
+
+	for (i = 0; i < GEODESY_POINT_COUNT - 1; i++) {
+		matched = matched && distances[i] == expected[i];
+	}
+	validate_eq(__func__, matched, TRUE);
+}
+
+static void utc_location_route_geodesy_get_coords_distances_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	location_coords_s from = { g_latitudes[0], g_longitudes[0] };
+	double distance = 0;
+
+	ret = route_geodesy_get_coords_distances(&from, NULL, 1, ROUTE_GEODESY_METHOD_AUTO, &distance);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
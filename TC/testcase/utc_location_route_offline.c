@@ -0,0 +1,300 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <tet_api.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+
+#include <route.h>
+#include <route_service.h>
+#include <route_preference.h>
+#include <glib.h>
+
+/*
+ * The road graphs are built from route_graph_fixture.osm, a 5 x 5 grid of streets about 110 m apart,
+ * by the route_graph_build and route_graph_contract tools of tools/, which have to be in the PATH.
+ */
+#define ROUTE_GRAPH_FIXTURE	"route_graph_fixture.osm"
+#define ROUTE_GRAPH_PATH	"/tmp/route_graph_fixture.bin"
+#define ROUTE_GRAPH_CH_PATH	"/tmp/route_graph_fixture_ch.bin"
+#define ROUTE_GRAPH_TRUNCATED_PATH	"/tmp/route_graph_fixture_truncated.bin"
+
+enum {
+	POSITIVE_TC_IDX = 0x01,
+	NEGATIVE_TC_IDX,
+};
+
+static void startup(void);
+static void cleanup(void);
+
+void (*tet_startup) (void) = startup;
+void (*tet_cleanup) (void) = cleanup;
+
+static void utc_location_route_offline_create_p(void);
+static void utc_location_route_offline_create_n(void);
+static void utc_location_route_offline_find_p(void);
+static void utc_location_route_offline_find_p_02(void);
+static void utc_location_route_offline_find_n(void);
+static void utc_location_route_offline_find_isochrone_p(void);
+static void utc_location_route_offline_find_isochrone_n(void);
+static void utc_location_route_offline_destroy_p(void);
+
+struct tet_testlist tet_testlist[] = {
+	{utc_location_route_offline_create_p, POSITIVE_TC_IDX},
+	{utc_location_route_offline_create_n, NEGATIVE_TC_IDX},
+	{utc_location_route_offline_find_p, POSITIVE_TC_IDX},
+	{utc_location_route_offline_find_p_02, POSITIVE_TC_IDX},
+	{utc_location_route_offline_find_n, NEGATIVE_TC_IDX},
+	{utc_location_route_offline_find_isochrone_p, POSITIVE_TC_IDX},
+	{utc_location_route_offline_find_isochrone_n, NEGATIVE_TC_IDX},
+	{utc_location_route_offline_destroy_p, POSITIVE_TC_IDX},
+
+	{NULL, 0},
+};
+
+static GMainLoop *g_mainloop = NULL;
+static GThread *event_thread;
+
+gpointer GmainThread(gpointer data)
+{
+	g_mainloop = g_main_loop_new(NULL, 0);
+	g_main_loop_run(g_mainloop);
+
+	return NULL;
+}
+
+static void validate_and_next(char *api_name, int act_ret, int ext_ret, char *fail_msg)
+{
+	dts_message(api_name, "Actual Result : %d, Expected Result : %d", act_ret, ext_ret);
+	if (act_ret != ext_ret) {
+		dts_message(api_name, "Fail Message: %s", fail_msg);
+		dts_fail(api_name);
+	}
+}
+
+static void validate_eq(char *api_name, int act_ret, int ext_ret)
+{
+	dts_message(api_name, "Actual Result : %d, Expected Result : %d", act_ret, ext_ret);
+	if (act_ret == ext_ret) {
+		dts_pass(api_name);
+	} else {
+		dts_fail(api_name);
+	}
+}
+
+static void startup(void)
+{
+	g_setenv("PKG_NAME", "com.samsung.capi-location-route-offline-test", 1);
+
+#if !GLIB_CHECK_VERSION (2, 31, 0)
+	if (!g_thread_supported()) {
+		g_thread_init(NULL);
+	}
+#endif
+	event_thread = g_thread_create(GmainThread, NULL, 1, NULL);
+
+	system("route_graph_build " ROUTE_GRAPH_FIXTURE " " ROUTE_GRAPH_PATH);
+	system("route_graph_contract " ROUTE_GRAPH_PATH " " ROUTE_GRAPH_CH_PATH);
+}
+
+static void cleanup(void)
+{
+	unlink(ROUTE_GRAPH_PATH);
+	unlink(ROUTE_GRAPH_CH_PATH);
+	unlink(ROUTE_GRAPH_TRUNCATED_PATH);
+
+	g_main_loop_quit(g_mainloop);
+	g_thread_join(event_thread);
+}
+
+static route_service_h g_service;
+
+typedef struct {
+	bool found;
+	double distance;
+	long duration;
+} capi_route_offline_result_s;
+
+/* Corners of the grid */
+static location_coords_s g_origin = { 37.5600, 126.9700 };
+static location_coords_s g_destination = { 37.5640, 126.9750 };
+
+static capi_route_offline_result_s g_astar_result;
+
+static bool capi_route_offline_found_cb(route_error_e error, int index, int total, route_h route, void *user_data)
+{
+	capi_route_offline_result_s *result = (capi_route_offline_result_s *) user_data;
+
+	if (error == ROUTE_ERROR_NONE && index == 0) {
+		route_get_total_distance(route, &result->distance);
+		route_get_total_duration(route, &result->duration);
+	}
+	result->found = TRUE;
+	return FALSE;
+}
+
+static int find_and_wait(route_service_h service, capi_route_offline_result_s *result)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int timeout = 0;
+	int request_id;
+
+	memset(result, 0, sizeof(capi_route_offline_result_s));
+	ret = route_service_find(service, g_origin, g_destination, NULL, 0, capi_route_offline_found_cb, result,
+				 &request_id);
+	for (timeout; ret == ROUTE_ERROR_NONE && timeout < 180 && !result->found; timeout++) {
+		sleep(1);
+	}
+	return ret;
+}
+
+static void utc_location_route_offline_create_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+
+	ret = route_service_create_offline(&g_service, ROUTE_GRAPH_PATH);
+	validate_eq(__func__, ret, ROUTE_ERROR_NONE);
+}
+
+static void utc_location_route_offline_create_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_service_h service = NULL;
+	gchar *contents = NULL;
+	gsize length = 0;
+
+	/* A graph file cut in the middle of its sections */
+	g_file_get_contents(ROUTE_GRAPH_PATH, &contents, &length, NULL);
+	validate_and_next(__func__, length > 0, TRUE, "The road graph is not built");
+	g_file_set_contents(ROUTE_GRAPH_TRUNCATED_PATH, contents, length / 2, NULL);
+	g_free(contents);
+
+	ret = route_service_create_offline(&service, ROUTE_GRAPH_TRUNCATED_PATH);
+	validate_eq(__func__, ret, ROUTE_ERROR_SERVICE_NOT_AVAILABLE);
+}
+
+static void utc_location_route_offline_find_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+
+	ret = find_and_wait(g_service, &g_astar_result);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_find() is failed");
+	validate_and_next(__func__, g_astar_result.found, TRUE, "No route is found");
+	validate_eq(__func__, g_astar_result.distance > 0 && g_astar_result.duration > 0, TRUE);
+}
+
+static void utc_location_route_offline_find_p_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_service_h service = NULL;
+	capi_route_offline_result_s result;
+
+	/* The contraction hierarchy finds the same route as the plain search */
+	ret = route_service_create_offline(&service, ROUTE_GRAPH_CH_PATH);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_create_offline() is failed");
+	ret = find_and_wait(service, &result);
+	route_service_destroy(service);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_find() is failed");
+	validate_and_next(__func__, result.found && result.distance > 0, TRUE, "No route is found");
+	validate_and_next(__func__, fabs(result.distance - g_astar_result.distance) < 0.01, TRUE, "The distances differ");
+	validate_eq(__func__, result.duration, g_astar_result.duration);
+}
+
+static void utc_location_route_offline_find_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int request_id;
+	route_service_h service = NULL;
+	route_preference_h preference = NULL;
+
+	/* The road graph is only built for cars */
+	ret = route_service_create_offline(&service, ROUTE_GRAPH_PATH);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_create_offline() is failed");
+	route_preference_create(&preference);
+	route_preference_set_transport_mode(preference, "PEDESTRIAN");
+	route_service_set_preference(service, preference);
+
+	ret = route_service_find(service, g_origin, g_destination, NULL, 0, capi_route_offline_found_cb, &g_astar_result,
+				 &request_id);
+	route_service_destroy(service);
+	validate_eq(__func__, ret, ROUTE_ERROR_SERVICE_NOT_SUPPORTED);
+}
+
+static bool isochrone_found = FALSE;
+static bool isochrone_origin_reached = FALSE;
+static bool isochrone_corners_reached = FALSE;
+
+/* Crossing of the primary road and the middle street */
+static location_coords_s g_isochrone_origin = { 37.5620, 126.9725 };
+
+static void capi_route_offline_isochrone_found_cb(route_error_e error, location_coords_s south_west,
+						  location_coords_s north_east, int rows, int columns, const long *durations,
+						  void *user_data)
+{
+	int row, column;
+
+	if (error == ROUTE_ERROR_NONE && rows > 0 && columns > 0) {
+		row = (int)((g_isochrone_origin.latitude - south_west.latitude) * rows
+			    / (north_east.latitude - south_west.latitude));
+		column = (int)((g_isochrone_origin.longitude - south_west.longitude) * columns
+			       / (north_east.longitude - south_west.longitude));
+		row = CLAMP(row, 0, rows - 1);
+		column = CLAMP(column, 0, columns - 1);
+		isochrone_origin_reached = durations[row * columns + column] >= 0;
+		/* Along a grid of streets the reachable area is a diamond, so the corners of its bounds are out of reach */
+		isochrone_corners_reached = durations[0] >= 0 || durations[columns - 1] >= 0
+		    || durations[(rows - 1) * columns] >= 0 || durations[rows * columns - 1] >= 0;
+	}
+	isochrone_found = TRUE;
+}
+
+static void utc_location_route_offline_find_isochrone_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int timeout = 0;
+	int request_id;
+
+	ret = route_service_find_isochrone(g_service, g_isochrone_origin, 20, 50, capi_route_offline_isochrone_found_cb,
+					   NULL, &request_id);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_find_isochrone() is failed");
+
+	for (timeout; timeout < 180 && !isochrone_found; timeout++) {
+		sleep(1);
+	}
+	validate_and_next(__func__, isochrone_origin_reached, TRUE, "The origin is not reached");
+	validate_eq(__func__, isochrone_corners_reached, FALSE);
+}
+
+static void utc_location_route_offline_find_isochrone_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int request_id;
+
+	/* A day of driving in cells of a meter is far too large a grid */
+	ret = route_service_find_isochrone(g_service, g_isochrone_origin, 86400, 1, capi_route_offline_isochrone_found_cb,
+					   NULL, &request_id);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_offline_destroy_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+
+	ret = route_service_destroy(g_service);
+	validate_eq(__func__, ret, ROUTE_ERROR_NONE);
+}
@@ -15,7 +15,9 @@
 */
 
 #include <tet_api.h>
+#include <string.h>
 
+#include <route.h>
 #include <route_service.h>
 #include <route_preference.h>
 #include <glib.h>
@@ -33,6 +35,9 @@ void (*tet_cleanup) (void) = cleanup;
 
 static void utc_location_route_service_create_p(void);
 static void utc_location_route_service_create_n(void);
+static void utc_location_route_service_create_offline_n(void);
+static void utc_location_route_service_create_offline_n_02(void);
+static void utc_location_route_service_create_offline_n_03(void);
 static void utc_location_route_service_get_preference_p(void);
 static void utc_location_route_service_get_preference_n(void);
 static void utc_location_route_service_get_preference_n_02(void);
@@ -42,14 +47,44 @@ static void utc_location_route_service_set_preference_n_02(void);
 static void utc_location_route_service_find_p(void);
 static void utc_location_route_service_find_n(void);
 static void utc_location_route_service_find_n_02(void);
+static void utc_location_route_service_find_p_02(void);
+static void utc_location_route_service_find_p_03(void);
+static void utc_location_route_service_find_batch_p(void);
+static void utc_location_route_service_find_batch_n(void);
+static void utc_location_route_service_find_batch_n_02(void);
+static void utc_location_route_service_find_matrix_p(void);
+static void utc_location_route_service_find_matrix_p_02(void);
+static void utc_location_route_service_find_matrix_n(void);
+static void utc_location_route_service_find_matrix_n_02(void);
+static void utc_location_route_service_find_matrix_n_03(void);
+static void utc_location_route_service_find_isochrone_n(void);
+static void utc_location_route_service_find_isochrone_n_02(void);
+static void utc_location_route_service_find_isochrone_n_03(void);
 static void utc_location_route_service_cancel_p(void);
 static void utc_location_route_service_cancel_n(void);
+static void utc_location_route_service_cancel_p_02(void);
+static void utc_location_route_service_set_cache_policy_p(void);
+static void utc_location_route_service_set_cache_policy_n(void);
+static void utc_location_route_service_set_cache_policy_n_02(void);
+static void utc_location_route_service_set_cache_policy_p_02(void);
+static void utc_location_route_service_set_alternative_filter_p(void);
+static void utc_location_route_service_set_alternative_filter_n(void);
+static void utc_location_route_service_set_alternative_filter_n_02(void);
+static void utc_location_route_service_clear_cache_p(void);
+static void utc_location_route_service_clear_cache_p_02(void);
+static void utc_location_route_service_clear_cache_n(void);
+static void utc_location_route_service_get_cache_statistics_p(void);
+static void utc_location_route_service_get_cache_statistics_n(void);
+static void utc_location_route_service_get_provider_request_count_n(void);
 static void utc_location_route_service_destroy_p(void);
 static void utc_location_route_service_destroy_n(void);
 
 struct tet_testlist tet_testlist[] = {
 	{utc_location_route_service_create_p, POSITIVE_TC_IDX},
 	{utc_location_route_service_create_n, NEGATIVE_TC_IDX},
+	{utc_location_route_service_create_offline_n, NEGATIVE_TC_IDX},
+	{utc_location_route_service_create_offline_n_02, NEGATIVE_TC_IDX},
+	{utc_location_route_service_create_offline_n_03, NEGATIVE_TC_IDX},
 	{utc_location_route_service_get_preference_p, POSITIVE_TC_IDX},
 	{utc_location_route_service_get_preference_n, NEGATIVE_TC_IDX},
 	{utc_location_route_service_get_preference_n_02, NEGATIVE_TC_IDX},
@@ -59,8 +94,35 @@ struct tet_testlist tet_testlist[] = {
 	{utc_location_route_service_find_p, POSITIVE_TC_IDX},
 	{utc_location_route_service_find_n, NEGATIVE_TC_IDX},
 	{utc_location_route_service_find_n_02, NEGATIVE_TC_IDX},
+	{utc_location_route_service_find_p_02, POSITIVE_TC_IDX},
+	{utc_location_route_service_find_p_03, POSITIVE_TC_IDX},
+	{utc_location_route_service_find_batch_p, POSITIVE_TC_IDX},
+	{utc_location_route_service_find_batch_n, NEGATIVE_TC_IDX},
+	{utc_location_route_service_find_batch_n_02, NEGATIVE_TC_IDX},
+	{utc_location_route_service_find_matrix_p, POSITIVE_TC_IDX},
+	{utc_location_route_service_find_matrix_p_02, POSITIVE_TC_IDX},
+	{utc_location_route_service_find_matrix_n, NEGATIVE_TC_IDX},
+	{utc_location_route_service_find_matrix_n_02, NEGATIVE_TC_IDX},
+	{utc_location_route_service_find_matrix_n_03, NEGATIVE_TC_IDX},
+	{utc_location_route_service_find_isochrone_n, NEGATIVE_TC_IDX},
+	{utc_location_route_service_find_isochrone_n_02, NEGATIVE_TC_IDX},
+	{utc_location_route_service_find_isochrone_n_03, NEGATIVE_TC_IDX},
 	{utc_location_route_service_cancel_p, POSITIVE_TC_IDX},
 	{utc_location_route_service_cancel_n, NEGATIVE_TC_IDX},
+	{utc_location_route_service_cancel_p_02, POSITIVE_TC_IDX},
+	{utc_location_route_service_set_cache_policy_p, POSITIVE_TC_IDX},
+	{utc_location_route_service_set_cache_policy_n, NEGATIVE_TC_IDX},
+	{utc_location_route_service_set_cache_policy_n_02, NEGATIVE_TC_IDX},
+	{utc_location_route_service_set_cache_policy_p_02, POSITIVE_TC_IDX},
+	{utc_location_route_service_set_alternative_filter_p, POSITIVE_TC_IDX},
+	{utc_location_route_service_set_alternative_filter_n, NEGATIVE_TC_IDX},
+	{utc_location_route_service_set_alternative_filter_n_02, NEGATIVE_TC_IDX},
+	{utc_location_route_service_clear_cache_p, POSITIVE_TC_IDX},
+	{utc_location_route_service_clear_cache_p_02, POSITIVE_TC_IDX},
+	{utc_location_route_service_clear_cache_n, NEGATIVE_TC_IDX},
+	{utc_location_route_service_get_cache_statistics_p, POSITIVE_TC_IDX},
+	{utc_location_route_service_get_cache_statistics_n, NEGATIVE_TC_IDX},
+	{utc_location_route_service_get_provider_request_count_n, NEGATIVE_TC_IDX},
 	{utc_location_route_service_destroy_p, POSITIVE_TC_IDX},
 	{utc_location_route_service_destroy_n, NEGATIVE_TC_IDX},
 
@@ -150,6 +212,32 @@ static void utc_location_route_service_create_n(void)
 	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
 }
 
+static void utc_location_route_service_create_offline_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+
+	ret = route_service_create_offline(NULL, "/tmp/route_graph.bin");
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_service_create_offline_n_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_service_h service = NULL;
+
+	ret = route_service_create_offline(&service, NULL);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_service_create_offline_n_03(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	route_service_h service = NULL;
+
+	ret = route_service_create_offline(&service, "/nonexistent/route_graph.bin");
+	validate_eq(__func__, ret, ROUTE_ERROR_SERVICE_NOT_AVAILABLE);
+}
+
 static void utc_location_route_service_get_preference_p(void)
 {
 	int ret = ROUTE_ERROR_NONE;
@@ -261,6 +349,345 @@ static void utc_location_route_service_find_n_02(void)
 	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
 }
 
+/* What a find delivered: the number of routes, and the total distance of the first one */
+typedef struct {
+	bool found;
+	int total;
+	double distance;
+} capi_route_service_result_s;
+
+static bool capi_route_service_result_cb(route_error_e error, int index, int total, route_h route, void *user_data)
+{
+	capi_route_service_result_s *result = (capi_route_service_result_s *) user_data;
+
+	if (error != ROUTE_ERROR_NONE) {
+		result->found = TRUE;
+		return FALSE;
+	}
+	if (index == 0) {
+		route_get_total_distance(route, &result->distance);
+	}
+	result->total = total;
+	if (index == total - 1) {
+		result->found = TRUE;
+	}
+	return TRUE;
+}
+
+static void wait_for_result(capi_route_service_result_s *result)
+{
+	int timeout = 0;
+
+	for (timeout; timeout < 180 && !result->found; timeout++) {
+		sleep(1);
+	}
+}
+
+static int find_and_wait(capi_route_service_result_s *result)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int request_id;
+	location_coords_s origin = { 37.564263, 126.974676 };
+	location_coords_s destination = { 37.557120, 126.992410 };
+
+	memset(result, 0, sizeof(capi_route_service_result_s));
+	ret = route_service_find(g_service, origin, destination, NULL, 0, capi_route_service_result_cb, result, &request_id);
+	if (ret == ROUTE_ERROR_NONE) {
+		wait_for_result(result);
+	}
+	return ret;
+}
+
+/* Two identical finds issued back to back, the second one waiting for the request of the first */
+static int find_twice(capi_route_service_result_s *first, capi_route_service_result_s *second, int *first_request_id)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int request_id;
+	location_coords_s origin = { 37.564263, 126.974676 };
+	location_coords_s destination = { 37.557120, 126.992410 };
+
+	memset(first, 0, sizeof(capi_route_service_result_s));
+	memset(second, 0, sizeof(capi_route_service_result_s));
+	route_service_clear_cache(g_service);
+	ret = route_service_find(g_service, origin, destination, NULL, 0, capi_route_service_result_cb, first, first_request_id);
+	if (ret != ROUTE_ERROR_NONE) {
+		return ret;
+	}
+	return route_service_find(g_service, origin, destination, NULL, 0, capi_route_service_result_cb, second, &request_id);
+}
+
+static void validate_same_result(char *api_name, const capi_route_service_result_s *first,
+				 const capi_route_service_result_s *second)
+{
+	validate_and_next(api_name, first->found && second->found, TRUE, "No route was delivered");
+	validate_and_next(api_name, first->total > 0, TRUE, "No route was found");
+	validate_and_next(api_name, second->total, first->total, "The route counts differ");
+	validate_eq(api_name, second->distance == first->distance, TRUE);
+}
+
+/* Checks how many finds were answered from the cache or missed it since @hits and @misses were got */
+static void validate_cache_counts(char *api_name, int hits, int misses, int new_hits, int new_misses)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int current_hits = 0;
+	int current_misses = 0;
+
+	ret = route_service_get_cache_statistics(g_service, &current_hits, &current_misses);
+	validate_and_next(api_name, ret, ROUTE_ERROR_NONE, "route_service_get_cache_statistics() is failed");
+	validate_and_next(api_name, current_hits - hits, new_hits, "Unexpected cache hits");
+	validate_and_next(api_name, current_misses - misses, new_misses, "Unexpected cache misses");
+}
+
+static void utc_location_route_service_find_p_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int hits = 0;
+	int misses = 0;
+	capi_route_service_result_s first;
+	capi_route_service_result_s second;
+
+	ret = route_service_set_cache_policy(g_service, 60, 1024 * 1024);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_set_cache_policy() is failed");
+	route_service_clear_cache(g_service);
+	route_service_get_cache_statistics(g_service, &hits, &misses);
+
+	ret = find_and_wait(&first);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_find() is failed");
+	validate_cache_counts(__func__, hits, misses, 0, 1);
+
+	/* The same find again is answered from the cache */
+	ret = find_and_wait(&second);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_find() is failed");
+	validate_cache_counts(__func__, hits, misses, 1, 1);
+	validate_same_result(__func__, &first, &second);
+}
+
+static void utc_location_route_service_find_p_03(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int request_id;
+	int count = 0;
+	int new_count = 0;
+	capi_route_service_result_s first;
+	capi_route_service_result_s second;
+
+	ret = route_service_get_provider_request_count(g_service, &count);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_get_provider_request_count() is failed");
+	ret = find_twice(&first, &second, &request_id);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_find() is failed");
+
+	wait_for_result(&first);
+	wait_for_result(&second);
+
+	/* Both finds are answered by a single provider request */
+	route_service_get_provider_request_count(g_service, &new_count);
+	validate_and_next(__func__, new_count - count, 1, "The finds were not coalesced");
+	validate_same_result(__func__, &first, &second);
+}
+
+static bool batch_completed = FALSE;
+
+static bool capi_route_service_batch_found_cb(route_error_e error, int item_index, int index, int total, route_h route,
+					      void *user_data)
+{
+	return TRUE;
+}
+
+static void capi_route_service_batch_completed_cb(int batch_id, int failed_count, void *user_data)
+{
+	batch_completed = TRUE;
+}
+
+static void utc_location_route_service_find_batch_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int timeout = 0;
+	int batch_id;
+	route_service_batch_item_s items[2] = {
+		{{37.564263, 126.974676}, {37.557120, 126.992410}, NULL, 0},
+		{{37.557120, 126.992410}, {37.564263, 126.974676}, NULL, 0},
+	};
+
+	ret = route_service_find_batch(g_service, items, 2, 1, capi_route_service_batch_found_cb,
+				       capi_route_service_batch_completed_cb, NULL, &batch_id);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_find_batch() is failed");
+
+	for (timeout; timeout < 180 && !batch_completed; timeout++) {
+		sleep(1);
+	}
+	validate_eq(__func__, batch_completed, TRUE);
+}
+
+static void utc_location_route_service_find_batch_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int batch_id;
+	route_service_batch_item_s items[1] = {
+		{{37.564263, 126.974676}, {37.557120, 126.992410}, NULL, 0},
+	};
+
+	ret = route_service_find_batch(NULL, items, 1, 1, capi_route_service_batch_found_cb, NULL, NULL, &batch_id);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_service_find_batch_n_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int batch_id;
+	route_service_batch_item_s items[1] = {
+		{{37.564263, 126.974676}, {37.557120, 126.992410}, NULL, 0},
+	};
+
+	ret = route_service_find_batch(g_service, items, 1, 0, capi_route_service_batch_found_cb, NULL, NULL, &batch_id);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static bool matrix_found = FALSE;
+
+static void capi_route_service_matrix_found_cb(route_error_e error, int origin_count, int destination_count,
+					       const double *distances, const long *durations, void *user_data)
+{
+	int i, j;
+	int cell;
+
+	if (error != ROUTE_ERROR_NONE) {
+		return;
+	}
+
+	/* The diagonal is free, every other pair is a real route */
+	for (i = 0; i < origin_count; i++) {
+		for (j = 0; j < destination_count; j++) {
+			cell = i * destination_count + j;
+			if (i == j && (distances[cell] != 0 || durations[cell] != 0)) {
+				return;
+			}
+			if (i != j && (distances[cell] <= 0 || durations[cell] <= 0)) {
+				return;
+			}
+		}
+	}
+
+	/* A symmetric matrix finds each pair once, so both directions are the same route */
+	for (i = 0; i < origin_count; i++) {
+		for (j = i + 1; j < destination_count; j++) {
+			if (distances[i * destination_count + j] != distances[j * destination_count + i]
+			    || durations[i * destination_count + j] != durations[j * destination_count + i]) {
+				return;
+			}
+		}
+	}
+
+	matrix_found = TRUE;
+}
+
+static void utc_location_route_service_find_matrix_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int timeout = 0;
+	int request_id;
+	location_coords_s points[2] = { {37.564263, 126.974676}, {37.557120, 126.992410} };
+
+	ret = route_service_find_matrix(g_service, points, 2, points, 2, TRUE, 2, capi_route_service_matrix_found_cb, NULL,
+					&request_id);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_find_matrix() is failed");
+
+	for (timeout; timeout < 180 && !matrix_found; timeout++) {
+		sleep(1);
+	}
+	validate_eq(__func__, matrix_found, TRUE);
+}
+
+static void utc_location_route_service_find_matrix_p_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int request_id;
+	location_coords_s points[1] = { {37.564263, 126.974676} };
+
+	/* A matrix with nothing to find is still a request which can be cancelled */
+	matrix_found = FALSE;
+	ret = route_service_find_matrix(g_service, points, 1, points, 1, TRUE, 2, capi_route_service_matrix_found_cb, NULL,
+					&request_id);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_find_matrix() is failed");
+
+	ret = route_service_cancel(g_service, request_id);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_cancel() is failed");
+
+	sleep(1);
+	validate_eq(__func__, matrix_found, FALSE);
+}
+
+static void utc_location_route_service_find_matrix_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int request_id;
+	location_coords_s points[2] = { {37.564263, 126.974676}, {37.557120, 126.992410} };
+
+	ret = route_service_find_matrix(NULL, points, 2, points, 2, TRUE, 2, capi_route_service_matrix_found_cb, NULL,
+					&request_id);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_service_find_matrix_n_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int request_id;
+	location_coords_s points[2] = { {37.564263, 126.974676}, {37.557120, 126.992410} };
+
+	ret = route_service_find_matrix(g_service, points, 0, points, 2, TRUE, 2, capi_route_service_matrix_found_cb, NULL,
+					&request_id);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_service_find_matrix_n_03(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int request_id;
+	location_coords_s points[2] = { {37.564263, 126.974676}, {37.557120, 126.992410} };
+
+	/* More cells than can be counted, rejected before the points are read */
+	ret = route_service_find_matrix(g_service, points, 65536, points, 65536, TRUE, 2,
+					capi_route_service_matrix_found_cb, NULL, &request_id);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void capi_route_service_isochrone_found_cb(route_error_e error, location_coords_s south_west,
+						 location_coords_s north_east, int rows, int columns, const long *durations,
+						 void *user_data)
+{
+}
+
+static void utc_location_route_service_find_isochrone_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int request_id;
+	location_coords_s origin = {37.564263, 126.974676};
+
+	ret = route_service_find_isochrone(NULL, origin, 600, 100, capi_route_service_isochrone_found_cb, NULL, &request_id);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_service_find_isochrone_n_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int request_id;
+	location_coords_s origin = {37.564263, 126.974676};
+
+	ret = route_service_find_isochrone(g_service, origin, 0, 100, capi_route_service_isochrone_found_cb, NULL,
+					   &request_id);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_service_find_isochrone_n_03(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int request_id;
+	location_coords_s origin = {37.564263, 126.974676};
+
+	ret = route_service_find_isochrone(g_service, origin, 600, 100, capi_route_service_isochrone_found_cb, NULL,
+					   &request_id);
+	validate_eq(__func__, ret, ROUTE_ERROR_SERVICE_NOT_SUPPORTED);
+}
+
 static void utc_location_route_service_cancel_p(void)
 {
 	int ret = ROUTE_ERROR_NONE;
@@ -278,6 +705,166 @@ static void utc_location_route_service_cancel_n(void)
 
 }
 
+static void utc_location_route_service_cancel_p_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int request_id;
+	capi_route_service_result_s first;
+	capi_route_service_result_s second;
+
+	ret = find_twice(&first, &second, &request_id);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_find() is failed");
+
+	/* The request shared with the second find goes on without the first */
+	ret = route_service_cancel(g_service, request_id);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_cancel() is failed");
+
+	wait_for_result(&second);
+	validate_and_next(__func__, second.found && second.total > 0, TRUE, "The remaining find got no route");
+	validate_eq(__func__, first.found, FALSE);
+}
+
+static void utc_location_route_service_set_cache_policy_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+
+	ret = route_service_set_cache_policy(g_service, 60, 1024 * 1024);
+	validate_eq(__func__, ret, ROUTE_ERROR_NONE);
+}
+
+static void utc_location_route_service_set_cache_policy_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+
+	ret = route_service_set_cache_policy(NULL, 60, 1024 * 1024);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_service_set_cache_policy_n_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+
+	ret = route_service_set_cache_policy(g_service, -1, 1024 * 1024);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_service_set_cache_policy_p_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	capi_route_service_result_s first;
+	capi_route_service_result_s second;
+
+	int hits = 0;
+	int misses = 0;
+
+	/* Without room for any route, every find goes to the provider and the cache is not even looked up */
+	ret = route_service_set_cache_policy(g_service, 60, 0);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_set_cache_policy() is failed");
+	route_service_get_cache_statistics(g_service, &hits, &misses);
+
+	ret = find_and_wait(&first);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_find() is failed");
+	ret = find_and_wait(&second);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_find() is failed");
+
+	route_service_set_cache_policy(g_service, 60, 1024 * 1024);
+	validate_cache_counts(__func__, hits, misses, 0, 0);
+	validate_same_result(__func__, &first, &second);
+}
+
+static void utc_location_route_service_set_alternative_filter_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+
+	ret = route_service_set_alternative_filter(g_service, 0.8);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_set_alternative_filter() is failed");
+
+	ret = route_service_set_alternative_filter(g_service, 1);
+	validate_eq(__func__, ret, ROUTE_ERROR_NONE);
+}
+
+static void utc_location_route_service_set_alternative_filter_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+
+	ret = route_service_set_alternative_filter(NULL, 0.8);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_service_set_alternative_filter_n_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+
+	ret = route_service_set_alternative_filter(g_service, 1.5);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_service_clear_cache_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+
+	ret = route_service_clear_cache(g_service);
+	validate_eq(__func__, ret, ROUTE_ERROR_NONE);
+}
+
+static void utc_location_route_service_clear_cache_p_02(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	capi_route_service_result_s first;
+	capi_route_service_result_s second;
+
+	int hits = 0;
+	int misses = 0;
+
+	ret = find_and_wait(&first);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_find() is failed");
+
+	/* The route is asked to the provider again once the cache is cleared */
+	ret = route_service_clear_cache(g_service);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_clear_cache() is failed");
+	route_service_get_cache_statistics(g_service, &hits, &misses);
+	ret = find_and_wait(&second);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_find() is failed");
+	validate_cache_counts(__func__, hits, misses, 0, 1);
+	validate_same_result(__func__, &first, &second);
+}
+
+static void utc_location_route_service_clear_cache_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+
+	ret = route_service_clear_cache(NULL);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_service_get_cache_statistics_p(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int hits = -1;
+	int misses = -1;
+
+	ret = route_service_get_cache_statistics(g_service, &hits, &misses);
+	validate_and_next(__func__, ret, ROUTE_ERROR_NONE, "route_service_get_cache_statistics() is failed");
+	validate_eq(__func__, hits >= 0 && misses >= 0, TRUE);
+}
+
+static void utc_location_route_service_get_cache_statistics_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+	int hits;
+
+	ret = route_service_get_cache_statistics(g_service, &hits, NULL);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
+static void utc_location_route_service_get_provider_request_count_n(void)
+{
+	int ret = ROUTE_ERROR_NONE;
+
+	ret = route_service_get_provider_request_count(g_service, NULL);
+	validate_eq(__func__, ret, ROUTE_ERROR_INVALID_PARAMETER);
+}
+
 static void utc_location_route_service_destroy_p(void)
 {
 	int ret = ROUTE_ERROR_NONE;
@@ -52,6 +52,18 @@ typedef bool(*route_property_cb)(const char *key, const char *value, void *user_
  */
 typedef bool(*route_segment_cb)(route_segment_h segment, void *user_data);
 
+/**
+ * @brief  Called for each step of a route inside the bounds given to route_foreach_steps_in_bounds().
+ * @remarks  @a step is valid only in this function.
+ * @param[in]  step  The step of route
+ * @param[in]  segment_index  The index of the segment holding the step
+ * @param[in]  step_index  The index of the step, in its segment
+ * @param[in]  user_data  The user data passed from foreach function
+ * @return  @c true to continue with the next iteration of the loop, \n @c false to break out of the loop
+ * @see	route_foreach_steps_in_bounds()
+ */
+typedef bool(*route_step_in_bounds_cb)(route_step_h step, int segment_index, int step_index, void *user_data);
+
 /**
  * @brief Enumerations of distance unit
  */
@@ -64,6 +76,24 @@ typedef enum
     ROUTE_DISTANCE_UNIT_MI = 4,  /**< Mile */
 } route_distance_unit_e;
 
+/**
+ * @brief Enumerations of geometry simplification method
+ */
+typedef enum
+{
+    ROUTE_SIMPLIFY_DOUGLAS_PEUCKER = 0,  /**< Keeps the points farther than the tolerance from the simplified line (Douglas-Peucker) */
+    ROUTE_SIMPLIFY_VISVALINGAM_WHYATT = 1,  /**< Removes the points of the smallest effective area first (Visvalingam-Whyatt) */
+} route_simplify_method_e;
+
+/**
+ * @brief Enumerations of encoded polyline precision
+ */
+typedef enum
+{
+    ROUTE_POLYLINE_PRECISION_5 = 5,  /**< Coordinates rounded to 1e-5 degree */
+    ROUTE_POLYLINE_PRECISION_6 = 6,  /**< Coordinates rounded to 1e-6 degree */
+} route_polyline_precision_e;
+
 /**
  * @}
  */
@@ -135,7 +165,8 @@ typedef bool(*route_step_property_cb)(const char *key, const char *value, void *
 
 /**
  * @brief  Clones the handle of route.
- * @remarks  The @a cloned_route must be released route_destroy() by you.
+ * @remarks  The @a cloned_route must be released route_destroy() by you. \n
+ * Routes are read-only, so @a origin is shared rather than copied: it is returned as @a cloned_route with one more reference, and freed when the last of them is destroyed. A route delivered to route_service_found_cb() is retained with route_retain().
  * @param[out]  cloned_route  A cloned route handle
  * @param[in]  origin  The original route handle
  * @return  0 on success, otherwise a negative error value.
@@ -148,6 +179,8 @@ int route_clone(route_h* cloned_route, route_h origin);
 
 /**
  * @brief  Destroys the handle of route.
+ * @remarks  The route is only freed when it has no other clone left, which can be destroyed from any thread. \n
+ * For a route delivered to route_service_found_cb(), this is the same as route_release().
  * @param[in]  route  The route handle
  * @return  0 on success, otherwise a negative error value.
  * @retval  #ROUTE_ERROR_NONE  Successful
@@ -156,6 +189,29 @@ int route_clone(route_h* cloned_route, route_h origin);
  */
 int route_destroy(route_h route);
 
+/**
+ * @brief  Keeps a route delivered to route_service_found_cb() valid after the callback returns.
+ * @remarks  The routes of one response share their memory, which is kept until the last of them is released with route_release(). \n
+ * Only the first route retained from a response costs a copy, and none if the response came from the route cache.
+ * @param[in]  route  The route handle passed to route_service_found_cb()
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter, or @a route was not delivered to route_service_found_cb()
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @see	route_release()
+ */
+int route_retain(route_h route);
+
+/**
+ * @brief  Releases a route retained with route_retain().
+ * @param[in]  route  The route handle
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter, or @a route was not delivered to route_service_found_cb()
+ * @see	route_retain()
+ */
+int route_release(route_h route);
+
 /**
  * @brief  Gets the request ID.
  * @param[in]  route  The route handle
@@ -257,6 +313,274 @@ int route_foreach_properties(route_h route, route_property_cb callback, void* us
  */
 int route_foreach_segments(route_h route, route_segment_cb callback, void* user_data);
 
+/**
+ * @brief Gets the geometry of the whole route as contiguous arrays of latitudes and longitudes.
+ * @remarks  The arrays are built on the first call and belong to @a route. They are valid until @a route is destroyed or released, and must not be freed. \n
+ * The points are those of the step geometries in order, or the start and end points of the steps and segments without geometry. A point shared by two consecutive steps is given once.
+ * @param[in]  route  The route handle
+ * @param[out]  latitudes  The latitudes of the points
+ * @param[out]  longitudes  The longitudes of the points
+ * @param[out]  count  The number of points
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_RESULT_NOT_FOUND  The route has no geometry
+ * @see  route_step_foreach_geometries()
+ */
+int route_get_polyline(route_h route, const double** latitudes, const double** longitudes, int* count);
+
+/**
+ * @brief Gets a simplified geometry of the whole route.
+ * @remarks  The @a latitudes and @a longitudes must be released with free() by you. \n
+ * With #ROUTE_SIMPLIFY_DOUGLAS_PEUCKER, no point of the route is farther than @a tolerance from the simplified line. With #ROUTE_SIMPLIFY_VISVALINGAM_WHYATT, points are removed while the triangle they form with their neighbours is smaller than the square of @a tolerance. \n
+ * The first and last points are always kept.
+ * @param[in]  route  The route handle
+ * @param[in]  tolerance  The tolerance in meters
+ * @param[in]  method  The simplification method
+ * @param[out]  latitudes  The latitudes of the points kept
+ * @param[out]  longitudes  The longitudes of the points kept
+ * @param[out]  count  The number of points kept
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_RESULT_NOT_FOUND  The route has no geometry
+ * @see  route_get_polyline()
+ */
+int route_simplify_geometry(route_h route, double tolerance, route_simplify_method_e method, double** latitudes, double** longitudes, int* count);
+
+/**
+ * @brief Gets the geometry of the whole route as an encoded polyline string.
+ * @remarks  The @a encoded must be released with free() by you. \n
+ * The string uses the encoded polyline algorithm format, with latitude first.
+ * @param[in]  route  The route handle
+ * @param[in]  precision  The precision of the encoded coordinates
+ * @param[out]  encoded  The encoded polyline
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_RESULT_NOT_FOUND  The route has no geometry
+ * @see  route_step_encode_polyline()
+ * @see  route_decode_polyline()
+ */
+int route_encode_polyline(route_h route, route_polyline_precision_e precision, char** encoded);
+
+/**
+ * @brief Decodes an encoded polyline string into two arrays of coordinates.
+ * @remarks  The @a latitudes and @a longitudes must be released with free() by you.
+ * @param[in]  encoded  The encoded polyline
+ * @param[in]  precision  The precision the polyline was encoded with
+ * @param[out]  latitudes  The latitudes of the points
+ * @param[out]  longitudes  The longitudes of the points
+ * @param[out]  count  The number of points
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter, or @a encoded is malformed
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @see  route_encode_polyline()
+ */
+int route_decode_polyline(const char* encoded, route_polyline_precision_e precision, double** latitudes, double** longitudes, int* count);
+
+/**
+ * @brief Finds the position on the route nearest to the given coordinates.
+ * @remarks  The geometry of the route is indexed on the first call, so later calls do not walk the whole route. \n
+ * The @a step_index is -1 when the segment found has no steps.
+ * @param[in]  route  The route handle
+ * @param[in]  coords  The coordinates to snap on the route
+ * @param[out]  snapped  The nearest position on the route
+ * @param[out]  segment_index  The index of the segment holding the position
+ * @param[out]  step_index  The index of the step holding the position, in its segment
+ * @param[out]  offset  The distance from the origin to the position along the route, in meters
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_RESULT_NOT_FOUND  The route has no geometry
+ * @see  route_get_polyline()
+ */
+int route_find_nearest_position(route_h route, location_coords_s coords, location_coords_s* snapped, int* segment_index, int* step_index, double* offset);
+
+/**
+ * @brief Gets the distance from the origin of each point of the route geometry, along the route.
+ * @remarks  The @a distances are valid as long as the @a route is. Do not free them. \n
+ * The distances are in meters, one for each point given by route_get_polyline(), and never decrease.
+ * @param[in]  route  The route handle
+ * @param[out]  distances  The distances of the points
+ * @param[out]  count  The number of points
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_RESULT_NOT_FOUND  The route has no geometry
+ * @see  route_get_polyline()
+ * @see  route_get_position_at_distance()
+ */
+int route_get_polyline_distances(route_h route, const double** distances, int* count);
+
+/**
+ * @brief Gets the position at the given distance from the origin, along the route.
+ * @remarks  The @a step_index is -1 when the segment found has no steps.
+ * @param[in]  route  The route handle
+ * @param[in]  distance  The distance from the origin in meters, between 0 and the length of the route geometry
+ * @param[out]  position  The position
+ * @param[out]  segment_index  The index of the segment holding the position
+ * @param[out]  step_index  The index of the step holding the position, in its segment
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_RESULT_NOT_FOUND  The route has no geometry
+ * @see  route_get_polyline_distances()
+ * @see  route_find_nearest_position()
+ */
+int route_get_position_at_distance(route_h route, double distance, location_coords_s* position, int* segment_index, int* step_index);
+
+/**
+ * @brief Gets the predicted time elapsed from the origin at the given distance along the route.
+ * @remarks  The time is interpolated within the step holding the distance, from the duration of the step and its length along the route geometry. \n
+ * The timing of the steps is computed on the first call, so later calls do not walk the segments and steps.
+ * @param[in]  route  The route handle
+ * @param[in]  distance  The distance from the origin in meters, between 0 and the length of the route geometry
+ * @param[out]  elapsed  The elapsed time, in the unit of route_get_total_duration()
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_RESULT_NOT_FOUND  The route has no geometry
+ * @see  route_get_elapsed_time_at_position()
+ * @see  route_get_polyline_distances()
+ */
+int route_get_elapsed_time_at_distance(route_h route, double distance, long* elapsed);
+
+/**
+ * @brief Gets the predicted time elapsed from the origin at the position on the route nearest to the given coordinates.
+ * @remarks  The coordinates are snapped on the route as route_find_nearest_position() does.
+ * @param[in]  route  The route handle
+ * @param[in]  coords  The coordinates to snap on the route
+ * @param[out]  elapsed  The elapsed time, in the unit of route_get_total_duration()
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_RESULT_NOT_FOUND  The route has no geometry
+ * @see  route_get_elapsed_time_at_distance()
+ * @see  route_find_nearest_position()
+ */
+int route_get_elapsed_time_at_position(route_h route, location_coords_s coords, long* elapsed);
+
+/**
+ * @brief Gets how much two routes overlap.
+ * @remarks  The similarity is the share of the shorter route running along the other one, from 0 for disjoint routes to 1 when the shorter route lies entirely on the other. \n
+ * Roads less than about 30 meters apart are considered shared.
+ * @param[in]  route  The route handle
+ * @param[in]  other  The route handle to compare with
+ * @param[out]  similarity  The similarity, between 0 and 1
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_RESULT_NOT_FOUND  A route has no geometry
+ * @see  route_service_set_alternative_filter()
+ */
+int route_get_similarity(route_h route, route_h other, double* similarity);
+
+/**
+ * @brief Gets the steps of the route whose bounding box meets the given bounds.
+ * @remarks  The boxes of the steps are indexed on the first call, so later calls only visit the steps near the bounds. The steps come in route order. \n
+ * A step without bounding box gets the box of its geometry. The bounds cross the 180th meridian when the longitude of @a top_left is greater than the one of @a bottom_right.
+ * @param[in]  route  The route handle
+ * @param[in]  top_left  The top left position of the bounds
+ * @param[in]  bottom_right  The bottom right position of the bounds
+ * @param[in]  callback  The callback function to invoke
+ * @param[in]  user_data  The user data to be passed to the callback function
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @see  route_step_in_bounds_cb()
+ * @see  route_step_get_geometry_bounding_box()
+ */
+int route_foreach_steps_in_bounds(route_h route, location_coords_s top_left, location_coords_s bottom_right, route_step_in_bounds_cb callback, void* user_data);
+
+/**
+ * @brief Serializes the route into a buffer, to be stored or handed to another process.
+ * @remarks  The buffer holds the origin, destination, bounding box, totals, properties, segments and steps of the route, with their instructions and geometry, in a versioned binary layout. \n
+ * @a buffer must be released with free() by you.
+ * @param[in]  route  The route handle
+ * @param[out]  buffer  The serialized route
+ * @param[out]  length  The length of @a buffer, in bytes
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @see  route_deserialize()
+ */
+int route_serialize(route_h route, unsigned char** buffer, int* length);
+
+/**
+ * @brief Creates a route from a buffer given by route_serialize().
+ * @remarks  @a route must be released with route_destroy() by you.
+ * @param[in]  buffer  The serialized route
+ * @param[in]  length  The length of @a buffer, in bytes
+ * @param[out]  route  The route handle
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter, or @a buffer does not hold a whole route
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_SERVICE_NOT_SUPPORTED  @a buffer was written by a version of the layout this one does not read
+ * @see  route_serialize()
+ * @see  route_destroy()
+ */
+int route_deserialize(const unsigned char* buffer, int length, route_h* route);
+
+/**
+ * @brief Writes the route as GeoJSON into a buffer.
+ * @remarks  The route is a FeatureCollection of one feature per step, whose properties are the segment and step indexes, distance, duration, instruction and transport mode, followed by the properties of the step. The request id, total distance, duration and distance unit are members of the collection, and the properties of the route its "properties" member. \n
+ * At most @a size bytes are written, the text being cut and terminated with a null character when it is longer. @a length is the length of the whole text, so that a @a buffer too small can be given again with @a length + 1 bytes, or the length measured first with a NULL @a buffer and a @a size of 0.
+ * @param[in]  route  The route handle
+ * @param[out]  buffer  The buffer to write into, or NULL when @a size is 0
+ * @param[in]  size  The size of @a buffer, in bytes
+ * @param[out]  length  The length of the GeoJSON text, without the terminating null character
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  The text is longer than an int can tell
+ * @see  route_write_geojson_to_fd()
+ */
+int route_write_geojson(route_h route, char* buffer, int size, int* length);
+
+/**
+ * @brief Writes the route as GeoJSON into a file descriptor.
+ * @remarks  The text is the one of route_write_geojson(). It is written as it is made, in chunks of a few kilobytes, so that the memory it takes does not depend on the size of the route. \n
+ * @a fd is neither rewound nor closed.
+ * @param[in]  route  The route handle
+ * @param[in]  fd  The file descriptor to write into
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_SERVICE_NOT_AVAILABLE  Writing to @a fd failed
+ * @see  route_write_geojson()
+ */
+int route_write_geojson_to_fd(route_h route, int fd);
+
+/**
+ * @brief Clones the route into a compact one.
+ * @remarks  The @a compact_route must be released route_destroy() by you. \n
+ * Coordinates are kept to the millionth of a degree, about 11 cm, as the difference from the previous position of the route, and each distinct string once, so that the route takes about a tenth of the memory of @a origin. The getters read the compact route in place, and only the polyline, tracking and step lookups build tables of their own, on their first call. \n
+ * route_serialize() gives the compact form as it is, and route_deserialize() and route_store_append() take it.
+ * @param[out]  compact_route  A compact clone of the route
+ * @param[in]  origin  The original route handle
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @see  route_clone()
+ * @see  route_destroy()
+ */
+int route_clone_compact(route_h* compact_route, route_h origin);
+
 /**
  * @}
  */
@@ -268,7 +592,8 @@ int route_foreach_segments(route_h route, route_segment_cb callback, void* user_
 
 /**
  * @brief  Clones the handle of route segment.
- * @remarks  The @a cloned_segment must be released route_segment_destroy() by you.
+ * @remarks  The @a cloned_segment must be released route_segment_destroy() by you. \n
+ * The segment is not copied, the clone keeping the route it belongs to until it is destroyed.
  * @param[out]  cloned_segment  A cloned handle of route segment
  * @param[in]  origin  The original handle of route segment
  * @return  0 on success, otherwise a negative error value.
@@ -379,7 +704,8 @@ int route_segment_foreach_steps(route_segment_h segment, route_segment_step_cb c
 
 /**
  * @brief  Clones the handle of route step.
- * @remarks  The @a cloned_step must be released route_step_destroy() by you.
+ * @remarks  The @a cloned_step must be released route_step_destroy() by you. \n
+ * The step is not copied, the clone keeping the route it belongs to until it is destroyed.
  * @param[out]  cloned_step  A cloned handle of route step
  * @param[in]  origin  The original handle route step
  * @return  0 on success, otherwise a negative error value.
@@ -490,6 +816,23 @@ int route_step_get_instruction(route_step_h step, char** instruction);
  */
 int route_step_foreach_geometries(route_step_h step, route_step_geometry_cb callback, void* user_data);
 
+/**
+ * @brief  Gets the geometry of route step as an encoded polyline string.
+ * @remarks  The @a encoded must be released with free() by you. \n
+ * A step without geometry is encoded from its origin and destination.
+ * @param[in]  step  The handle of route step
+ * @param[in]  precision  The precision of the encoded coordinates
+ * @param[out]  encoded  The encoded polyline
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_RESULT_NOT_FOUND  The step has no geometry
+ * @see  route_encode_polyline()
+ * @see  route_decode_polyline()
+ */
+int route_step_encode_polyline(route_step_h step, route_polyline_precision_e precision, char** encoded);
+
 /**
  * @brief  Gets the list of a pair of key and value in properties.
  * @param[in]  step  The handle of route step
@@ -0,0 +1,96 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_LOCATION_ROUTE_GEODESY_H__
+#define __TIZEN_LOCATION_ROUTE_GEODESY_H__
+
+#include <location_bounds.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup CAPI_LOCATION_ROUTE_GEODESY_MODULE
+ * @{
+ */
+
+/**
+ * @brief Enumerations of the methods computing the distance between two positions
+ */
+typedef enum {
+	ROUTE_GEODESY_METHOD_AUTO = 0,	/**< Equirectangular approximation for short distances, haversine otherwise */
+	ROUTE_GEODESY_METHOD_HAVERSINE = 1,	/**< Great-circle distance on a sphere */
+	ROUTE_GEODESY_METHOD_EQUIRECTANGULAR = 2,	/**< Equirectangular approximation, only accurate for short distances */
+	ROUTE_GEODESY_METHOD_VINCENTY = 3,	/**< Geodesic distance on the WGS84 ellipsoid, the most accurate and the slowest */
+} route_geodesy_method_e;
+
+/**
+ * @brief  Gets the distance between two positions.
+ * @param[in]  from  The first position
+ * @param[in]  to  The second position
+ * @param[in]  method  The method computing the distance
+ * @param[out]  distance  The distance in meters
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see	route_geodesy_get_distances()
+ */
+int route_geodesy_get_distance(location_coords_s from, location_coords_s to, route_geodesy_method_e method, double* distance);
+
+/**
+ * @brief  Gets the distances between pairs of positions given as arrays of latitudes and longitudes.
+ * @remarks  The distance between the i-th positions of the @a from and @a to arrays is stored in the i-th element of @a distances, which must hold @a count elements. \n
+ * The distances between consecutive points of a polyline are computed by passing the arrays of the polyline, and the same arrays shifted by one point.
+ * @param[in]  from_latitudes  The latitudes of the first positions
+ * @param[in]  from_longitudes  The longitudes of the first positions
+ * @param[in]  to_latitudes  The latitudes of the second positions
+ * @param[in]  to_longitudes  The longitudes of the second positions
+ * @param[in]  count  The number of pairs of positions
+ * @param[in]  method  The method computing the distances
+ * @param[out]  distances  The distances in meters
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see	route_geodesy_get_coords_distances()
+ */
+int route_geodesy_get_distances(const double* from_latitudes, const double* from_longitudes, const double* to_latitudes, const double* to_longitudes,
+				int count, route_geodesy_method_e method, double* distances);
+
+/**
+ * @brief  Gets the distances between pairs of positions given as arrays of coordinates.
+ * @remarks  The distance between the i-th positions of @a from and @a to is stored in the i-th element of @a distances, which must hold @a count elements.
+ * @param[in]  from  The first positions
+ * @param[in]  to  The second positions
+ * @param[in]  count  The number of pairs of positions
+ * @param[in]  method  The method computing the distances
+ * @param[out]  distances  The distances in meters
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see	route_geodesy_get_distances()
+ */
+int route_geodesy_get_coords_distances(const location_coords_s* from, const location_coords_s* to, int count, route_geodesy_method_e method, double* distances);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIZEN_LOCATION_ROUTE_GEODESY_H__ */
@@ -60,6 +60,16 @@ typedef void* route_segment_h;
  */
 typedef void* route_step_h;
 
+/**
+ * @brief The handle of route tracker
+ */
+typedef void* route_tracker_h;
+
+/**
+ * @brief The handle of route store
+ */
+typedef void* route_store_h;
+
 #ifdef __cplusplus
 }
 #endif
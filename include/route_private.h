@@ -21,34 +21,486 @@
 #include <location-map-service.h>
 
 #include "route_preference.h"
+#include "route_service.h"
+#include "route_geodesy.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 
+typedef struct _route_cache_s route_cache_s;
+typedef struct _route_cache_entry_s route_cache_entry_s;
+typedef struct _route_response_s route_response_s;
+typedef struct _route_local_s route_local_s;
+typedef struct _route_store_s route_store_s;
+typedef struct _route_store_map_s route_store_map_s;
+
+#define ROUTE_GRAPH_MAGIC "RTGR"
+#define ROUTE_GRAPH_VERSION 2
+
+/*
+ * Road graph file header. The file is mapped read-only and used in place, so every section is an array
+ * of 4-byte values, stored in this order right after the header:
+ * node latitudes and longitudes (int32, degree * 1e6, node_count each),
+ * outgoing edges as CSR offsets (uint32, node_count + 1) and edge targets (uint32, edge_count),
+ * edge distances (float, meter), durations (float, second) and sources (uint32), edge_count each,
+ * incoming edges as CSR offsets (uint32, node_count + 1) and edge indexes (uint32, edge_count),
+ * edge geometry as offsets (uint32, edge_count + 1) into the shape point latitudes and longitudes
+ * (int32, degree * 1e6, shape_count each), which hold the points between the two nodes of each edge,
+ * and the edges crossing each grid cell as CSR offsets (uint32, grid_columns * grid_rows + 1) and
+ * edge indexes (uint32, grid_entry_count).
+ */
+typedef struct _route_graph_header_s{
+    char magic[4];
+    guint32 version;
+    guint32 node_count;
+    guint32 edge_count;
+    guint32 shape_count;
+    guint32 grid_columns;
+    guint32 grid_rows;
+    guint32 grid_entry_count;
+    gint32 grid_min_lat;
+    gint32 grid_min_lon;
+    gint32 grid_cell_size;
+    float max_speed;
+} route_graph_header_s;
+
+#define ROUTE_GRAPH_CH_MAGIC "RTCH"
+#define ROUTE_GRAPH_NO_ARC G_MAXUINT32
+
+typedef enum {
+    ROUTE_GRAPH_METRIC_DURATION = 0,
+    ROUTE_GRAPH_METRIC_DISTANCE = 1,
+} route_graph_metric_e;
+
+/*
+ * Optional Contraction Hierarchy section, following the road graph. It is followed by the node ranks
+ * (uint32, node_count), the arc sources, targets (uint32), weights (float), first and second children
+ * (uint32), each arc_count long, and the upward and downward arc lists as CSR offsets (uint32,
+ * node_count + 1) and arc indexes (uint32). An original arc has the road graph edge as its first child
+ * and ROUTE_GRAPH_NO_ARC as its second child. A shortcut has the two arcs it bypasses as children.
+ */
+typedef struct _route_graph_ch_header_s{
+    char magic[4];
+    guint32 metric;
+    guint32 arc_count;
+    guint32 reserved;
+} route_graph_ch_header_s;
+
+typedef struct _route_graph_s{
+    guint32 node_count;
+    guint32 edge_count;
+    const gint32* node_lat;
+    const gint32* node_lon;
+    const guint32* first_edge;
+    const guint32* edge_target;
+    const float* edge_distance;
+    const float* edge_duration;
+    const guint32* edge_source;
+    const guint32* first_in_edge;
+    const guint32* in_edge;
+    const guint32* geometry_first;
+    const gint32* shape_lat;
+    const gint32* shape_lon;
+    guint32 grid_columns;
+    guint32 grid_rows;
+    double grid_min_lat;
+    double grid_min_lon;
+    double grid_cell_size;
+    const guint32* grid_first;
+    const guint32* grid_edge;
+    double max_speed;
+    gboolean has_ch;
+    route_graph_metric_e ch_metric;
+    guint32 arc_count;
+    const guint32* rank;
+    const guint32* arc_source;
+    const guint32* arc_target;
+    const float* arc_weight;
+    const guint32* arc_first;
+    const guint32* arc_second;
+    const guint32* up_first;
+    const guint32* up_arc;
+    const guint32* down_first;
+    const guint32* down_arc;
+    const char* data;
+    gsize data_size;
+    gsize base_size;
+} route_graph_s;
+
+/* A point of the road graph, snapped on an edge */
+typedef struct _route_graph_snap_s{
+    guint32 edge;
+    double fraction;
+    double latitude;
+    double longitude;
+    double distance;
+} route_graph_snap_s;
+
+/* A path over the road graph, starting and ending part way along its first and last edges */
+typedef struct _route_graph_path_s{
+    GArray* edges;
+    double start_fraction;
+    double end_fraction;
+} route_graph_path_s;
+
+typedef struct _route_graph_route_options_s{
+    gboolean step_used;
+    gboolean step_geometry_used;
+    gboolean step_bounding_box_used;
+    const gchar* transport_mode;
+} route_graph_route_options_s;
+
+/* Called for each point sampled along an edge, and for each shape point in between, at @fraction of its length */
+typedef void (*route_graph_sample_cb)(double latitude, double longitude, double fraction, gpointer user_data);
+
+/* Reachability grid of an isochrone, in row-major order from its south-west cell */
+typedef struct _route_local_isochrone_s{
+    double south;
+    double west;
+    double north;
+    double east;
+    int rows;
+    int columns;
+    long* durations;
+} route_local_isochrone_s;
+
+typedef void (*route_local_isochrone_cb)(LocationError error, guint req_id, const route_local_isochrone_s* isochrone, gpointer userdata);
+
+#define ROUTE_GRAPH_LAT(graph, node) ((graph)->node_lat[node] / 1000000.0)
+#define ROUTE_GRAPH_LON(graph, node) ((graph)->node_lon[node] / 1000000.0)
+
 typedef struct _route_service_s{
     LocationMapObject* object;
     route_preference_h route_preference;
+    route_cache_s* cache;
+    route_local_s* local;
+    GHashTable* requests;
+    GHashTable* inflight;
+    GHashTable* batches;
+    GHashTable* isochrones;
+    GMutex lock;
+    guint last_request_id;
+    guint provider_requests;
+    double max_similarity;
 } route_service_s;
 
 typedef struct _route_preference_s{
     LocationRoutePreference* preference;
 } route_preference_s;
 
+/*
+ * Geometry of a whole route, all arrays in the same allocation. Each point keeps the indexes of the segment
+ * and step it comes from, -1 for a segment without steps, and its distance from the origin along the route.
+ */
+typedef struct _route_polyline_s{
+    int count;
+    double* latitudes;
+    double* longitudes;
+    double* offsets;
+    int* segment_indexes;
+    int* step_indexes;
+} route_polyline_s;
+
+/* Edges of a route polyline crossing each grid cell, as CSR offsets (columns * rows + 1) and edge indexes */
+typedef struct _route_locator_s{
+    double min_lat;
+    double min_lon;
+    double cell_size;
+    guint32 columns;
+    guint32 rows;
+    guint32* cell_first;
+    guint32* cell_edge;
+} route_locator_s;
+
+/* A point snapped on a route polyline, @ratio of the way along its edge */
+typedef struct _route_locator_snap_s{
+    int edge;
+    double ratio;
+    double distance;
+} route_locator_snap_s;
+
+/* A step of a route, or a segment without steps, laid from @start to @end meters along the route polyline */
+typedef struct _route_timing_step_s{
+    double start;
+    double end;
+    double distance;
+    long duration;
+    long elapsed;
+    double distance_after;
+    long duration_after;
+    int segment_index;
+    int step_index;
+} route_timing_step_s;
+
+/* Steps of a route in order, with the durations before (@elapsed) and after them, and the step of each polyline edge */
+typedef struct _route_timing_s{
+    int step_count;
+    route_timing_step_s* steps;
+    int* edge_steps;
+} route_timing_s;
+
+typedef struct _route_bvh_box_s{
+    double min_lat;
+    double min_lon;
+    double max_lat;
+    double max_lon;
+} route_bvh_box_s;
+
+typedef struct _route_bvh_item_s{
+    route_bvh_box_s box;
+    int segment_index;
+    int step_index;
+} route_bvh_item_s;
+
+/* A node of the hierarchy over @count items from @first, its subtree ending before node @skip */
+typedef struct _route_bvh_node_s{
+    route_bvh_box_s box;
+    int first;
+    int count;
+    int skip;
+} route_bvh_node_s;
+
+/* The steps of the items resolved in @route, which changes when route_retain() adopts the route */
+typedef struct _route_bvh_steps_s{
+    LocationRoute* route;
+    struct _route_bvh_steps_s* next;
+    LocationRouteStep** steps;
+} route_bvh_steps_s;
+
+/*
+ * Bounding volume hierarchy over the boxes of the steps of a route, in route order. For a route read in place,
+ * @sources has where each item step starts, and @steps is not used.
+ */
+typedef struct _route_bvh_s{
+    int item_count;
+    int node_count;
+    route_bvh_item_s* items;
+    route_bvh_node_s* nodes;
+    route_bvh_steps_s* steps;
+    struct _route_view_s* sources;
+} route_bvh_s;
+
+/* Sorted grid cells crossed by a route polyline */
+typedef struct _route_signature_s{
+    int count;
+    guint64* cells;
+} route_signature_s;
+
+/*
+ * A cursor over a serialized route. A compact route refers to its strings in @strings, and gives each coordinate
+ * as the difference from the previous one, so that the cursor keeps the last ones read in millionths of a degree.
+ */
+typedef struct _route_view_s{
+    const guint8* data;
+    gsize length;
+    gsize offset;
+    gboolean failed;
+    gboolean compact;
+    const gchar* strings;
+    gsize strings_length;
+    gint32 latitude;
+    gint32 longitude;
+} route_view_s;
+
+typedef enum {
+    ROUTE_VIEW_ROUTE,
+    ROUTE_VIEW_SEGMENT,
+    ROUTE_VIEW_STEP,
+} route_view_level_e;
+
+/*
+ * A route, segment or step read in place from a serialized route. Its strings point into the buffer, its positions
+ * and box into the item itself, which therefore is not copied. @source is a cursor on the item, @properties and
+ * @children on the key and value pairs and on the segments, steps or points that follow its fields.
+ */
+typedef struct _route_view_item_s{
+    int request_id;
+    LocationPosition* start;
+    LocationPosition* end;
+    LocationBoundary* bbox;
+    const gchar* distance_unit;
+    const gchar* transport_mode;
+    const gchar* instruction;
+    gdouble distance;
+    glong duration;
+    route_view_s source;
+    guint property_count;
+    route_view_s properties;
+    guint child_count;
+    route_view_s children;
+    LocationPosition positions[4];
+    LocationBoundary boundary;
+} route_view_item_s;
+
+#define ROUTE_STORE_MAGIC "RTST"
+#define ROUTE_STORE_INDEX_MAGIC "RTSI"
+#define ROUTE_STORE_VERSION 1
+
+/*
+ * Header of the two files of a route store, in native byte order. The data file holds the serialized routes one
+ * after the other, the index file one entry per route, so that appending a route only writes at the end of both.
+ */
+typedef struct _route_store_header_s{
+    char magic[4];
+    guint32 version;
+} route_store_header_s;
+
+typedef struct _route_store_entry_s{
+    guint64 offset;
+    guint64 length;
+} route_store_entry_s;
+
+/*
+ * A route read in place from the mapped file of a route store, which stays mapped as long as the record, or from
+ * a compact route, whose bytes the record holds itself and @map is NULL.
+ */
+typedef struct _route_record_s{
+    route_store_map_s* map;
+    const guint8* data;
+    gsize length;
+    route_view_item_s item;
+} route_record_s;
+
+/*
+ * A route handle has either @route or @record, and then gets @route only when something needs it whole. Handles are
+ * read-only and shared by their clones: those of a response are counted by the response, the others by @ref_count.
+ */
 typedef struct _route_s{
     LocationRoute* route;
     int request_id;
+    volatile gint ref_count;
+    route_response_s* response;
+    route_record_s* record;
+    route_polyline_s* polyline;
+    route_locator_s* locator;
+    route_timing_s* timing;
+    route_bvh_s* bvh;
 } route_s;
 
+/*
+ * A segment or a step points into the route @owner, by which it is found again at its indexes when the route is
+ * moved. A clone holds a reference to @owner, and a copy of @view.
+ */
 typedef struct _route_segment_s{
     LocationRouteSegment* segment;
+    route_view_item_s* view;
+    route_s* owner;
+    int index;
 } route_segment_s;
 
 typedef struct _route_step_s{
     LocationRouteStep* step;
+    route_view_item_s* view;
+    route_s* owner;
+    int segment_index;
+    int index;
 } route_step_s;
 
+/*
+ * Route handles of one response (route.c)
+ */
+route_response_s* route_response_new(GList* route_list, route_cache_entry_s* cache_entry, int request_id);
+route_h route_response_get_route(route_response_s* response, int index);
+int route_response_get_count(route_response_s* response);
+void route_response_unref(route_response_s* response);
+route_polyline_s* route_polyline_new(LocationRoute* route);
+route_polyline_s* route_polyline_get(route_s* route);
+gpointer route_publish_lazy(gpointer* slot, gpointer value, GDestroyNotify free_fn);
+
+/*
+ * Spatial index of a route geometry (route_locator.c)
+ */
+route_locator_s* route_locator_get(route_s* route);
+void route_locator_free(route_locator_s* locator);
+double route_locator_snap_edge(const route_polyline_s* polyline, int edge, double latitude, double longitude, double* ratio);
+gboolean route_locator_find_nearest(route_s* route, double latitude, double longitude, route_locator_snap_s* snap);
+
+/*
+ * Timing table of a route (route_timing.c)
+ */
+route_timing_s* route_timing_get(route_s* route);
+void route_timing_free(route_timing_s* timing);
+int route_timing_find_step(const route_timing_s* timing, double offset);
+double route_timing_step_progress(const route_timing_step_s* step, double offset);
+
+/*
+ * Hierarchy of the step boxes of a route (route_bvh.c)
+ */
+route_bvh_s* route_bvh_get(route_s* route);
+void route_bvh_free(route_bvh_s* bvh);
+
+/*
+ * Similarity of routes (route_similarity.c)
+ */
+route_signature_s* route_signature_new(const route_polyline_s* polyline);
+void route_signature_free(route_signature_s* signature);
+double route_signature_similarity(const route_signature_s* a, const route_signature_s* b);
+GList* route_similarity_filter(GList* route_list, double max_similarity);
+
+/*
+ * Serialized routes, and routes read in place (route_serialize.c)
+ */
+gboolean route_view_open(const guint8* data, gsize length, route_view_item_s* item);
+gboolean route_view_read_item(route_view_s* view, route_view_level_e level, route_view_item_s* item);
+void route_view_read_property(route_view_s* view, const gchar** key, const gchar** value);
+gboolean route_view_read_position(route_view_s* view, LocationPosition* pos);
+void route_view_copy_item(route_view_item_s* copy, const route_view_item_s* item);
+LocationRoute* route_view_get_location_route(route_s* route);
+
+/*
+ * Route store (route_store.c)
+ */
+route_s* route_record_new(route_store_map_s* map, const guint8* data, gsize length);
+void route_store_map_unref(route_store_map_s* map);
+
+/*
+ * Route result cache (route_cache.c)
+ */
+route_cache_s* route_cache_new(void);
+void route_cache_free(route_cache_s* cache);
+void route_cache_set_policy(route_cache_s* cache, int ttl, gsize max_size);
+void route_cache_get_statistics(route_cache_s* cache, guint* hits, guint* misses);
+gboolean route_cache_is_enabled(route_cache_s* cache);
+void route_cache_clear(route_cache_s* cache);
+gchar* route_cache_build_key(location_coords_s origin, location_coords_s destination, location_coords_s* waypoint_list, int waypoint_num, LocationRoutePreference* pref);
+route_cache_entry_s* route_cache_lookup(route_cache_s* cache, const gchar* key);
+route_cache_entry_s* route_cache_insert(route_cache_s* cache, const gchar* key, GList* route_list);
+GList* route_cache_entry_get_routes(route_cache_entry_s* entry);
+route_cache_entry_s* route_cache_entry_ref(route_cache_entry_s* entry);
+void route_cache_entry_unref(route_cache_entry_s* entry);
+
+/*
+ * Road graph (route_graph.c)
+ */
+route_graph_s* route_graph_load(const char* path);
+void route_graph_free(route_graph_s* graph);
+gboolean route_graph_find_nearest(route_graph_s* graph, double latitude, double longitude, route_graph_snap_s* snap);
+guint32 route_graph_find_twin_edge(route_graph_s* graph, guint32 edge);
+void route_graph_sample_edge(route_graph_s* graph, guint32 edge, double from, double to, double spacing, route_graph_sample_cb callback, gpointer user_data);
+LocationRoute* route_graph_new_route(route_graph_s* graph, const route_graph_path_s* legs, const LocationPosition* points, int point_count, const route_graph_route_options_s* options);
+double route_graph_distance(double lat1, double lon1, double lat2, double lon2);
+double route_graph_bearing(double lat1, double lon1, double lat2, double lon2);
+
+/*
+ * Geodesy (route_geodesy.c)
+ */
+double route_geodesy_haversine(double lat1, double lon1, double lat2, double lon2);
+double route_geodesy_distance(route_geodesy_method_e method, double lat1, double lon1, double lat2, double lon2);
+void route_geodesy_distances(route_geodesy_method_e method, const double* lat1, const double* lon1, const double* lat2, const double* lon2, int count, double* distances);
+
+/*
+ * Offline routing provider (route_local.c)
+ */
+route_local_s* route_local_new(const char* graph_path);
+void route_local_free(route_local_s* local);
+int route_local_request_route(route_local_s* local, const LocationPosition* origin, const LocationPosition* destination, GList* waypoint, LocationRoutePreference* pref, LocationRouteCB callback, gpointer userdata, guint* req_id);
+int route_local_request_isochrone(route_local_s* local, const LocationPosition* origin, long max_duration, double resolution, LocationRoutePreference* pref, route_local_isochrone_cb callback, gpointer userdata, guint* req_id);
+int route_local_cancel_route_request(route_local_s* local, guint req_id);
+gboolean route_local_is_supported_capability(route_local_s* local, LocationMapServiceType type);
+int route_local_get_capability_key(route_local_s* local, LocationMapServiceType type, GList** key);
+
 #ifdef __cplusplus
 }
 #endif
@@ -17,6 +17,7 @@
 #ifndef __TIZEN_LOCATION_ROUTE_SERVICE_H__
 #define __TIZEN_LOCATION_ROUTE_SERVICE_H__
 
+#include <stddef.h>
 #include <location_bounds.h>
 
 #include "route_handle.h"
@@ -32,7 +33,7 @@ extern "C" {
 
 /**
  * @brief	 Called when the requested routes are found by route_service_find().
- * @remarks  @a route is valid only in this function. In order to use the route outside this function, you must copy the route with route_clone(). \n
+ * @remarks  @a route is valid only in this function. In order to use the route outside this function, you must keep it with route_retain() or route_clone(). \n
  * If route_service_find() failed, this callback function is called only once with 0 total and NULL route.
  * @param[in]  route_error_e  The reuslt of request
  * @param[in]  request_id  The identification of request
@@ -45,6 +46,75 @@ extern "C" {
  */
 typedef bool(*route_service_found_cb)(route_error_e error, int index, int total, route_h route, void* user_data);
 
+/**
+ * @brief  The structure of a route request used in route_service_find_batch()
+ */
+typedef struct
+{
+    location_coords_s origin;  /**< The starting point */
+    location_coords_s destination;  /**< The destination */
+    location_coords_s* waypoint_list;  /**< The list of waypoints to go through */
+    int waypoint_num;  /**< The number of waypoints to go through */
+} route_service_batch_item_s;
+
+/**
+ * @brief	 Called when the routes of an item requested by route_service_find_batch() are found.
+ * @remarks  @a route is valid only in this function. In order to use the route outside this function, you must keep it with route_retain() or route_clone(). \n
+ * If the request of an item failed, this callback function is called only once for the item with 0 total and NULL route.
+ * @param[in]  error  The result of the item request
+ * @param[in]  item_index  The index of the item in the array passed to route_service_find_batch()
+ * @param[in]  index  The index of the route among the results of the item
+ * @param[in]  total  The total number of results of the item
+ * @param[in]  route  The route data
+ * @param[in]  user_data  The user data passed from the request function
+ * @return  @c true to continue with the next route of the item, \n @c false to skip the remaining routes of the item
+ * @pre  route_service_find_batch() will invoke this callback.
+ * @see  route_service_find_batch()
+ */
+typedef bool(*route_service_batch_found_cb)(route_error_e error, int item_index, int index, int total, route_h route, void* user_data);
+
+/**
+ * @brief	 Called once when all items requested by route_service_find_batch() are processed.
+ * @param[in]  batch_id  The batch ID
+ * @param[in]  failed_count  The number of items whose request failed
+ * @param[in]  user_data  The user data passed from the request function
+ * @pre  route_service_find_batch() will invoke this callback.
+ * @see  route_service_find_batch()
+ */
+typedef void(*route_service_batch_completed_cb)(int batch_id, int failed_count, void* user_data);
+
+/**
+ * @brief	 Called when the travel matrix requested by route_service_find_matrix() is filled.
+ * @remarks  @a distances and @a durations are valid only in this function. \n
+ * Both are dense row-major matrices of @a origin_count rows and @a destination_count columns. A pair whose route was not found is set to -1.
+ * @param[in]  error  The result of request
+ * @param[in]  origin_count  The number of origins
+ * @param[in]  destination_count  The number of destinations
+ * @param[in]  distances  The total distance of the route of each pair. You can get the distance unit by route_get_distance_unit().
+ * @param[in]  durations  The total duration of the route of each pair
+ * @param[in]  user_data  The user data passed from the request function
+ * @pre  route_service_find_matrix() will invoke this callback.
+ * @see  route_service_find_matrix()
+ */
+typedef void(*route_service_matrix_found_cb)(route_error_e error, int origin_count, int destination_count, const double* distances, const long* durations, void* user_data);
+
+/**
+ * @brief	 Called when the reachability grid requested by route_service_find_isochrone() is computed.
+ * @remarks  @a durations is valid only in this function. \n
+ * It is a dense row-major grid of @a rows rows from south to north and @a columns columns from west to east, covering the area from @a south_west to @a north_east. Each cell holds the shortest travel time in seconds to a road inside the cell, or -1 if no road of the cell is reachable within the budget. \n
+ * If the request failed, @a rows and @a columns are 0 and @a durations is NULL.
+ * @param[in]  error  The result of request
+ * @param[in]  south_west  The south-west corner of the grid
+ * @param[in]  north_east  The north-east corner of the grid
+ * @param[in]  rows  The number of rows of the grid
+ * @param[in]  columns  The number of columns of the grid
+ * @param[in]  durations  The travel time to each cell
+ * @param[in]  user_data  The user data passed from the request function
+ * @pre  route_service_find_isochrone() will invoke this callback.
+ * @see  route_service_find_isochrone()
+ */
+typedef void(*route_service_isochrone_found_cb)(route_error_e error, location_coords_s south_west, location_coords_s north_east, int rows, int columns, const long* durations, void* user_data);
+
 /**
  * @brief  Creates a new handle of route service.
  * @remarks  The @a service must be released route_service_destroy() by you.
@@ -58,6 +128,26 @@ typedef bool(*route_service_found_cb)(route_error_e error, int index, int total,
  */
 int route_service_create(route_service_h* service);
 
+/**
+ * @brief  Creates a new handle of route service which computes routes on the device from a road graph file.
+ * @remarks  The @a service must be released route_service_destroy() by you. \n
+ * No network connection is used. The road graph file at @a graph_path is built from an OpenStreetMap extract by the route_graph_build tool, and is mapped in memory rather than read. \n
+ * The origin, the destination and the waypoints are snapped to the nearest road. Routes are searched with a bidirectional A* over the road graph, and are delivered through the same callbacks as routes of the map provider, with segments, steps and geometry. \n
+ * If the road graph file carries a Contraction Hierarchy, built by the route_graph_contract tool for the metric of the requested goal, routes are searched on the hierarchy instead, and its shortcuts are unpacked into the original roads. \n
+ * The goal "SHORTEST" minimizes the distance, and any other goal minimizes the duration. Areas, addresses and features to avoid are not supported. \n
+ * The distance unit of the routes is "M".
+ * @param[out]  service  A handle of a new route service on success
+ * @param[in]  graph_path  The path of the road graph file
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_SERVICE_NOT_AVAILABLE  The road graph file cannot be loaded
+ * @see	route_service_create()
+ * @see	route_service_destroy()
+ */
+int route_service_create_offline(route_service_h* service, const char* graph_path);
+
 /**
  * @brief	 Destroys the handle of route service and releases all its resources.
  * @param[in]  service  The route service handle to destroy
@@ -92,6 +182,8 @@ int route_service_set_preference(route_service_h service, route_preference_h pre
 
 /**
  * @brief	 Requests to find the route, asynchronously.
+ * @remarks  While a request is pending, an identical request on the same @a service is attached to it instead of being sent to the map service provider again. \n
+ * Every caller gets its own @a request_id, and cancelling one of them with route_service_cancel() does not affect the others.
  * @param[in]  service  The handle of route service
  * @param[in]  origin  The starting point
  * @param[in]  destination  The destination
@@ -113,7 +205,7 @@ int route_service_find(route_service_h service, location_coords_s origin, locati
 /**
  * @brief	 Cancels the request.
  * @param[in]  service  The handle of route service
- * @param[out]  request_id  The request ID which is got from route_service_find()
+ * @param[out]  request_id  The request ID which is got from route_service_find(), route_service_find_matrix() or route_service_find_isochrone(), or the batch ID which is got from route_service_find_batch()
  * @return  0 on success, otherwise a negative error value.
  * @retval  #ROUTE_ERROR_NONE  Successful
  * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
@@ -121,6 +213,144 @@ int route_service_find(route_service_h service, location_coords_s origin, locati
  */
 int route_service_cancel(route_service_h service, int request_id);
 
+/**
+ * @brief	 Requests to find the routes of several items, asynchronously.
+ * @remarks  At most @a max_pending item requests are sent to the map service provider at a time, and the next item is requested as soon as a pending one is answered. \n
+ * The whole batch can be cancelled by passing @a batch_id to route_service_cancel(). In that case @a completed_callback is not called.
+ * @param[in]  service  The handle of route service
+ * @param[in]  items  The array of items to find the route for
+ * @param[in]  item_count  The number of items
+ * @param[in]  max_pending  The maximum number of item requests pending at the same time
+ * @param[in]  found_callback  The callback invoked with the results of each item
+ * @param[in]  completed_callback  The callback invoked when all items are processed, can be NULL
+ * @param[in]  user_data  The user data to be passed to the callback functions
+ * @param[out]  batch_id  The batch ID
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see	route_service_cancel()
+ * @see  route_service_batch_found_cb()
+ * @see  route_service_batch_completed_cb()
+ */
+int route_service_find_batch(route_service_h service, const route_service_batch_item_s* items, int item_count, int max_pending, route_service_batch_found_cb found_callback, route_service_batch_completed_cb completed_callback, void* user_data, int* batch_id);
+
+/**
+ * @brief	 Requests to find the travel distance and duration between every origin and destination, asynchronously.
+ * @remarks  Only the summary of the routes is requested from the map service provider, without geometries and instructions. \n
+ * Identical pairs are requested once and a pair of identical points is set to 0 without a request. If @a symmetric is @c true, the route from B to A is assumed to match the route from A to B and only one of them is requested. \n
+ * At most @a max_pending pairs are requested at a time. The request can be cancelled by passing @a request_id to route_service_cancel().
+ * @param[in]  service  The handle of route service
+ * @param[in]  origins  The array of origins
+ * @param[in]  origin_count  The number of origins
+ * @param[in]  destinations  The array of destinations
+ * @param[in]  destination_count  The number of destinations
+ * @param[in]  symmetric  @c true to assume the travel between two points is the same in both directions
+ * @param[in]  max_pending  The maximum number of pair requests pending at the same time
+ * @param[in]  callback  The result callback
+ * @param[in]  user_data  The user data to be passed to the callback function
+ * @param[out]  request_id  The request ID
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see	route_service_cancel()
+ * @see  route_service_matrix_found_cb()
+ */
+int route_service_find_matrix(route_service_h service, const location_coords_s* origins, int origin_count, const location_coords_s* destinations, int destination_count, bool symmetric, int max_pending, route_service_matrix_found_cb callback, void* user_data, int* request_id);
+
+/**
+ * @brief	 Requests to find the area reachable from an origin within a travel time, asynchronously.
+ * @remarks  The area is computed by a single search from @a origin over the roads, with the transport mode of the route preference of @a service. It is reported as a grid of square cells of @a resolution meters, which are made coarser if the reachable area would need more than a million cells. \n
+ * A budget that could reach across more than about 65,000 cells of @a resolution meters at the top speed of the roads is rejected with #ROUTE_ERROR_INVALID_PARAMETER. \n
+ * Only a route service created by route_service_create_offline() supports this request. \n
+ * The request can be cancelled by passing @a request_id to route_service_cancel().
+ * @param[in]  service  The handle of route service
+ * @param[in]  origin  The starting point
+ * @param[in]  max_duration  The travel time budget in seconds
+ * @param[in]  resolution  The size of the cells of the grid in meters
+ * @param[in]  callback  The result callback
+ * @param[in]  user_data  The user data to be passed to the callback function
+ * @param[out]  request_id  The request ID
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_SERVICE_NOT_SUPPORTED  The service or its transport mode does not support isochrones
+ * @see	route_service_cancel()
+ * @see  route_service_isochrone_found_cb()
+ */
+int route_service_find_isochrone(route_service_h service, location_coords_s origin, long max_duration, double resolution, route_service_isochrone_found_cb callback, void* user_data, int* request_id);
+
+/**
+ * @brief	 Sets the policy of the route result cache.
+ * @remarks  Routes found by route_service_find() are kept per origin, destination, waypoints and route preference, and an identical request is answered through route_service_found_cb() without contacting the map service provider. \n
+ * The least recently used results are evicted first when the cache exceeds @a max_size. \n
+ * The cache is disabled by default. Setting @a max_size to 0 disables it and drops all cached results.
+ * @param[in]  service  The handle of route service
+ * @param[in]  ttl  The time in seconds a cached result stays valid, or 0 to keep results until they are evicted
+ * @param[in]  max_size  The maximum memory in bytes used by cached results
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see	route_service_clear_cache()
+ * @see	route_service_find()
+ */
+int route_service_set_cache_policy(route_service_h service, int ttl, size_t max_size);
+
+/**
+ * @brief	 Sets how similar alternative routes found by route_service_find() may be.
+ * @remarks  The routes of a result are compared in the order of the provider, and a route more similar than @a max_similarity to a route kept before it is dropped before it reaches route_service_found_cb(). The @a index and @a total of the callback count only the routes kept. \n
+ * The similarity is the one of route_get_similarity(). Setting @a max_similarity to 1, the default, keeps all the routes. \n
+ * The setting applies to the requests made after it.
+ * @param[in]  service  The handle of route service
+ * @param[in]  max_similarity  The highest similarity between 0 and 1 of an alternative to the routes kept before it
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see	route_service_find()
+ * @see	route_get_similarity()
+ */
+int route_service_set_alternative_filter(route_service_h service, double max_similarity);
+
+/**
+ * @brief	 Drops all results kept in the route result cache.
+ * @param[in]  service  The handle of route service
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see	route_service_set_cache_policy()
+ * @see	route_service_get_cache_statistics()
+ */
+int route_service_clear_cache(route_service_h service);
+
+/**
+ * @brief	 Gets how many requests the route result cache answered since the service was created.
+ * @remarks  Only the requests made while the cache is enabled are counted. A request missing the cache may still share the pending request of an identical one. \n
+ * route_service_clear_cache() drops the results but keeps the counts.
+ * @param[in]  service  The handle of route service
+ * @param[out]  hits  The number of requests answered from the cache
+ * @param[out]  misses  The number of requests not found in the cache
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see	route_service_set_cache_policy()
+ * @see	route_service_clear_cache()
+ */
+int route_service_get_cache_statistics(route_service_h service, int* hits, int* misses);
+
+/**
+ * @brief	 Gets how many route requests were sent to the map service provider since the service was created.
+ * @remarks  Identical requests pending at the same time share one provider request, and requests answered from the cache send none.
+ * @param[in]  service  The handle of route service
+ * @param[out]  count  The number of route requests sent to the map service provider
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see	route_service_find()
+ */
+int route_service_get_provider_request_count(route_service_h service, int* count);
+
 /**
  * @}
  */
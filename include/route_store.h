@@ -0,0 +1,107 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_LOCATION_ROUTE_STORE_H__
+#define __TIZEN_LOCATION_ROUTE_STORE_H__
+
+#include "route_handle.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup CAPI_LOCATION_ROUTE_STORE_MODULE
+ * @{
+ */
+
+/**
+ * @brief  Opens a route store, creating it when it does not exist.
+ * @remarks  The @a store must be released route_store_close() by you. \n
+ * A store is made of the file at @a path, which holds the routes as route_serialize() writes them, and of its index at @a path with the ".idx" suffix. \n
+ * Opening a store only checks the headers of its files and the last entries of its index, so it takes the same time whatever the number of routes. The files are mapped in memory by route_store_get_route(), on its first call and then for routes appended since. A store that cannot be written is opened read-only.
+ * @param[in]  path  The path of the store file
+ * @param[out]  store  A handle of the route store
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_SERVICE_NOT_AVAILABLE  The files cannot be opened, or are not those of a route store
+ * @see	route_store_close()
+ */
+int route_store_open(const char* path, route_store_h* store);
+
+/**
+ * @brief  Closes the route store.
+ * @remarks  The routes got from the store stay valid until they are destroyed.
+ * @param[in]  store  The route store handle
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see	route_store_open()
+ */
+int route_store_close(route_store_h store);
+
+/**
+ * @brief  Appends a route to the route store.
+ * @param[in]  store  The route store handle
+ * @param[in]  route  The route handle
+ * @param[out]  index  The index of the route in the store
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_SERVICE_NOT_AVAILABLE  The store is read-only, or its files cannot be written
+ * @see	route_store_get_route()
+ */
+int route_store_append(route_store_h store, route_h route, int* index);
+
+/**
+ * @brief  Gets the number of routes in the route store.
+ * @param[in]  store  The route store handle
+ * @param[out]  count  The number of routes
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ */
+int route_store_get_count(route_store_h store, int* count);
+
+/**
+ * @brief  Gets a route of the route store.
+ * @remarks  The @a route must be released route_destroy() by you. \n
+ * The route is read in place from the mapped file, so that it takes no copy of the route. Its getters read the file as they are called, and only the polyline, tracking and step lookups build tables of their own, on their first call.
+ * @param[in]  store  The route store handle
+ * @param[in]  index  The index of the route, from 0 to the number of routes minus one
+ * @param[out]  route  The route handle
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_SERVICE_NOT_AVAILABLE  The file cannot be mapped, or the route in it is corrupted
+ * @see	route_store_append()
+ * @see	route_destroy()
+ */
+int route_store_get_route(route_store_h store, int index, route_h* route);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIZEN_LOCATION_ROUTE_STORE_H__ */
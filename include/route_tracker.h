@@ -0,0 +1,139 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#ifndef __TIZEN_LOCATION_ROUTE_TRACKER_H__
+#define __TIZEN_LOCATION_ROUTE_TRACKER_H__
+
+#include <location_bounds.h>
+
+#include "route_handle.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup CAPI_LOCATION_ROUTE_TRACKER_MODULE
+ * @{
+ */
+
+/**
+ * @brief  Creates a tracker of the progress along a route.
+ * @remarks  The @a tracker must be released route_tracker_destroy() by you. \n
+ * The tracker keeps its own reference to the @a route, as route_clone() does.
+ * @param[in]  route  The route handle
+ * @param[in]  off_route_distance  The distance in meters from the route beyond which a position is off the route
+ * @param[out]  tracker  A handle of the new route tracker
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @retval  #ROUTE_ERROR_RESULT_NOT_FOUND  The route has no geometry to track
+ * @see	route_tracker_destroy()
+ */
+int route_tracker_create(route_h route, double off_route_distance, route_tracker_h* tracker);
+
+/**
+ * @brief  Destroys the route tracker.
+ * @param[in]  tracker  The route tracker handle
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see	route_tracker_create()
+ */
+int route_tracker_destroy(route_tracker_h tracker);
+
+/**
+ * @brief  Updates the route tracker with a new position fix.
+ * @remarks  The position is first matched near the last matched one, so an update does not search the whole route. \n
+ * A position farther than the off-route distance from the route marks the tracker off the route, and keeps the last progress.
+ * @param[in]  tracker  The route tracker handle
+ * @param[in]  position  The position fix
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @retval  #ROUTE_ERROR_OUT_OF_MEMORY  Out of memory
+ * @see	route_tracker_is_off_route()
+ */
+int route_tracker_update(route_tracker_h tracker, location_coords_s position);
+
+/**
+ * @brief  Gets the position on the route last matched by route_tracker_update().
+ * @remarks  Before the first match, it is the origin of the route.
+ * @param[in]  tracker  The route tracker handle
+ * @param[out]  position  The matched position
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ */
+int route_tracker_get_matched_position(route_tracker_h tracker, location_coords_s* position);
+
+/**
+ * @brief  Gets the remaining distance to the destination.
+ * @remarks  The distance is in the distance unit of the route, from the distances of its steps. You can get the distance unit by route_get_distance_unit().
+ * @param[in]  tracker  The route tracker handle
+ * @param[out]  distance  The remaining distance
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see	route_tracker_get_remaining_duration()
+ */
+int route_tracker_get_remaining_distance(route_tracker_h tracker, double* distance);
+
+/**
+ * @brief  Gets the remaining duration to the destination.
+ * @remarks  The duration is computed from the durations of the steps of the route.
+ * @param[in]  tracker  The route tracker handle
+ * @param[out]  duration  The remaining duration
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see	route_tracker_get_remaining_distance()
+ */
+int route_tracker_get_remaining_duration(route_tracker_h tracker, long* duration);
+
+/**
+ * @brief  Gets the step holding the matched position.
+ * @remarks  The @a step_index is -1 when the segment has no steps.
+ * @param[in]  tracker  The route tracker handle
+ * @param[out]  segment_index  The index of the segment
+ * @param[out]  step_index  The index of the step, in its segment
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ */
+int route_tracker_get_current_step(route_tracker_h tracker, int* segment_index, int* step_index);
+
+/**
+ * @brief  Checks whether the last position fix was off the route.
+ * @param[in]  tracker  The route tracker handle
+ * @param[out]  off_route  @c true if the last position was off the route, otherwise @c false
+ * @return  0 on success, otherwise a negative error value.
+ * @retval  #ROUTE_ERROR_NONE  Successful
+ * @retval  #ROUTE_ERROR_INVALID_PARAMETER  Invalid parameter
+ * @see	route_tracker_update()
+ */
+int route_tracker_is_off_route(route_tracker_h tracker, bool* off_route);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIZEN_LOCATION_ROUTE_TRACKER_H__ */
@@ -46,6 +46,317 @@
 #define ROUTE_NULL_ARG_CHECK(arg)\
 	ROUTE_CHECK_CONDITION( (arg != NULL), ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER")
 
+/*
+ * Route response
+ */
+struct _route_response_s {
+	volatile gint ref_count;
+	route_cache_entry_s *cache_entry;
+	GMutex lock;
+	GList *owned_routes;
+	gboolean owned;
+	int route_count;
+	route_s routes[];
+};
+
+static void __free_route(gpointer data)
+{
+	location_route_free((LocationRoute *) data);
+}
+
+typedef struct {
+	route_polyline_s *polyline;
+	int count;
+	int segment_index;
+	int step_index;
+} __polyline_builder;
+
+/* Skips the points repeated where steps and segments meet */
+static void __polyline_add(__polyline_builder *builder, const LocationPosition *pos)
+{
+	route_polyline_s *polyline = builder->polyline;
+
+	if (pos == NULL) {
+		return;
+	}
+	if (builder->count > 0 && polyline) {
+		if (polyline->latitudes[builder->count - 1] == pos->latitude
+		    && polyline->longitudes[builder->count - 1] == pos->longitude) {
+			return;
+		}
+	}
+	if (polyline) {
+		polyline->latitudes[builder->count] = pos->latitude;
+		polyline->longitudes[builder->count] = pos->longitude;
+		polyline->segment_indexes[builder->count] = builder->segment_index;
+		polyline->step_indexes[builder->count] = builder->step_index;
+	}
+	builder->count++;
+}
+
+/* Without a @builder->polyline, only counts an upper bound of the points. */
+static void __polyline_walk(LocationRoute *route, __polyline_builder *builder)
+{
+	GList *seg_list;
+	GList *step_list;
+	GList *geometry_list;
+
+	builder->segment_index = 0;
+	for (seg_list = location_route_get_route_segment(route); seg_list; seg_list = seg_list->next, builder->segment_index++) {
+		LocationRouteSegment *segment = seg_list->data;
+
+		builder->step_index = -1;
+		step_list = location_route_segment_get_route_step(segment);
+		if (step_list == NULL) {
+			__polyline_add(builder, location_route_segment_get_start_point(segment));
+			__polyline_add(builder, location_route_segment_get_end_point(segment));
+			continue;
+		}
+		for (builder->step_index = 0; step_list; step_list = step_list->next, builder->step_index++) {
+			LocationRouteStep *step = step_list->data;
+
+			geometry_list = location_route_step_get_geometry(step);
+			if (geometry_list == NULL) {
+				__polyline_add(builder, location_route_step_get_start_point(step));
+				__polyline_add(builder, location_route_step_get_end_point(step));
+				continue;
+			}
+			for (; geometry_list; geometry_list = geometry_list->next) {
+				__polyline_add(builder, geometry_list->data);
+			}
+		}
+	}
+}
+
+/* The same walk over a route read in place */
+static void __polyline_walk_view(const route_view_item_s *route, __polyline_builder *builder)
+{
+	route_view_s seg_view = route->children;
+	route_view_item_s segment;
+	route_view_item_s step;
+	LocationPosition pos;
+	guint i;
+
+	for (builder->segment_index = 0; builder->segment_index < (int) route->child_count
+	     && route_view_read_item(&seg_view, ROUTE_VIEW_SEGMENT, &segment); builder->segment_index++) {
+		route_view_s step_view = segment.children;
+
+		builder->step_index = -1;
+		if (segment.child_count == 0) {
+			__polyline_add(builder, segment.start);
+			__polyline_add(builder, segment.end);
+			continue;
+		}
+		for (builder->step_index = 0; builder->step_index < (int) segment.child_count
+		     && route_view_read_item(&step_view, ROUTE_VIEW_STEP, &step); builder->step_index++) {
+			route_view_s geometry_view = step.children;
+
+			if (step.child_count == 0) {
+				__polyline_add(builder, step.start);
+				__polyline_add(builder, step.end);
+				continue;
+			}
+			for (i = 0; i < step.child_count; i++) {
+				if (route_view_read_position(&geometry_view, &pos)) {
+					__polyline_add(builder, &pos);
+				}
+			}
+		}
+	}
+}
+
+static route_polyline_s *__polyline_new(LocationRoute *route, const route_view_item_s *view)
+{
+	__polyline_builder builder = { NULL, 0, 0, 0 };
+	route_polyline_s *polyline;
+	int i;
+
+	if (view) {
+		__polyline_walk_view(view, &builder);
+	} else {
+		__polyline_walk(route, &builder);
+	}
+
+	polyline = (route_polyline_s *) malloc(sizeof(route_polyline_s) + builder.count * (3 * sizeof(double) + 2 * sizeof(int)));
+	if (polyline == NULL) {
+		return NULL;
+	}
+	polyline->latitudes = (double *)(polyline + 1);
+	polyline->longitudes = polyline->latitudes + builder.count;
+	polyline->offsets = polyline->longitudes + builder.count;
+	polyline->segment_indexes = (int *)(polyline->offsets + builder.count);
+	polyline->step_indexes = polyline->segment_indexes + builder.count;
+
+	builder.polyline = polyline;
+	builder.count = 0;
+	if (view) {
+		__polyline_walk_view(view, &builder);
+	} else {
+		__polyline_walk(route, &builder);
+	}
+	polyline->count = builder.count;
+
+	if (polyline->count > 0) {
+		/* Edge lengths first, in one batch, then their running sum */
+		polyline->offsets[0] = 0;
+		route_geodesy_distances(ROUTE_GEODESY_METHOD_AUTO, polyline->latitudes, polyline->longitudes, polyline->latitudes + 1,
+					polyline->longitudes + 1, polyline->count - 1, polyline->offsets + 1);
+		for (i = 1; i < polyline->count; i++) {
+			polyline->offsets[i] += polyline->offsets[i - 1];
+		}
+	}
+
+	return polyline;
+}
+
+route_polyline_s *route_polyline_new(LocationRoute *route)
+{
+	return __polyline_new(route, NULL);
+}
+
+/*
+ * Publishes a lazily built value into slot and returns the published one. Another thread may have built it
+ * meanwhile, the first one published wins and the others are freed with free_fn.
+ */
+gpointer route_publish_lazy(gpointer *slot, gpointer value, GDestroyNotify free_fn)
+{
+	if (!g_atomic_pointer_compare_and_exchange(slot, NULL, value)) {
+		free_fn(value);
+		value = g_atomic_pointer_get(slot);
+	}
+
+	return value;
+}
+
+route_polyline_s *route_polyline_get(route_s *route)
+{
+	route_polyline_s *polyline = g_atomic_pointer_get(&route->polyline);
+
+	if (polyline == NULL) {
+		polyline = route->record ? __polyline_new(NULL, &route->record->item) : route_polyline_new(route->route);
+		if (polyline == NULL) {
+			return NULL;
+		}
+		polyline = route_publish_lazy((gpointer *) &route->polyline, polyline, free);
+	}
+
+	return polyline;
+}
+
+/* The property callbacks of routes, segments and steps all take the same arguments */
+static void __view_foreach_properties(const route_view_item_s *item, route_property_cb callback, void *user_data)
+{
+	route_view_s view = item->properties;
+	const char *key;
+	const char *value;
+	guint i;
+
+	for (i = 0; i < item->property_count; i++) {
+		route_view_read_property(&view, &key, &value);
+		if (key != NULL && value != NULL && callback(key, value, user_data) == false) {
+			break;
+		}
+	}
+}
+
+/*
+ * Moves the routes under the response, so that its handles stay valid once the found callback returns.
+ * Handles of one response may be retained from several threads, so the routes are copied only once, under the lock.
+ */
+static gboolean __response_adopt(route_response_s *response)
+{
+	GList *owned_routes = NULL;
+	int i;
+
+	g_mutex_lock(&response->lock);
+	if (response->owned) {
+		g_mutex_unlock(&response->lock);
+		return TRUE;
+	}
+
+	for (i = 0; i < response->route_count; i++) {
+		LocationRoute *route = location_route_copy(response->routes[i].route);
+		if (route == NULL) {
+			g_mutex_unlock(&response->lock);
+			g_list_free_full(owned_routes, __free_route);
+			return FALSE;
+		}
+		owned_routes = g_list_prepend(owned_routes, route);
+	}
+
+	owned_routes = g_list_reverse(owned_routes);
+	response->owned_routes = owned_routes;
+	for (i = 0; owned_routes; i++, owned_routes = owned_routes->next) {
+		g_atomic_pointer_set(&response->routes[i].route, owned_routes->data);
+	}
+	response->owned = TRUE;
+	g_mutex_unlock(&response->lock);
+
+	return TRUE;
+}
+
+route_response_s *route_response_new(GList *route_list, route_cache_entry_s *cache_entry, int request_id)
+{
+	route_response_s *response;
+	int count = g_list_length(route_list);
+	int i;
+
+	response = (route_response_s *) malloc(sizeof(route_response_s) + count * sizeof(route_s));
+	if (response == NULL) {
+		return NULL;
+	}
+
+	response->ref_count = 1;
+	g_mutex_init(&response->lock);
+	response->cache_entry = route_cache_entry_ref(cache_entry);
+	response->owned_routes = NULL;
+	/* The routes of a cache entry live as long as the entry, so the response only needs to keep it. */
+	response->owned = cache_entry != NULL;
+	response->route_count = count;
+	for (i = 0; i < count; i++, route_list = route_list->next) {
+		response->routes[i].route = route_list->data;
+		response->routes[i].request_id = request_id;
+		response->routes[i].response = response;
+		response->routes[i].record = NULL;
+		response->routes[i].polyline = NULL;
+		response->routes[i].locator = NULL;
+		response->routes[i].timing = NULL;
+		response->routes[i].bvh = NULL;
+	}
+
+	return response;
+}
+
+route_h route_response_get_route(route_response_s *response, int index)
+{
+	return (route_h) &response->routes[index];
+}
+
+int route_response_get_count(route_response_s *response)
+{
+	return response->route_count;
+}
+
+void route_response_unref(route_response_s *response)
+{
+	int i;
+
+	if (response == NULL || !g_atomic_int_dec_and_test(&response->ref_count)) {
+		return;
+	}
+
+	for (i = 0; i < response->route_count; i++) {
+		free(response->routes[i].polyline);
+		route_locator_free(response->routes[i].locator);
+		route_timing_free(response->routes[i].timing);
+		route_bvh_free(response->routes[i].bvh);
+	}
+	route_cache_entry_unref(response->cache_entry);
+	g_list_free_full(response->owned_routes, __free_route);
+	g_mutex_clear(&response->lock);
+	free(response);
+}
+
 /*
  * Route module
  */
@@ -55,18 +366,17 @@ int route_clone(route_h * cloned_route, route_h origin)
 	ROUTE_NULL_ARG_CHECK(origin);
 
 	route_s *handle = (route_s *) origin;
-	route_s *cloned = (route_s *) malloc(sizeof(route_s));
-	if (cloned == NULL) {
-		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
-	}
 
-	cloned->route = location_route_copy(handle->route);
-	if (cloned->route == NULL) {
-		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_SERVICE_NOT_AVAILABLE);
+	/* Route handles are read-only, so they are shared rather than copied. */
+	if (handle->response) {
+		int ret = route_retain(origin);
+		if (ret != ROUTE_ERROR_NONE) {
+			return ret;
+		}
+	} else {
+		g_atomic_int_inc(&handle->ref_count);
 	}
-	cloned->request_id = handle->request_id;
-
-	*cloned_route = (route_h) cloned;
+	*cloned_route = origin;
 
 	return ROUTE_ERROR_NONE;
 }
@@ -76,7 +386,23 @@ int route_destroy(route_h route)
 	ROUTE_NULL_ARG_CHECK(route);
 
 	route_s *handle = (route_s *) route;
-	location_route_free(handle->route);
+	if (handle->response) {
+		return route_release(route);
+	}
+	if (!g_atomic_int_dec_and_test(&handle->ref_count)) {
+		return ROUTE_ERROR_NONE;
+	}
+
+	if (handle->route) {
+		location_route_free(handle->route);
+	}
+	if (handle->record) {
+		route_store_map_unref(handle->record->map);
+	}
+	free(handle->polyline);
+	route_locator_free(handle->locator);
+	route_timing_free(handle->timing);
+	route_bvh_free(handle->bvh);
 	handle->request_id = 0;
 	free(handle);
 	handle = NULL;
@@ -84,6 +410,33 @@ int route_destroy(route_h route)
 	return ROUTE_ERROR_NONE;
 }
 
+int route_retain(route_h route)
+{
+	ROUTE_NULL_ARG_CHECK(route);
+
+	route_s *handle = (route_s *) route;
+	ROUTE_CHECK_CONDITION(handle->response != NULL, ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+
+	if (!__response_adopt(handle->response)) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	g_atomic_int_inc(&handle->response->ref_count);
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_release(route_h route)
+{
+	ROUTE_NULL_ARG_CHECK(route);
+
+	route_s *handle = (route_s *) route;
+	ROUTE_CHECK_CONDITION(handle->response != NULL, ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+
+	route_response_unref(handle->response);
+
+	return ROUTE_ERROR_NONE;
+}
+
 int route_get_request_id(route_h route, int *id)
 {
 	ROUTE_NULL_ARG_CHECK(route);
@@ -101,7 +454,7 @@ int route_get_origin(route_h route, location_coords_s * origin)
 	ROUTE_NULL_ARG_CHECK(origin);
 
 	route_s *handle = (route_s *) route;
-	LocationPosition *start = location_route_get_origin(handle->route);
+	LocationPosition *start = handle->record ? handle->record->item.start : location_route_get_origin(handle->route);
 	if (start == NULL) {
 		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
 	}
@@ -118,7 +471,7 @@ int route_get_destination(route_h route, location_coords_s * destination)
 	ROUTE_NULL_ARG_CHECK(destination);
 
 	route_s *handle = (route_s *) route;
-	LocationPosition *end = location_route_get_destination(handle->route);
+	LocationPosition *end = handle->record ? handle->record->item.end : location_route_get_destination(handle->route);
 	if (end == NULL) {
 		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
 	}
@@ -136,7 +489,7 @@ int route_get_geometry_bounding_box(route_h route, location_coords_s * top_left,
 	ROUTE_NULL_ARG_CHECK(bottom_right);
 
 	route_s *handle = (route_s *) route;
-	LocationBoundary *bbox = location_route_get_bounding_box(handle->route);
+	LocationBoundary *bbox = handle->record ? handle->record->item.bbox : location_route_get_bounding_box(handle->route);
 	if (bbox == NULL) {
 		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
 	}
@@ -161,7 +514,7 @@ int route_get_distance_unit(route_h route, route_distance_unit_e * unit)
 	char *MI = "MI";
 
 	route_s *handle = (route_s *) route;
-	char *dist_unit = (char *)location_route_get_distance_unit(handle->route);
+	char *dist_unit = (char *)(handle->record ? handle->record->item.distance_unit : location_route_get_distance_unit(handle->route));
 	if (dist_unit == NULL) {
 		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_SERVICE_NOT_AVAILABLE);
 	}
@@ -187,7 +540,7 @@ int route_get_total_distance(route_h route, double *distance)
 	ROUTE_NULL_ARG_CHECK(distance);
 
 	route_s *handle = (route_s *) route;
-	double dist = (double)location_route_get_total_distance(handle->route);
+	double dist = handle->record ? handle->record->item.distance : (double)location_route_get_total_distance(handle->route);
 
 	*distance = dist;
 
@@ -200,7 +553,7 @@ int route_get_total_duration(route_h route, long *duration)
 	ROUTE_NULL_ARG_CHECK(duration);
 
 	route_s *handle = (route_s *) route;
-	long dur = (long)location_route_get_total_duration(handle->route);
+	long dur = handle->record ? handle->record->item.duration : (long)location_route_get_total_duration(handle->route);
 
 	*duration = dur;
 
@@ -213,6 +566,11 @@ int route_foreach_properties(route_h route, route_property_cb callback, void *us
 	ROUTE_NULL_ARG_CHECK(callback);
 
 	route_s *handle = (route_s *) route;
+	if (handle->record) {
+		__view_foreach_properties(&handle->record->item, callback, user_data);
+		return ROUTE_ERROR_NONE;
+	}
+
 	GList *key_list = location_route_get_property_key(handle->route);
 
 	while (key_list) {
@@ -235,23 +593,132 @@ int route_foreach_segments(route_h route, route_segment_cb callback, void *user_
 	ROUTE_NULL_ARG_CHECK(callback);
 
 	route_s *handle = (route_s *) route;
-	GList *seg_list = location_route_get_route_segment(handle->route);
-
+	GList *seg_list = handle->record ? NULL : location_route_get_route_segment(handle->route);
+
+	/* The handle is only valid in the callback, so one on the stack serves every segment. */
+	route_segment_s segment;
+	segment.view = NULL;
+	segment.owner = handle;
+	segment.index = 0;
+	if (handle->record) {
+		route_view_s view = handle->record->item.children;
+		route_view_item_s item;
+
+		segment.segment = NULL;
+		segment.view = &item;
+		for (; segment.index < (int) handle->record->item.child_count && route_view_read_item(&view, ROUTE_VIEW_SEGMENT, &item); segment.index++) {
+			if (callback(&segment, user_data) == false) {
+				break;
+			}
+		}
+	}
 	while (seg_list) {
-		route_segment_s *segment = (route_segment_s *) malloc(sizeof(route_segment_s));
-		segment->segment = seg_list->data;
+		segment.segment = seg_list->data;
 
-		if (callback(segment, user_data) == false) {
-			free(segment);
+		if (callback(&segment, user_data) == false) {
 			break;
 		}
 		seg_list = seg_list->next;
-		free(segment);
+		segment.index++;
 	}
 
 	return ROUTE_ERROR_NONE;
 }
 
+int route_get_polyline(route_h route, const double **latitudes, const double **longitudes, int *count)
+{
+	ROUTE_NULL_ARG_CHECK(route);
+	ROUTE_NULL_ARG_CHECK(latitudes);
+	ROUTE_NULL_ARG_CHECK(longitudes);
+	ROUTE_NULL_ARG_CHECK(count);
+
+	route_polyline_s *polyline = route_polyline_get((route_s *) route);
+	if (polyline == NULL) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	if (polyline->count == 0) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
+	}
+
+	*latitudes = polyline->latitudes;
+	*longitudes = polyline->longitudes;
+	*count = polyline->count;
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_get_polyline_distances(route_h route, const double **distances, int *count)
+{
+	ROUTE_NULL_ARG_CHECK(route);
+	ROUTE_NULL_ARG_CHECK(distances);
+	ROUTE_NULL_ARG_CHECK(count);
+
+	route_polyline_s *polyline = route_polyline_get((route_s *) route);
+	if (polyline == NULL) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	if (polyline->count == 0) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
+	}
+
+	*distances = polyline->offsets;
+	*count = polyline->count;
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_get_position_at_distance(route_h route, double distance, location_coords_s * position, int *segment_index,
+				   int *step_index)
+{
+	ROUTE_NULL_ARG_CHECK(route);
+	ROUTE_NULL_ARG_CHECK(position);
+	ROUTE_NULL_ARG_CHECK(segment_index);
+	ROUTE_NULL_ARG_CHECK(step_index);
+
+	route_polyline_s *polyline = route_polyline_get((route_s *) route);
+	if (polyline == NULL) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	if (polyline->count == 0) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
+	}
+	ROUTE_CHECK_CONDITION(distance >= 0 && distance <= polyline->offsets[polyline->count - 1],
+			      ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+
+	if (polyline->count == 1) {
+		position->latitude = polyline->latitudes[0];
+		position->longitude = polyline->longitudes[0];
+		*segment_index = polyline->segment_indexes[0];
+		*step_index = polyline->step_indexes[0];
+		return ROUTE_ERROR_NONE;
+	}
+
+	/* The last edge starting at or before @distance */
+	int low = 0;
+	int high = polyline->count - 2;
+	while (low < high) {
+		int middle = (low + high + 1) / 2;
+		if (polyline->offsets[middle] <= distance) {
+			low = middle;
+		} else {
+			high = middle - 1;
+		}
+	}
+
+	double length = polyline->offsets[low + 1] - polyline->offsets[low];
+	double ratio = length > 0 ? (distance - polyline->offsets[low]) / length : 0;
+	position->latitude = polyline->latitudes[low] + (polyline->latitudes[low + 1] - polyline->latitudes[low]) * ratio;
+	position->longitude = polyline->longitudes[low] + (polyline->longitudes[low + 1] - polyline->longitudes[low]) * ratio;
+	/* An edge belongs to the step its end point comes from. */
+	*segment_index = polyline->segment_indexes[low + 1];
+	*step_index = polyline->step_indexes[low + 1];
+
+	return ROUTE_ERROR_NONE;
+}
+
 /*
  * Route segment module
  */
@@ -261,14 +728,26 @@ int route_segment_clone(route_segment_h * cloned_segment, route_segment_h origin
 	ROUTE_NULL_ARG_CHECK(origin);
 
 	route_segment_s *handle = (route_segment_s *) origin;
-	route_segment_s *cloned = (route_segment_s *) malloc(sizeof(route_segment_s));
+	/* The clone keeps the route it points into, and the item it is read from follows it in the same block. */
+	route_segment_s *cloned = (route_segment_s *) malloc(sizeof(route_segment_s) + (handle->view ? sizeof(route_view_item_s) : 0));
 	if (cloned == NULL) {
 		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
 	}
 
-	cloned->segment = location_route_segment_copy(handle->segment);
-	if (cloned->segment == NULL) {
-		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_SERVICE_NOT_AVAILABLE);
+	route_h owner;
+	int ret = route_clone(&owner, (route_h) handle->owner);
+	if (ret != ROUTE_ERROR_NONE) {
+		free(cloned);
+		return ret;
+	}
+
+	*cloned = *handle;
+	if (handle->view) {
+		cloned->view = (route_view_item_s *)(cloned + 1);
+		route_view_copy_item(cloned->view, handle->view);
+	} else if (handle->owner->response) {
+		/* The first retain moves the routes of a response under it, so the clone points into the one it keeps. */
+		cloned->segment = g_list_nth_data(location_route_get_route_segment(handle->owner->route), handle->index);
 	}
 
 	*cloned_segment = (route_segment_h) cloned;
@@ -281,7 +760,7 @@ int route_segment_destroy(route_segment_h segment)
 	ROUTE_NULL_ARG_CHECK(segment);
 
 	route_segment_s *handle = (route_segment_s *) segment;
-	location_route_segment_free(handle->segment);
+	route_destroy((route_h) handle->owner);
 	free(handle);
 	handle = NULL;
 
@@ -294,7 +773,7 @@ int route_segment_get_origin(route_segment_h segment, location_coords_s * origin
 	ROUTE_NULL_ARG_CHECK(origin);
 
 	route_segment_s *handle = (route_segment_s *) segment;
-	LocationPosition *start = location_route_segment_get_start_point(handle->segment);
+	LocationPosition *start = handle->view ? handle->view->start : location_route_segment_get_start_point(handle->segment);
 	if (start == NULL) {
 		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
 	}
@@ -311,7 +790,7 @@ int route_segment_get_destination(route_segment_h segment, location_coords_s * d
 	ROUTE_NULL_ARG_CHECK(destination);
 
 	route_segment_s *handle = (route_segment_s *) segment;
-	LocationPosition *end = location_route_segment_get_end_point(handle->segment);
+	LocationPosition *end = handle->view ? handle->view->end : location_route_segment_get_end_point(handle->segment);
 	if (end == NULL) {
 		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
 	}
@@ -330,7 +809,7 @@ int route_segment_get_geometry_bounding_box(route_segment_h segment,
 	ROUTE_NULL_ARG_CHECK(bottom_right);
 
 	route_segment_s *handle = (route_segment_s *) segment;
-	LocationBoundary *bbox = location_route_segment_get_bounding_box(handle->segment);
+	LocationBoundary *bbox = handle->view ? handle->view->bbox : location_route_segment_get_bounding_box(handle->segment);
 	if (bbox == NULL) {
 		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
 	}
@@ -349,7 +828,7 @@ int route_segment_get_distance(route_segment_h segment, double *distance)
 	ROUTE_NULL_ARG_CHECK(distance);
 
 	route_segment_s *handle = (route_segment_s *) segment;
-	double dist = (double)location_route_segment_get_distance(handle->segment);
+	double dist = handle->view ? handle->view->distance : (double)location_route_segment_get_distance(handle->segment);
 
 	*distance = dist;
 
@@ -362,7 +841,7 @@ int route_segment_get_duration(route_segment_h segment, long *duration)
 	ROUTE_NULL_ARG_CHECK(duration);
 
 	route_segment_s *handle = (route_segment_s *) segment;
-	long dur = (long)location_route_segment_get_duration(handle->segment);
+	long dur = handle->view ? handle->view->duration : (long)location_route_segment_get_duration(handle->segment);
 
 	*duration = dur;
 
@@ -375,6 +854,11 @@ int route_segment_foreach_properties(route_segment_h segment, route_segment_prop
 	ROUTE_NULL_ARG_CHECK(callback);
 
 	route_segment_s *handle = (route_segment_s *) segment;
+	if (handle->view) {
+		__view_foreach_properties(handle->view, callback, user_data);
+		return ROUTE_ERROR_NONE;
+	}
+
 	GList *key_list = location_route_segment_get_property_key(handle->segment);
 
 	while (key_list) {
@@ -397,18 +881,33 @@ int route_segment_foreach_steps(route_segment_h segment, route_segment_step_cb c
 	ROUTE_NULL_ARG_CHECK(callback);
 
 	route_segment_s *handle = (route_segment_s *) segment;
-	GList *step_list = location_route_segment_get_route_step(handle->segment);
-
+	GList *step_list = handle->view ? NULL : location_route_segment_get_route_step(handle->segment);
+
+	route_step_s step;
+	step.view = NULL;
+	step.owner = handle->owner;
+	step.segment_index = handle->index;
+	step.index = 0;
+	if (handle->view) {
+		route_view_s view = handle->view->children;
+		route_view_item_s item;
+
+		step.step = NULL;
+		step.view = &item;
+		for (; step.index < (int) handle->view->child_count && route_view_read_item(&view, ROUTE_VIEW_STEP, &item); step.index++) {
+			if (callback(&step, user_data) == false) {
+				break;
+			}
+		}
+	}
 	while (step_list) {
-		route_step_s *step = (route_step_s *) malloc(sizeof(route_step_s));
-		step->step = step_list->data;
+		step.step = step_list->data;
 
-		if (callback(step, user_data) == false) {
-			free(step);
+		if (callback(&step, user_data) == false) {
 			break;
 		}
 		step_list = step_list->next;
-		free(step);
+		step.index++;
 	}
 
 	return ROUTE_ERROR_NONE;
@@ -423,14 +922,27 @@ int route_step_clone(route_step_h * cloned_step, route_step_h origin)
 	ROUTE_NULL_ARG_CHECK(origin);
 
 	route_step_s *handle = (route_step_s *) origin;
-	route_step_s *cloned = (route_step_s *) malloc(sizeof(route_step_s));
+	/* The clone keeps the route it points into, and the item it is read from follows it in the same block. */
+	route_step_s *cloned = (route_step_s *) malloc(sizeof(route_step_s) + (handle->view ? sizeof(route_view_item_s) : 0));
 	if (cloned == NULL) {
 		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
 	}
 
-	cloned->step = location_route_step_copy(handle->step);
-	if (cloned->step == NULL) {
-		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_SERVICE_NOT_AVAILABLE);
+	route_h owner;
+	int ret = route_clone(&owner, (route_h) handle->owner);
+	if (ret != ROUTE_ERROR_NONE) {
+		free(cloned);
+		return ret;
+	}
+
+	*cloned = *handle;
+	if (handle->view) {
+		cloned->view = (route_view_item_s *)(cloned + 1);
+		route_view_copy_item(cloned->view, handle->view);
+	} else if (handle->owner->response) {
+		/* The first retain moves the routes of a response under it, so the clone points into the one it keeps. */
+		LocationRouteSegment *segment = g_list_nth_data(location_route_get_route_segment(handle->owner->route), handle->segment_index);
+		cloned->step = g_list_nth_data(location_route_segment_get_route_step(segment), handle->index);
 	}
 
 	*cloned_step = (route_step_h) cloned;
@@ -443,7 +955,7 @@ int route_step_destroy(route_step_h step)
 	ROUTE_NULL_ARG_CHECK(step);
 
 	route_step_s *handle = (route_step_s *) step;
-	location_route_step_free(handle->step);
+	route_destroy((route_h) handle->owner);
 	free(handle);
 	handle = NULL;
 
@@ -457,7 +969,7 @@ int route_step_get_origin(route_step_h step, location_coords_s * origin)
 	ROUTE_NULL_ARG_CHECK(origin);
 
 	route_step_s *handle = (route_step_s *) step;
-	LocationPosition *start = location_route_step_get_start_point(handle->step);
+	LocationPosition *start = handle->view ? handle->view->start : location_route_step_get_start_point(handle->step);
 	if (start == NULL) {
 		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
 	}
@@ -474,7 +986,7 @@ int route_step_get_destination(route_step_h step, location_coords_s * destinatio
 	ROUTE_NULL_ARG_CHECK(destination);
 
 	route_step_s *handle = (route_step_s *) step;
-	LocationPosition *end = location_route_step_get_end_point(handle->step);
+	LocationPosition *end = handle->view ? handle->view->end : location_route_step_get_end_point(handle->step);
 	if (end == NULL) {
 		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
 	}
@@ -492,7 +1004,7 @@ int route_step_get_geometry_bounding_box(route_step_h step, location_coords_s *
 	ROUTE_NULL_ARG_CHECK(bottom_right);
 
 	route_step_s *handle = (route_step_s *) step;
-	LocationBoundary *bbox = location_route_step_get_bounding_box(handle->step);
+	LocationBoundary *bbox = handle->view ? handle->view->bbox : location_route_step_get_bounding_box(handle->step);
 	if (bbox == NULL) {
 		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
 	}
@@ -511,7 +1023,7 @@ int route_step_get_distance(route_step_h step, double *distance)
 	ROUTE_NULL_ARG_CHECK(distance);
 
 	route_step_s *handle = (route_step_s *) step;
-	double dist = (double)location_route_step_get_distance(handle->step);
+	double dist = handle->view ? handle->view->distance : (double)location_route_step_get_distance(handle->step);
 
 	*distance = dist;
 
@@ -524,7 +1036,7 @@ int route_step_get_duration(route_step_h step, long *duration)
 	ROUTE_NULL_ARG_CHECK(duration);
 
 	route_step_s *handle = (route_step_s *) step;
-	long dur = (long)location_route_step_get_duration(handle->step);
+	long dur = handle->view ? handle->view->duration : (long)location_route_step_get_duration(handle->step);
 
 	*duration = dur;
 
@@ -537,7 +1049,7 @@ int route_step_get_transport_mode(route_step_h step, char** mode)
 	ROUTE_NULL_ARG_CHECK(mode);
 
 	route_step_s *handle = (route_step_s *) step;
-	char *transport = (char *)location_route_step_get_transport_mode(handle->step);
+	char *transport = (char *)(handle->view ? handle->view->transport_mode : location_route_step_get_transport_mode(handle->step));
 
 	if (transport == NULL) {
 		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
@@ -557,7 +1069,7 @@ int route_step_get_instruction(route_step_h step, char **instruction)
 	ROUTE_NULL_ARG_CHECK(instruction);
 
 	route_step_s *handle = (route_step_s *) step;
-	char *inst = (char *)location_route_step_get_instruction(handle->step);
+	char *inst = (char *)(handle->view ? handle->view->instruction : location_route_step_get_instruction(handle->step));
 
 	if (inst == NULL) {
 		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
@@ -577,21 +1089,35 @@ int route_step_foreach_geometries(route_step_h step, route_step_geometry_cb call
 	ROUTE_NULL_ARG_CHECK(callback);
 
 	route_step_s *handle = (route_step_s *) step;
-	GList *geometry_list = location_route_step_get_geometry(handle->step);
+	GList *geometry_list = handle->view ? NULL : location_route_step_get_geometry(handle->step);
+
+	location_coords_s geometry;
+	if (handle->view) {
+		route_view_s view = handle->view->children;
+		LocationPosition pos;
+		guint i;
 
+		for (i = 0; i < handle->view->child_count; i++) {
+			if (!route_view_read_position(&view, &pos)) {
+				continue;
+			}
+			geometry.latitude = pos.latitude;
+			geometry.longitude = pos.longitude;
+			if (callback(&geometry, user_data) == false) {
+				break;
+			}
+		}
+	}
 	while (geometry_list) {
-		location_coords_s *geometry = (location_coords_s *) malloc(sizeof(location_coords_s));;
 		LocationPosition *pos;
 		pos = geometry_list->data;
-		geometry->latitude = pos->latitude;
-		geometry->longitude = pos->longitude;
+		geometry.latitude = pos->latitude;
+		geometry.longitude = pos->longitude;
 
-		if (callback(geometry, user_data) == false) {
-			free(geometry);
+		if (callback(&geometry, user_data) == false) {
 			break;
 		}
 		geometry_list = geometry_list->next;
-		free(geometry);
 	}
 
 	return ROUTE_ERROR_NONE;
@@ -603,6 +1129,11 @@ int route_step_foreach_properties(route_step_h step, route_step_property_cb call
 	ROUTE_NULL_ARG_CHECK(callback);
 
 	route_step_s *handle = (route_step_s *) step;
+	if (handle->view) {
+		__view_foreach_properties(handle->view, callback, user_data);
+		return ROUTE_ERROR_NONE;
+	}
+
 	GList *key_list = location_route_step_get_property_key(handle->step);
 
 	while (key_list) {
@@ -0,0 +1,441 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <location/location.h>
+#include <location/location-types.h>
+#include <location/location-map-service.h>
+
+#include "route.h"
+#include "route_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_ROUTE"
+
+/*
+ * Internal macros
+ */
+#define ROUTE_CHECK_CONDITION(condition,error,msg)	\
+	if(condition) {} else	\
+	{ LOGE("[%s] %s(0x%08x)", __FUNCTION__, msg, error); return error; };	\
+
+#define ROUTE_PRINT_ERROR_CODE_RETURN(code)	\
+	LOGE("[%s] %s(0x%08x)", __FUNCTION__, #code, code); return code;	\
+
+#define ROUTE_NULL_ARG_CHECK(arg)\
+	ROUTE_CHECK_CONDITION( (arg != NULL), ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER")
+
+/* Steps per leaf of the hierarchy */
+#define ROUTE_BVH_LEAF_SIZE 4
+
+/*
+ * Internal implementation
+ */
+static void __box_empty(route_bvh_box_s *box)
+{
+	box->min_lat = box->min_lon = G_MAXDOUBLE;
+	box->max_lat = box->max_lon = -G_MAXDOUBLE;
+}
+
+static void __box_add_point(route_bvh_box_s *box, const LocationPosition *pos)
+{
+	if (pos == NULL) {
+		return;
+	}
+	box->min_lat = MIN(box->min_lat, pos->latitude);
+	box->max_lat = MAX(box->max_lat, pos->latitude);
+	box->min_lon = MIN(box->min_lon, pos->longitude);
+	box->max_lon = MAX(box->max_lon, pos->longitude);
+}
+
+static void __box_add_box(route_bvh_box_s *box, const route_bvh_box_s *other)
+{
+	box->min_lat = MIN(box->min_lat, other->min_lat);
+	box->max_lat = MAX(box->max_lat, other->max_lat);
+	box->min_lon = MIN(box->min_lon, other->min_lon);
+	box->max_lon = MAX(box->max_lon, other->max_lon);
+}
+
+/* The box given by the provider, or the one of the step geometry when there is none */
+static gboolean __step_box(LocationRouteStep *step, route_bvh_box_s *box)
+{
+	LocationBoundary *bbox = location_route_step_get_bounding_box(step);
+	GList *geometry_list;
+
+	__box_empty(box);
+	if (bbox && bbox->rect.left_top && bbox->rect.right_bottom) {
+		__box_add_point(box, bbox->rect.left_top);
+		__box_add_point(box, bbox->rect.right_bottom);
+		return TRUE;
+	}
+
+	for (geometry_list = location_route_step_get_geometry(step); geometry_list; geometry_list = geometry_list->next) {
+		__box_add_point(box, geometry_list->data);
+	}
+	__box_add_point(box, location_route_step_get_start_point(step));
+	__box_add_point(box, location_route_step_get_end_point(step));
+
+	return box->min_lat <= box->max_lat;
+}
+
+/* The same box for a step read in place */
+static gboolean __step_view_box(const route_view_item_s *step, route_bvh_box_s *box)
+{
+	route_view_s geometry_view = step->children;
+	LocationPosition pos;
+	guint i;
+
+	__box_empty(box);
+	if (step->bbox) {
+		__box_add_point(box, step->bbox->rect.left_top);
+		__box_add_point(box, step->bbox->rect.right_bottom);
+		return TRUE;
+	}
+
+	for (i = 0; i < step->child_count; i++) {
+		if (route_view_read_position(&geometry_view, &pos)) {
+			__box_add_point(box, &pos);
+		}
+	}
+	__box_add_point(box, step->start);
+	__box_add_point(box, step->end);
+
+	return box->min_lat <= box->max_lat;
+}
+
+static int __count_steps(LocationRoute *route)
+{
+	GList *seg_list;
+	int count = 0;
+
+	for (seg_list = location_route_get_route_segment(route); seg_list; seg_list = seg_list->next) {
+		count += g_list_length(location_route_segment_get_route_step(seg_list->data));
+	}
+
+	return count;
+}
+
+static int __fill_items(LocationRoute *route, route_bvh_item_s *items)
+{
+	GList *seg_list;
+	GList *step_list;
+	int segment_index = 0;
+	int count = 0;
+
+	for (seg_list = location_route_get_route_segment(route); seg_list; seg_list = seg_list->next, segment_index++) {
+		int step_index = 0;
+
+		step_list = location_route_segment_get_route_step(seg_list->data);
+		for (; step_list; step_list = step_list->next, step_index++) {
+			if (__step_box(step_list->data, &items[count].box)) {
+				items[count].segment_index = segment_index;
+				items[count].step_index = step_index;
+				count++;
+			}
+		}
+	}
+
+	return count;
+}
+
+static int __count_steps_view(const route_view_item_s *route)
+{
+	route_view_s seg_view = route->children;
+	route_view_item_s segment;
+	guint i;
+	int count = 0;
+
+	for (i = 0; i < route->child_count && route_view_read_item(&seg_view, ROUTE_VIEW_SEGMENT, &segment); i++) {
+		count += segment.child_count;
+	}
+
+	return count;
+}
+
+/* Also keeps where each step starts in @sources, to read it again for a query */
+static int __fill_items_view(const route_view_item_s *route, route_bvh_item_s *items, route_view_s *sources)
+{
+	route_view_s seg_view = route->children;
+	route_view_item_s segment;
+	route_view_item_s step;
+	int segment_index;
+	int step_index;
+	int count = 0;
+
+	for (segment_index = 0; segment_index < (int) route->child_count
+	     && route_view_read_item(&seg_view, ROUTE_VIEW_SEGMENT, &segment); segment_index++) {
+		route_view_s step_view = segment.children;
+
+		for (step_index = 0; step_index < (int) segment.child_count
+		     && route_view_read_item(&step_view, ROUTE_VIEW_STEP, &step); step_index++) {
+			if (__step_view_box(&step, &items[count].box)) {
+				items[count].segment_index = segment_index;
+				items[count].step_index = step_index;
+				sources[count] = step.source;
+				count++;
+			}
+		}
+	}
+
+	return count;
+}
+
+/*
+ * Steps come in route order, which already keeps neighbours close together, so the hierarchy halves ranges of
+ * steps rather than sorting them. Nodes are laid out depth first, a child right after its parent, and @skip is
+ * the node following the subtree, so that a query needs no stack. A node is a leaf when @skip is the next node.
+ */
+static void __build(route_bvh_s *bvh, int first, int count)
+{
+	int index = bvh->node_count++;
+	route_bvh_node_s *node = &bvh->nodes[index];
+	int i;
+
+	node->first = first;
+	node->count = count;
+	__box_empty(&node->box);
+	if (count <= ROUTE_BVH_LEAF_SIZE) {
+		for (i = first; i < first + count; i++) {
+			__box_add_box(&node->box, &bvh->items[i].box);
+		}
+	} else {
+		/* Leaves stay full, the right subtree takes the remainder */
+		int leaves = (count + ROUTE_BVH_LEAF_SIZE - 1) / ROUTE_BVH_LEAF_SIZE;
+		int left = (leaves / 2) * ROUTE_BVH_LEAF_SIZE;
+		int right_node;
+
+		__build(bvh, first, left);
+		right_node = bvh->node_count;
+		__build(bvh, first + left, count - left);
+		__box_add_box(&node->box, &bvh->nodes[index + 1].box);
+		__box_add_box(&node->box, &bvh->nodes[right_node].box);
+	}
+	node->skip = bvh->node_count;
+}
+
+/* A route read in place is walked as it is, rather than decoded whole */
+static route_bvh_s *__bvh_new(route_s *route)
+{
+	const route_view_item_s *view = route->record ? &route->record->item : NULL;
+	route_bvh_s *bvh;
+	int step_count = view ? __count_steps_view(view) : __count_steps(route->route);
+	int node_capacity = 2 * ((step_count + ROUTE_BVH_LEAF_SIZE - 1) / ROUTE_BVH_LEAF_SIZE);
+
+	bvh = (route_bvh_s *) malloc(sizeof(route_bvh_s) + step_count * sizeof(route_bvh_item_s) + node_capacity * sizeof(route_bvh_node_s)
+				     + (view ? step_count * sizeof(route_view_s) : 0));
+	if (bvh == NULL) {
+		return NULL;
+	}
+	bvh->items = (route_bvh_item_s *)(bvh + 1);
+	bvh->nodes = (route_bvh_node_s *)(bvh->items + step_count);
+	bvh->sources = view ? (route_view_s *)(bvh->nodes + node_capacity) : NULL;
+	bvh->item_count = view ? __fill_items_view(view, bvh->items, bvh->sources) : __fill_items(route->route, bvh->items);
+	bvh->node_count = 0;
+	bvh->steps = NULL;
+	if (bvh->item_count > 0) {
+		__build(bvh, 0, bvh->item_count);
+	}
+
+	return bvh;
+}
+
+/* A query box whose west edge is east of its east edge crosses the antimeridian. */
+static gboolean __overlaps(const route_bvh_box_s *box, double north, double west, double south, double east)
+{
+	if (box->min_lat > north || box->max_lat < south) {
+		return FALSE;
+	}
+	if (west <= east) {
+		return box->max_lon >= west && box->min_lon <= east;
+	}
+
+	return box->max_lon >= west || box->min_lon <= east;
+}
+
+route_bvh_s *route_bvh_get(route_s *route)
+{
+	route_bvh_s *bvh = g_atomic_pointer_get(&route->bvh);
+
+	if (bvh == NULL) {
+		bvh = __bvh_new(route);
+		if (bvh == NULL) {
+			return NULL;
+		}
+		bvh = route_publish_lazy((gpointer *) &route->bvh, bvh, (GDestroyNotify) route_bvh_free);
+	}
+
+	return bvh;
+}
+
+void route_bvh_free(route_bvh_s *bvh)
+{
+	route_bvh_steps_s *table;
+
+	if (bvh == NULL) {
+		return;
+	}
+	while (bvh->steps) {
+		table = bvh->steps;
+		bvh->steps = table->next;
+		free(table);
+	}
+	free(bvh);
+}
+
+/*
+ * Steps in bounds
+ */
+
+/*
+ * The items only keep indexes, since the steps move when route_retain() copies the route. They are resolved in a
+ * single walk over the route, as the items are in route order, and again only once the route has changed.
+ */
+static route_bvh_steps_s *__steps_new(route_bvh_s *bvh, LocationRoute *route)
+{
+	route_bvh_steps_s *table;
+	GList *seg_list = location_route_get_route_segment(route);
+	GList *step_list = seg_list ? location_route_segment_get_route_step(seg_list->data) : NULL;
+	int segment_index = 0;
+	int step_index = 0;
+	int i;
+
+	table = (route_bvh_steps_s *) malloc(sizeof(route_bvh_steps_s) + bvh->item_count * sizeof(LocationRouteStep *));
+	if (table == NULL) {
+		return NULL;
+	}
+	table->route = route;
+	table->next = NULL;
+	table->steps = (LocationRouteStep **)(table + 1);
+	for (i = 0; i < bvh->item_count; i++) {
+		const route_bvh_item_s *item = &bvh->items[i];
+
+		if (segment_index != item->segment_index) {
+			for (; seg_list && segment_index < item->segment_index; segment_index++) {
+				seg_list = seg_list->next;
+			}
+			step_list = seg_list ? location_route_segment_get_route_step(seg_list->data) : NULL;
+			step_index = 0;
+		}
+		for (; step_list && step_index < item->step_index; step_index++) {
+			step_list = step_list->next;
+		}
+		table->steps[i] = step_list ? step_list->data : NULL;
+	}
+
+	return table;
+}
+
+static route_bvh_steps_s *__bvh_steps(route_bvh_s *bvh, LocationRoute *route)
+{
+	route_bvh_steps_s *table = g_atomic_pointer_get(&bvh->steps);
+	route_bvh_steps_s *resolved;
+
+	while (table == NULL || table->route != route) {
+		resolved = __steps_new(bvh, route);
+		if (resolved == NULL) {
+			return NULL;
+		}
+		/* A query may still be reading the previous table, so it is only freed with the hierarchy. */
+		resolved->next = table;
+		if (g_atomic_pointer_compare_and_exchange(&bvh->steps, table, resolved)) {
+			return resolved;
+		}
+		free(resolved);
+		table = g_atomic_pointer_get(&bvh->steps);
+	}
+
+	return table;
+}
+
+int route_foreach_steps_in_bounds(route_h route, location_coords_s top_left, location_coords_s bottom_right,
+				  route_step_in_bounds_cb callback, void *user_data)
+{
+	ROUTE_NULL_ARG_CHECK(route);
+	ROUTE_NULL_ARG_CHECK(callback);
+	ROUTE_CHECK_CONDITION(top_left.latitude >= bottom_right.latitude, ROUTE_ERROR_INVALID_PARAMETER,
+			      "ROUTE_ERROR_INVALID_PARAMETER");
+
+	route_bvh_s *bvh = route_bvh_get((route_s *) route);
+	if (bvh == NULL) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	route_bvh_steps_s *table = NULL;
+	if (bvh->sources == NULL) {
+		table = __bvh_steps(bvh, ((route_s *) route)->route);
+		if (table == NULL) {
+			ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+		}
+	}
+
+	double north = top_left.latitude;
+	double west = top_left.longitude;
+	double south = bottom_right.latitude;
+	double east = bottom_right.longitude;
+	/* The handle is only valid in the callback, so one on the stack serves every step. */
+	route_step_s step;
+	route_view_item_s step_view;
+	route_view_s source;
+	int node = 0;
+	int i;
+
+	step.view = NULL;
+	step.owner = (route_s *) route;
+	while (node < bvh->node_count) {
+		const route_bvh_node_s *current = &bvh->nodes[node];
+
+		if (!__overlaps(&current->box, north, west, south, east)) {
+			node = current->skip;
+			continue;
+		}
+		if (current->skip == node + 1) {
+			for (i = current->first; i < current->first + current->count; i++) {
+				const route_bvh_item_s *item = &bvh->items[i];
+
+				if (!__overlaps(&item->box, north, west, south, east)) {
+					continue;
+				}
+				if (bvh->sources) {
+					source = bvh->sources[i];
+					step.step = NULL;
+					step.view = route_view_read_item(&source, ROUTE_VIEW_STEP, &step_view) ? &step_view : NULL;
+					if (step.view == NULL) {
+						continue;
+					}
+				} else {
+					step.step = table->steps[i];
+					if (step.step == NULL) {
+						continue;
+					}
+				}
+				step.segment_index = item->segment_index;
+				step.index = item->step_index;
+				if (callback(&step, item->segment_index, item->step_index, user_data) == false) {
+					return ROUTE_ERROR_NONE;
+				}
+			}
+		}
+		node++;
+	}
+
+	return ROUTE_ERROR_NONE;
+}
@@ -0,0 +1,389 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <location/location.h>
+#include <location/location-types.h>
+#include <location/location-map-service.h>
+
+#include "route_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_ROUTE"
+
+struct _route_cache_entry_s {
+	volatile gint ref_count;
+	gchar *key;
+	GList *routes;
+	gsize size;
+	gint64 expire_time;
+	GList lru_link;
+};
+
+struct _route_cache_s {
+	GMutex lock;
+	GHashTable *table;
+	GQueue lru;
+	gsize size;
+	gsize max_size;
+	gint64 ttl;
+	guint hits;
+	guint misses;
+};
+
+/*
+ * Internal implementation
+ */
+static void __free_route(gpointer data)
+{
+	LocationRoute *route = (LocationRoute *) data;
+	if (route) {
+		location_route_free(route);
+	}
+}
+
+static gsize __string_size(const gchar *str)
+{
+	return str ? strlen(str) + 1 : 0;
+}
+
+static gsize __geometry_size(GList *pos_list)
+{
+	return g_list_length(pos_list) * (sizeof(GList) + sizeof(LocationPosition));
+}
+
+static gsize __boundary_size(LocationBoundary *bbox)
+{
+	return bbox ? sizeof(LocationBoundary) + 2 * sizeof(LocationPosition) : 0;
+}
+
+static gsize __route_size(LocationRoute *route)
+{
+	gsize size = 1024 + __boundary_size(location_route_get_bounding_box(route));
+	GList *seg_list = location_route_get_route_segment(route);
+
+	while (seg_list) {
+		LocationRouteSegment *segment = seg_list->data;
+		GList *step_list = location_route_segment_get_route_step(segment);
+
+		size += 256 + __boundary_size(location_route_segment_get_bounding_box(segment));
+		while (step_list) {
+			LocationRouteStep *step = step_list->data;
+
+			size += 256 + __boundary_size(location_route_step_get_bounding_box(step));
+			size += __string_size(location_route_step_get_instruction(step));
+			size += __string_size(location_route_step_get_transport_mode(step));
+			size += __geometry_size(location_route_step_get_geometry(step));
+			step_list = step_list->next;
+		}
+		seg_list = seg_list->next;
+	}
+
+	return size;
+}
+
+static void __append_position(GString *str, const LocationPosition *pos)
+{
+	if (pos) {
+		g_string_append_printf(str, "%.6f,%.6f;", pos->latitude, pos->longitude);
+	} else {
+		g_string_append(str, "-;");
+	}
+}
+
+static void __append_boundary(GString *str, const LocationBoundary *bbox)
+{
+	GList *pos_list;
+
+	if (bbox == NULL) {
+		g_string_append(str, "-;");
+		return;
+	}
+
+	g_string_append_printf(str, "%d:", bbox->type);
+	switch (bbox->type) {
+	case LOCATION_BOUNDARY_RECT:
+		__append_position(str, bbox->rect.left_top);
+		__append_position(str, bbox->rect.right_bottom);
+		break;
+	case LOCATION_BOUNDARY_CIRCLE:
+		__append_position(str, bbox->circle.center);
+		g_string_append_printf(str, "%.3f;", bbox->circle.radius);
+		break;
+	case LOCATION_BOUNDARY_POLYGON:
+		for (pos_list = bbox->polygon.position_list; pos_list; pos_list = pos_list->next) {
+			__append_position(str, pos_list->data);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+static void __append_string_list(GString *str, GList *list)
+{
+	for (; list; list = list->next) {
+		g_string_append_printf(str, "%s;", list->data ? (gchar *) list->data : "");
+	}
+	g_string_append_c(str, '|');
+}
+
+static gchar *__preference_fingerprint(LocationRoutePreference *pref)
+{
+	GString *str = g_string_sized_new(256);
+	GList *list;
+	gchar *fingerprint;
+
+	if (pref) {
+		g_string_append_printf(str, "%s|%s|%u|%d%d%d%d%d|",
+				       location_route_pref_get_route_type(pref) ? location_route_pref_get_route_type(pref) : "",
+				       location_route_pref_get_transport_mode(pref) ? location_route_pref_get_transport_mode(pref) : "",
+				       location_route_pref_get_max_result(pref),
+				       location_route_pref_get_geometry_used(pref) ? 1 : 0,
+				       location_route_pref_get_instruction_bounding_box_used(pref) ? 1 : 0,
+				       location_route_pref_get_instruction_geometry_used(pref) ? 1 : 0,
+				       location_route_pref_get_instruction_used(pref) ? 1 : 0,
+				       location_route_pref_get_traffic_data_used(pref) ? 1 : 0);
+		__append_boundary(str, location_route_pref_get_bounding_box(pref));
+		__append_string_list(str, location_route_pref_get_freeformed_addr_to_avoid(pref));
+		__append_string_list(str, location_route_pref_get_feature_to_avoid(pref));
+		for (list = location_route_pref_get_area_to_avoid(pref); list; list = list->next) {
+			__append_boundary(str, list->data);
+		}
+		g_string_append_c(str, '|');
+		for (list = location_route_pref_get_property_key(pref); list; list = list->next) {
+			const gchar *value = location_route_pref_get_property(pref, list->data);
+			g_string_append_printf(str, "%s=%s;", (gchar *) list->data, value ? value : "");
+		}
+	}
+
+	fingerprint = g_compute_checksum_for_string(G_CHECKSUM_SHA1, str->str, str->len);
+	g_string_free(str, TRUE);
+
+	return fingerprint;
+}
+
+static void __entry_unlink(route_cache_s *cache, route_cache_entry_s *entry)
+{
+	g_queue_unlink(&cache->lru, &entry->lru_link);
+	cache->size -= entry->size;
+	g_hash_table_remove(cache->table, entry->key);
+}
+
+static void __evict(route_cache_s *cache)
+{
+	GList *link;
+
+	while (cache->size > cache->max_size && (link = g_queue_peek_tail_link(&cache->lru)) != NULL) {
+		__entry_unlink(cache, (route_cache_entry_s *) link->data);
+	}
+}
+
+static void __entry_release(gpointer data)
+{
+	route_cache_entry_unref((route_cache_entry_s *) data);
+}
+
+/*
+ * Route cache
+ */
+route_cache_s *route_cache_new(void)
+{
+	route_cache_s *cache = (route_cache_s *) malloc(sizeof(route_cache_s));
+	if (cache == NULL) {
+		return NULL;
+	}
+	memset(cache, 0, sizeof(route_cache_s));
+
+	g_mutex_init(&cache->lock);
+	g_queue_init(&cache->lru);
+	cache->table = g_hash_table_new_full(g_str_hash, g_str_equal, NULL, __entry_release);
+
+	return cache;
+}
+
+void route_cache_free(route_cache_s *cache)
+{
+	if (cache == NULL) {
+		return;
+	}
+
+	route_cache_clear(cache);
+	g_hash_table_destroy(cache->table);
+	g_mutex_clear(&cache->lock);
+	free(cache);
+}
+
+void route_cache_set_policy(route_cache_s *cache, int ttl, gsize max_size)
+{
+	g_mutex_lock(&cache->lock);
+	cache->ttl = (gint64) ttl * G_USEC_PER_SEC;
+	cache->max_size = max_size;
+	__evict(cache);
+	g_mutex_unlock(&cache->lock);
+}
+
+gboolean route_cache_is_enabled(route_cache_s *cache)
+{
+	return cache != NULL && cache->max_size > 0;
+}
+
+void route_cache_clear(route_cache_s *cache)
+{
+	g_mutex_lock(&cache->lock);
+	g_hash_table_remove_all(cache->table);
+	g_queue_init(&cache->lru);
+	cache->size = 0;
+	g_mutex_unlock(&cache->lock);
+}
+
+gchar *route_cache_build_key(location_coords_s origin, location_coords_s destination, location_coords_s *waypoint_list,
+			     int waypoint_num, LocationRoutePreference *pref)
+{
+	GString *key = g_string_sized_new(128);
+	gchar *fingerprint = __preference_fingerprint(pref);
+	int i;
+
+	g_string_append_printf(key, "%.6f,%.6f;%.6f,%.6f;", origin.latitude, origin.longitude, destination.latitude,
+			       destination.longitude);
+	for (i = 0; waypoint_list && i < waypoint_num; i++) {
+		g_string_append_printf(key, "%.6f,%.6f;", waypoint_list[i].latitude, waypoint_list[i].longitude);
+	}
+	g_string_append(key, fingerprint);
+	g_free(fingerprint);
+
+	return g_string_free(key, FALSE);
+}
+
+route_cache_entry_s *route_cache_lookup(route_cache_s *cache, const gchar *key)
+{
+	route_cache_entry_s *entry;
+
+	if (!route_cache_is_enabled(cache) || key == NULL) {
+		return NULL;
+	}
+
+	g_mutex_lock(&cache->lock);
+	entry = g_hash_table_lookup(cache->table, key);
+	if (entry && entry->expire_time && entry->expire_time <= g_get_monotonic_time()) {
+		__entry_unlink(cache, entry);
+		entry = NULL;
+	}
+	if (entry) {
+		g_queue_unlink(&cache->lru, &entry->lru_link);
+		g_queue_push_head_link(&cache->lru, &entry->lru_link);
+		g_atomic_int_inc(&entry->ref_count);
+		cache->hits++;
+	} else {
+		cache->misses++;
+	}
+	g_mutex_unlock(&cache->lock);
+
+	return entry;
+}
+
+void route_cache_get_statistics(route_cache_s *cache, guint *hits, guint *misses)
+{
+	g_mutex_lock(&cache->lock);
+	*hits = cache->hits;
+	*misses = cache->misses;
+	g_mutex_unlock(&cache->lock);
+}
+
+route_cache_entry_s *route_cache_insert(route_cache_s *cache, const gchar *key, GList *route_list)
+{
+	route_cache_entry_s *entry;
+	route_cache_entry_s *old;
+
+	if (!route_cache_is_enabled(cache) || key == NULL || route_list == NULL) {
+		return NULL;
+	}
+
+	entry = (route_cache_entry_s *) malloc(sizeof(route_cache_entry_s));
+	if (entry == NULL) {
+		return NULL;
+	}
+	memset(entry, 0, sizeof(route_cache_entry_s));
+
+	entry->ref_count = 1;
+	entry->key = g_strdup(key);
+	entry->size = sizeof(route_cache_entry_s) + strlen(key) + 1;
+	for (; route_list; route_list = route_list->next) {
+		LocationRoute *route = location_route_copy((LocationRoute *) route_list->data);
+		if (route == NULL) {
+			route_cache_entry_unref(entry);
+			return NULL;
+		}
+		entry->routes = g_list_append(entry->routes, route);
+		entry->size += __route_size(route);
+	}
+	entry->lru_link.data = entry;
+
+	g_mutex_lock(&cache->lock);
+	if (entry->size > cache->max_size) {
+		g_mutex_unlock(&cache->lock);
+		LOGD("[%s] result of %u bytes exceeds the cache budget", __FUNCTION__, (unsigned int)entry->size);
+		route_cache_entry_unref(entry);
+		return NULL;
+	}
+	if (cache->ttl > 0) {
+		entry->expire_time = g_get_monotonic_time() + cache->ttl;
+	}
+	old = g_hash_table_lookup(cache->table, key);
+	if (old) {
+		__entry_unlink(cache, old);
+	}
+	g_hash_table_insert(cache->table, entry->key, entry);
+	g_queue_push_head_link(&cache->lru, &entry->lru_link);
+	cache->size += entry->size;
+	/* The reference of the caller, taken before the entry can be evicted */
+	g_atomic_int_inc(&entry->ref_count);
+	__evict(cache);
+	g_mutex_unlock(&cache->lock);
+
+	return entry;
+}
+
+GList *route_cache_entry_get_routes(route_cache_entry_s *entry)
+{
+	return entry ? entry->routes : NULL;
+}
+
+route_cache_entry_s *route_cache_entry_ref(route_cache_entry_s *entry)
+{
+	if (entry) {
+		g_atomic_int_inc(&entry->ref_count);
+	}
+	return entry;
+}
+
+void route_cache_entry_unref(route_cache_entry_s *entry)
+{
+	if (entry == NULL || !g_atomic_int_dec_and_test(&entry->ref_count)) {
+		return;
+	}
+
+	g_list_free_full(entry->routes, __free_route);
+	g_free(entry->key);
+	free(entry);
+}
@@ -0,0 +1,376 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <location/location.h>
+#include <location/location-types.h>
+#include <location/location-map-service.h>
+
+#include "route.h"
+#include "route_geodesy.h"
+#include "route_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* The AVX2 path is built for that target alone and taken when the CPU has it, the rest keeps the baseline ISA */
+#if defined(__GNUC__) && defined(__x86_64__)
+#define ROUTE_GEODESY_AVX2
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_ROUTE"
+
+/*
+ * Internal macros
+ */
+#define ROUTE_CHECK_CONDITION(condition,error,msg)	\
+	if(condition) {} else	\
+	{ LOGE("[%s] %s(0x%08x)", __FUNCTION__, msg, error); return error; };	\
+
+#define ROUTE_PRINT_ERROR_CODE_RETURN(code)	\
+	LOGE("[%s] %s(0x%08x)", __FUNCTION__, #code, code); return code;	\
+
+#define ROUTE_NULL_ARG_CHECK(arg)\
+	ROUTE_CHECK_CONDITION( (arg != NULL), ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER")
+
+#define ROUTE_METHOD_CHECK(method)\
+	ROUTE_CHECK_CONDITION( (method >= ROUTE_GEODESY_METHOD_AUTO && method <= ROUTE_GEODESY_METHOD_VINCENTY),\
+			       ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER")
+
+#define ROUTE_GEODESY_EARTH_RADIUS 6371008.8
+#define ROUTE_GEODESY_METER_PER_DEGREE (ROUTE_GEODESY_EARTH_RADIUS * M_PI / 180.0)
+
+/* Below this many degrees apart, the equirectangular approximation is within a few millimeters of haversine */
+#define ROUTE_GEODESY_SHORT_DEGREES 0.1
+
+#define ROUTE_GEODESY_WGS84_A 6378137.0
+#define ROUTE_GEODESY_WGS84_F (1 / 298.257223563)
+#define ROUTE_GEODESY_VINCENTY_ITERATIONS 200
+
+/* Coordinates split into latitudes and longitudes at once by route_geodesy_get_coords_distances() */
+#define ROUTE_GEODESY_BLOCK 64
+
+/*
+ * Internal implementation
+ */
+
+/* Taylor series of the cosine up to x^16, within 1e-12 on [-pi/2, pi/2], so that it vectorizes as the scalar code */
+static inline double __cos_series(double x)
+{
+	double x2 = x * x;
+
+	return 1 + x2 * (-1.0 / 2 + x2 * (1.0 / 24 + x2 * (-1.0 / 720 + x2 * (1.0 / 40320 + x2 * (-1.0 / 3628800
+		+ x2 * (1.0 / 479001600 + x2 * (-1.0 / 87178291200 + x2 * (1.0 / 20922789888000))))))));
+}
+
+static inline double __wrap_longitude(double delta)
+{
+	return delta - 360.0 * nearbyint(delta / 360.0);
+}
+
+static double __equirectangular(double lat1, double lon1, double lat2, double lon2)
+{
+	double dlat = lat2 - lat1;
+	double x = __wrap_longitude(lon2 - lon1) * __cos_series((lat1 + lat2) * (M_PI / 360.0));
+
+	return ROUTE_GEODESY_METER_PER_DEGREE * sqrt(x * x + dlat * dlat);
+}
+
+static gboolean __is_short(double lat1, double lon1, double lat2, double lon2)
+{
+	return fabs(lat2 - lat1) <= ROUTE_GEODESY_SHORT_DEGREES && fabs(__wrap_longitude(lon2 - lon1)) <= ROUTE_GEODESY_SHORT_DEGREES;
+}
+
+double route_geodesy_haversine(double lat1, double lon1, double lat2, double lon2)
+{
+	double phi1 = lat1 * M_PI / 180.0;
+	double phi2 = lat2 * M_PI / 180.0;
+	double dphi = phi2 - phi1;
+	double dlambda = (lon2 - lon1) * M_PI / 180.0;
+	double a = sin(dphi / 2) * sin(dphi / 2) + cos(phi1) * cos(phi2) * sin(dlambda / 2) * sin(dlambda / 2);
+
+	return 2 * ROUTE_GEODESY_EARTH_RADIUS * asin(sqrt(a < 1.0 ? a : 1.0));
+}
+
+/* Inverse problem on the WGS84 ellipsoid. Nearly antipodal points, where it does not converge, fall back to haversine. */
+static double __vincenty(double lat1, double lon1, double lat2, double lon2)
+{
+	const double a = ROUTE_GEODESY_WGS84_A;
+	const double f = ROUTE_GEODESY_WGS84_F;
+	const double b = (1 - f) * a;
+	double L = __wrap_longitude(lon2 - lon1) * M_PI / 180.0;
+	double U1 = atan((1 - f) * tan(lat1 * M_PI / 180.0));
+	double U2 = atan((1 - f) * tan(lat2 * M_PI / 180.0));
+	double sinU1 = sin(U1), cosU1 = cos(U1);
+	double sinU2 = sin(U2), cosU2 = cos(U2);
+	double lambda = L;
+	double sin_sigma, cos_sigma, sigma, cos2_alpha, cos_2sigma_m;
+	int i;
+
+	for (i = 0; i < ROUTE_GEODESY_VINCENTY_ITERATIONS; i++) {
+		double sin_lambda = sin(lambda), cos_lambda = cos(lambda);
+		double p = cosU2 * sin_lambda;
+		double q = cosU1 * sinU2 - sinU1 * cosU2 * cos_lambda;
+		double sin_alpha, C, previous;
+
+		sin_sigma = sqrt(p * p + q * q);
+		if (sin_sigma == 0) {
+			return 0;
+		}
+		cos_sigma = sinU1 * sinU2 + cosU1 * cosU2 * cos_lambda;
+		sigma = atan2(sin_sigma, cos_sigma);
+		sin_alpha = cosU1 * cosU2 * sin_lambda / sin_sigma;
+		cos2_alpha = 1 - sin_alpha * sin_alpha;
+		cos_2sigma_m = cos2_alpha != 0 ? cos_sigma - 2 * sinU1 * sinU2 / cos2_alpha : 0;
+		C = f / 16 * cos2_alpha * (4 + f * (4 - 3 * cos2_alpha));
+		previous = lambda;
+		lambda = L + (1 - C) * f * sin_alpha
+			* (sigma + C * sin_sigma * (cos_2sigma_m + C * cos_sigma * (-1 + 2 * cos_2sigma_m * cos_2sigma_m)));
+		if (fabs(lambda - previous) < 1e-12) {
+			break;
+		}
+	}
+	if (i == ROUTE_GEODESY_VINCENTY_ITERATIONS) {
+		return route_geodesy_haversine(lat1, lon1, lat2, lon2);
+	}
+
+	double u2 = cos2_alpha * (a * a - b * b) / (b * b);
+	double A = 1 + u2 / 16384 * (4096 + u2 * (-768 + u2 * (320 - 175 * u2)));
+	double B = u2 / 1024 * (256 + u2 * (-128 + u2 * (74 - 47 * u2)));
+	double delta_sigma = B * sin_sigma * (cos_2sigma_m + B / 4 * (cos_sigma * (-1 + 2 * cos_2sigma_m * cos_2sigma_m)
+		- B / 6 * cos_2sigma_m * (-3 + 4 * sin_sigma * sin_sigma) * (-3 + 4 * cos_2sigma_m * cos_2sigma_m)));
+
+	return b * A * (sigma - delta_sigma);
+}
+
+double route_geodesy_distance(route_geodesy_method_e method, double lat1, double lon1, double lat2, double lon2)
+{
+	switch (method) {
+	case ROUTE_GEODESY_METHOD_EQUIRECTANGULAR:
+		return __equirectangular(lat1, lon1, lat2, lon2);
+	case ROUTE_GEODESY_METHOD_VINCENTY:
+		return __vincenty(lat1, lon1, lat2, lon2);
+	case ROUTE_GEODESY_METHOD_AUTO:
+		if (__is_short(lat1, lon1, lat2, lon2)) {
+			return __equirectangular(lat1, lon1, lat2, lon2);
+		}
+		return route_geodesy_haversine(lat1, lon1, lat2, lon2);
+	default:
+		return route_geodesy_haversine(lat1, lon1, lat2, lon2);
+	}
+}
+
+#if defined(ROUTE_GEODESY_AVX2)
+/* __equirectangular_batch() four pairs at a time, returns the first pair left for the scalar code */
+__attribute__((target("avx2")))
+static int __equirectangular_batch_avx2(const double *lat1, const double *lon1, const double *lat2, const double *lon2,
+					int count, gboolean auto_select, double *distances)
+{
+	const __m256d half_rad = _mm256_set1_pd(M_PI / 360.0);
+	const __m256d turn = _mm256_set1_pd(360.0), inv_turn = _mm256_set1_pd(1 / 360.0);
+	const __m256d scale = _mm256_set1_pd(ROUTE_GEODESY_METER_PER_DEGREE);
+	const __m256d sign = _mm256_set1_pd(-0.0);
+	const __m256d limit = _mm256_set1_pd(ROUTE_GEODESY_SHORT_DEGREES);
+	const __m256d c2 = _mm256_set1_pd(-1.0 / 2), c4 = _mm256_set1_pd(1.0 / 24), c6 = _mm256_set1_pd(-1.0 / 720);
+	const __m256d c8 = _mm256_set1_pd(1.0 / 40320), c10 = _mm256_set1_pd(-1.0 / 3628800), c12 = _mm256_set1_pd(1.0 / 479001600);
+	const __m256d c14 = _mm256_set1_pd(-1.0 / 87178291200), c16 = _mm256_set1_pd(1.0 / 20922789888000), one = _mm256_set1_pd(1);
+	int i = 0;
+
+	for (; i + 4 <= count; i += 4) {
+		__m256d la1 = _mm256_loadu_pd(lat1 + i), la2 = _mm256_loadu_pd(lat2 + i);
+		__m256d dlat = _mm256_sub_pd(la2, la1);
+		__m256d dlon = _mm256_sub_pd(_mm256_loadu_pd(lon2 + i), _mm256_loadu_pd(lon1 + i));
+		__m256d x = _mm256_mul_pd(_mm256_add_pd(la1, la2), half_rad);
+		__m256d x2 = _mm256_mul_pd(x, x);
+		__m256d c = _mm256_add_pd(c14, _mm256_mul_pd(x2, c16));
+
+		dlon = _mm256_sub_pd(dlon, _mm256_mul_pd(turn, _mm256_round_pd(_mm256_mul_pd(dlon, inv_turn), _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC)));
+		c = _mm256_add_pd(c12, _mm256_mul_pd(x2, c));
+		c = _mm256_add_pd(c10, _mm256_mul_pd(x2, c));
+		c = _mm256_add_pd(c8, _mm256_mul_pd(x2, c));
+		c = _mm256_add_pd(c6, _mm256_mul_pd(x2, c));
+		c = _mm256_add_pd(c4, _mm256_mul_pd(x2, c));
+		c = _mm256_add_pd(c2, _mm256_mul_pd(x2, c));
+		c = _mm256_add_pd(one, _mm256_mul_pd(x2, c));
+		x = _mm256_mul_pd(dlon, c);
+		_mm256_storeu_pd(distances + i, _mm256_mul_pd(scale, _mm256_sqrt_pd(_mm256_add_pd(_mm256_mul_pd(x, x), _mm256_mul_pd(dlat, dlat)))));
+
+		if (auto_select) {
+			__m256d far = _mm256_or_pd(_mm256_cmp_pd(_mm256_andnot_pd(sign, dlat), limit, _CMP_GT_OQ),
+						   _mm256_cmp_pd(_mm256_andnot_pd(sign, dlon), limit, _CMP_GT_OQ));
+			int mask = _mm256_movemask_pd(far);
+			int k;
+
+			for (k = 0; mask; k++, mask >>= 1) {
+				if (mask & 1) {
+					distances[i + k] = route_geodesy_haversine(lat1[i + k], lon1[i + k], lat2[i + k], lon2[i + k]);
+				}
+			}
+		}
+	}
+
+	return i;
+}
+#endif
+
+/*
+ * Computes the equirectangular distances of the pairs, several at a time. In auto mode, the pairs too far apart are
+ * computed again with haversine, which is rare along a route geometry.
+ */
+static void __equirectangular_batch(const double *lat1, const double *lon1, const double *lat2, const double *lon2, int count,
+				    gboolean auto_select, double *distances)
+{
+	int i = 0;
+
+#if defined(ROUTE_GEODESY_AVX2)
+	if (__builtin_cpu_supports("avx2")) {
+		i = __equirectangular_batch_avx2(lat1, lon1, lat2, lon2, count, auto_select, distances);
+	}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	const float64x2_t half_rad = vdupq_n_f64(M_PI / 360.0);
+	const float64x2_t turn = vdupq_n_f64(360.0), inv_turn = vdupq_n_f64(1 / 360.0);
+	const float64x2_t scale = vdupq_n_f64(ROUTE_GEODESY_METER_PER_DEGREE);
+	const float64x2_t limit = vdupq_n_f64(ROUTE_GEODESY_SHORT_DEGREES);
+	const float64x2_t c2 = vdupq_n_f64(-1.0 / 2), c4 = vdupq_n_f64(1.0 / 24), c6 = vdupq_n_f64(-1.0 / 720);
+	const float64x2_t c8 = vdupq_n_f64(1.0 / 40320), c10 = vdupq_n_f64(-1.0 / 3628800), c12 = vdupq_n_f64(1.0 / 479001600);
+	const float64x2_t c14 = vdupq_n_f64(-1.0 / 87178291200), c16 = vdupq_n_f64(1.0 / 20922789888000), one = vdupq_n_f64(1);
+
+	for (; i + 2 <= count; i += 2) {
+		float64x2_t la1 = vld1q_f64(lat1 + i), la2 = vld1q_f64(lat2 + i);
+		float64x2_t dlat = vsubq_f64(la2, la1);
+		float64x2_t dlon = vsubq_f64(vld1q_f64(lon2 + i), vld1q_f64(lon1 + i));
+		float64x2_t x = vmulq_f64(vaddq_f64(la1, la2), half_rad);
+		float64x2_t x2 = vmulq_f64(x, x);
+		float64x2_t c = vfmaq_f64(c14, x2, c16);
+
+		dlon = vfmsq_f64(dlon, turn, vrndnq_f64(vmulq_f64(dlon, inv_turn)));
+		c = vfmaq_f64(c12, x2, c);
+		c = vfmaq_f64(c10, x2, c);
+		c = vfmaq_f64(c8, x2, c);
+		c = vfmaq_f64(c6, x2, c);
+		c = vfmaq_f64(c4, x2, c);
+		c = vfmaq_f64(c2, x2, c);
+		c = vfmaq_f64(one, x2, c);
+		x = vmulq_f64(dlon, c);
+		vst1q_f64(distances + i, vmulq_f64(scale, vsqrtq_f64(vfmaq_f64(vmulq_f64(x, x), dlat, dlat))));
+
+		if (auto_select) {
+			uint64x2_t far = vorrq_u64(vcagtq_f64(dlat, limit), vcagtq_f64(dlon, limit));
+
+			if (vgetq_lane_u64(far, 0)) {
+				distances[i] = route_geodesy_haversine(lat1[i], lon1[i], lat2[i], lon2[i]);
+			}
+			if (vgetq_lane_u64(far, 1)) {
+				distances[i + 1] = route_geodesy_haversine(lat1[i + 1], lon1[i + 1], lat2[i + 1], lon2[i + 1]);
+			}
+		}
+	}
+#endif
+
+	for (; i < count; i++) {
+		if (auto_select && !__is_short(lat1[i], lon1[i], lat2[i], lon2[i])) {
+			distances[i] = route_geodesy_haversine(lat1[i], lon1[i], lat2[i], lon2[i]);
+		} else {
+			distances[i] = __equirectangular(lat1[i], lon1[i], lat2[i], lon2[i]);
+		}
+	}
+}
+
+void route_geodesy_distances(route_geodesy_method_e method, const double *lat1, const double *lon1, const double *lat2, const double *lon2,
+			     int count, double *distances)
+{
+	int i;
+
+	switch (method) {
+	case ROUTE_GEODESY_METHOD_AUTO:
+	case ROUTE_GEODESY_METHOD_EQUIRECTANGULAR:
+		__equirectangular_batch(lat1, lon1, lat2, lon2, count, method == ROUTE_GEODESY_METHOD_AUTO, distances);
+		break;
+	default:
+		for (i = 0; i < count; i++) {
+			distances[i] = route_geodesy_distance(method, lat1[i], lon1[i], lat2[i], lon2[i]);
+		}
+		break;
+	}
+}
+
+/*
+ * Geodesy
+ */
+int route_geodesy_get_distance(location_coords_s from, location_coords_s to, route_geodesy_method_e method, double *distance)
+{
+	ROUTE_NULL_ARG_CHECK(distance);
+	ROUTE_METHOD_CHECK(method);
+
+	*distance = route_geodesy_distance(method, from.latitude, from.longitude, to.latitude, to.longitude);
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_geodesy_get_distances(const double *from_latitudes, const double *from_longitudes, const double *to_latitudes,
+				const double *to_longitudes, int count, route_geodesy_method_e method, double *distances)
+{
+	ROUTE_NULL_ARG_CHECK(from_latitudes);
+	ROUTE_NULL_ARG_CHECK(from_longitudes);
+	ROUTE_NULL_ARG_CHECK(to_latitudes);
+	ROUTE_NULL_ARG_CHECK(to_longitudes);
+	ROUTE_NULL_ARG_CHECK(distances);
+	ROUTE_CHECK_CONDITION(count >= 0, ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+	ROUTE_METHOD_CHECK(method);
+
+	route_geodesy_distances(method, from_latitudes, from_longitudes, to_latitudes, to_longitudes, count, distances);
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_geodesy_get_coords_distances(const location_coords_s *from, const location_coords_s *to, int count, route_geodesy_method_e method,
+				       double *distances)
+{
+	ROUTE_NULL_ARG_CHECK(from);
+	ROUTE_NULL_ARG_CHECK(to);
+	ROUTE_NULL_ARG_CHECK(distances);
+	ROUTE_CHECK_CONDITION(count >= 0, ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+	ROUTE_METHOD_CHECK(method);
+
+	double lat1[ROUTE_GEODESY_BLOCK], lon1[ROUTE_GEODESY_BLOCK];
+	double lat2[ROUTE_GEODESY_BLOCK], lon2[ROUTE_GEODESY_BLOCK];
+	int first;
+	int i;
+
+	/* Split the coordinates block by block, so that the batch kernels load whole vectors */
+	for (first = 0; first < count; first += ROUTE_GEODESY_BLOCK) {
+		int n = count - first < ROUTE_GEODESY_BLOCK ? count - first : ROUTE_GEODESY_BLOCK;
+
+		for (i = 0; i < n; i++) {
+			lat1[i] = from[first + i].latitude;
+			lon1[i] = from[first + i].longitude;
+			lat2[i] = to[first + i].latitude;
+			lon2[i] = to[first + i].longitude;
+		}
+		route_geodesy_distances(method, lat1, lon1, lat2, lon2, n, distances + first);
+	}
+
+	return ROUTE_ERROR_NONE;
+}
@@ -0,0 +1,484 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <location/location.h>
+#include <location/location-types.h>
+#include <location/location-map-service.h>
+
+#include "route.h"
+#include "route_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <errno.h>
+#include <unistd.h>
+
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_ROUTE"
+
+/*
+ * Internal macros
+ */
+#define ROUTE_CHECK_CONDITION(condition,error,msg)	\
+	if(condition) {} else	\
+	{ LOGE("[%s] %s(0x%08x)", __FUNCTION__, msg, error); return error; };	\
+
+#define ROUTE_PRINT_ERROR_CODE_RETURN(code)	\
+	LOGE("[%s] %s(0x%08x)", __FUNCTION__, #code, code); return code;	\
+
+#define ROUTE_NULL_ARG_CHECK(arg)\
+	ROUTE_CHECK_CONDITION( (arg != NULL), ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER")
+
+/* Bytes written to a file descriptor at a time */
+#define ROUTE_GEOJSON_CHUNK_SIZE 4096
+
+/* Coordinates to about a centimeter, as in the encoded polylines of the highest precision */
+#define ROUTE_GEOJSON_COORDINATE_DECIMALS 7
+#define ROUTE_GEOJSON_DISTANCE_DECIMALS 3
+
+/* Beyond it, a number scaled to its decimals no longer fits in 64 bits */
+#define ROUTE_GEOJSON_FIXED_MAX 1e11
+
+/*
+ * Text goes through @buffer. When it is full, it is flushed to @fd, or, without one, the rest is only counted in
+ * @length, so that the caller learns the size it needs. Nothing else is allocated, whatever the size of the route.
+ * @first is set at the start of a list, whose first member or element then takes no comma.
+ */
+typedef struct {
+	char *buffer;
+	gsize size;
+	gsize used;
+	gsize length;
+	int fd;
+	gboolean failed;
+	gboolean first;
+} __writer;
+
+/* Step members written by the writer itself, which the properties of the provider do not override */
+static const char *__step_members[] = { "segment", "step", "distance", "duration", "instruction", "transport_mode" };
+
+/*
+ * Internal implementation
+ */
+static void __flush(__writer *writer)
+{
+	gsize offset = 0;
+
+	while (offset < writer->used && !writer->failed) {
+		ssize_t written = write(writer->fd, writer->buffer + offset, writer->used - offset);
+		if (written < 0 && errno == EINTR) {
+			continue;
+		}
+		if (written <= 0) {
+			writer->failed = TRUE;
+			break;
+		}
+		offset += written;
+	}
+	writer->used = 0;
+}
+
+static void __put(__writer *writer, const char *data, gsize length)
+{
+	writer->length += length;
+	while (length > 0 && !writer->failed) {
+		gsize room = writer->size - writer->used;
+		gsize n;
+
+		if (room == 0) {
+			if (writer->fd < 0) {
+				return;
+			}
+			__flush(writer);
+			continue;
+		}
+		n = MIN(room, length);
+		memcpy(writer->buffer + writer->used, data, n);
+		writer->used += n;
+		data += n;
+		length -= n;
+	}
+}
+
+static void __put_text(__writer *writer, const char *text)
+{
+	__put(writer, text, strlen(text));
+}
+
+/* Runs of plain characters are put at once, quotes, backslashes and control characters escaped. */
+static void __put_string(__writer *writer, const char *string)
+{
+	const char *run = string;
+	const char *c;
+	char escaped[8];
+
+	__put(writer, "\"", 1);
+	for (c = string; *c; c++) {
+		if (*c != '"' && *c != '\\' && (unsigned char) *c >= 0x20) {
+			continue;
+		}
+		__put(writer, run, c - run);
+		if (*c == '"' || *c == '\\') {
+			escaped[0] = '\\';
+			escaped[1] = *c;
+			__put(writer, escaped, 2);
+		} else {
+			snprintf(escaped, sizeof(escaped), "\\u%04x", (unsigned char) *c);
+			__put(writer, escaped, 6);
+		}
+		run = c + 1;
+	}
+	__put(writer, run, c - run);
+	__put(writer, "\"", 1);
+}
+
+/*
+ * JSON has no infinity nor NaN, and its numbers take a point whatever the locale. The digits are made by hand,
+ * as formatting them with printf takes most of the time of writing a route otherwise.
+ */
+static void __put_double(__writer *writer, double value, int decimals)
+{
+	static const double scales[] = { 1, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7 };
+	char text[G_ASCII_DTOSTR_BUF_SIZE];
+	char *end = text + sizeof(text);
+	char *c = end;
+	gint64 scaled;
+	guint64 magnitude;
+	int i;
+
+	if (!isfinite(value)) {
+		__put_text(writer, "null");
+		return;
+	}
+	if (fabs(value) >= ROUTE_GEOJSON_FIXED_MAX) {
+		__put_text(writer, g_ascii_dtostr(text, sizeof(text), value));
+		return;
+	}
+
+	scaled = llround(value * scales[decimals]);
+	magnitude = scaled < 0 ? -scaled : scaled;
+	for (i = 0; i < decimals; i++) {
+		*--c = '0' + magnitude % 10;
+		magnitude /= 10;
+	}
+	if (decimals > 0) {
+		*--c = '.';
+	}
+	do {
+		*--c = '0' + magnitude % 10;
+		magnitude /= 10;
+	} while (magnitude > 0);
+	if (scaled < 0) {
+		*--c = '-';
+	}
+	__put(writer, c, end - c);
+}
+
+static void __put_long(__writer *writer, long value)
+{
+	char text[24];
+
+	__put(writer, text, snprintf(text, sizeof(text), "%ld", value));
+}
+
+static void __put_separator(__writer *writer)
+{
+	if (!writer->first) {
+		__put(writer, ",", 1);
+	}
+	writer->first = FALSE;
+}
+
+static void __put_member(__writer *writer, const char *key)
+{
+	__put_separator(writer);
+	__put_string(writer, key);
+	__put(writer, ":", 1);
+}
+
+static void __put_property(__writer *writer, const char *key, const char *value, gboolean step)
+{
+	guint i;
+
+	if (key == NULL || value == NULL) {
+		return;
+	}
+	for (i = 0; step && i < G_N_ELEMENTS(__step_members); i++) {
+		if (strcmp(key, __step_members[i]) == 0) {
+			return;
+		}
+	}
+	__put_member(writer, key);
+	__put_string(writer, value);
+}
+
+/* A step of one point is a Point, one of none has a null geometry. */
+static void __begin_geometry(__writer *writer, guint count)
+{
+	if (count == 0) {
+		__put_text(writer, "null");
+	} else if (count == 1) {
+		__put_text(writer, "{\"type\":\"Point\",\"coordinates\":");
+	} else {
+		__put_text(writer, "{\"type\":\"LineString\",\"coordinates\":[");
+	}
+}
+
+static void __put_position(__writer *writer, const LocationPosition *pos, guint index)
+{
+	if (index > 0) {
+		__put(writer, ",", 1);
+	}
+	__put(writer, "[", 1);
+	__put_double(writer, pos->longitude, ROUTE_GEOJSON_COORDINATE_DECIMALS);
+	__put(writer, ",", 1);
+	__put_double(writer, pos->latitude, ROUTE_GEOJSON_COORDINATE_DECIMALS);
+	__put(writer, "]", 1);
+}
+
+static void __end_geometry(__writer *writer, guint count)
+{
+	if (count == 1) {
+		__put(writer, "}", 1);
+	} else if (count > 1) {
+		__put(writer, "]}", 2);
+	}
+}
+
+static void __begin_step(__writer *writer, int segment_index, int step_index, double distance, long duration,
+			 const char *instruction, const char *transport_mode)
+{
+	__put_separator(writer);
+	__put_text(writer, "{\"type\":\"Feature\",\"properties\":{\"segment\":");
+	__put_long(writer, segment_index);
+	__put_member(writer, "step");
+	__put_long(writer, step_index);
+	__put_member(writer, "distance");
+	__put_double(writer, distance, ROUTE_GEOJSON_DISTANCE_DECIMALS);
+	__put_member(writer, "duration");
+	__put_long(writer, duration);
+	if (instruction) {
+		__put_member(writer, "instruction");
+		__put_string(writer, instruction);
+	}
+	if (transport_mode) {
+		__put_member(writer, "transport_mode");
+		__put_string(writer, transport_mode);
+	}
+}
+
+static void __begin_route(__writer *writer, int request_id, double distance, long duration, const char *distance_unit)
+{
+	__put_text(writer, "{\"type\":\"FeatureCollection\",\"request_id\":");
+	__put_long(writer, request_id);
+	__put_member(writer, "distance");
+	__put_double(writer, distance, ROUTE_GEOJSON_DISTANCE_DECIMALS);
+	__put_member(writer, "duration");
+	__put_long(writer, duration);
+	if (distance_unit) {
+		__put_member(writer, "distance_unit");
+		__put_string(writer, distance_unit);
+	}
+	__put_text(writer, ",\"properties\":{");
+	writer->first = TRUE;
+}
+
+static void __write_step(__writer *writer, LocationRouteStep *step, int segment_index, int step_index)
+{
+	GList *list;
+	const LocationPosition *ends[2];
+	guint count = 0;
+	guint i;
+
+	__begin_step(writer, segment_index, step_index, location_route_step_get_distance(step), location_route_step_get_duration(step),
+		     location_route_step_get_instruction(step), location_route_step_get_transport_mode(step));
+	for (list = location_route_step_get_property_key(step); list; list = list->next) {
+		__put_property(writer, list->data, list->data ? location_route_step_get_property(step, list->data) : NULL, TRUE);
+	}
+	__put_text(writer, "},\"geometry\":");
+
+	list = location_route_step_get_geometry(step);
+	if (list) {
+		count = g_list_length(list);
+		__begin_geometry(writer, count);
+		for (i = 0; list; list = list->next, i++) {
+			__put_position(writer, list->data, i);
+		}
+	} else {
+		/* A step without geometry goes from its start to its end, as in its encoded polyline */
+		if ((ends[count] = location_route_step_get_start_point(step)) != NULL) {
+			count++;
+		}
+		if ((ends[count] = location_route_step_get_end_point(step)) != NULL) {
+			count++;
+		}
+		__begin_geometry(writer, count);
+		for (i = 0; i < count; i++) {
+			__put_position(writer, ends[i], i);
+		}
+	}
+	__end_geometry(writer, count);
+	__put(writer, "}", 1);
+}
+
+static void __write_route(__writer *writer, LocationRoute *route, int request_id)
+{
+	GList *list;
+	GList *step_list;
+	int segment_index;
+	int step_index;
+
+	__begin_route(writer, request_id, location_route_get_total_distance(route), location_route_get_total_duration(route),
+		      location_route_get_distance_unit(route));
+	for (list = location_route_get_property_key(route); list; list = list->next) {
+		__put_property(writer, list->data, list->data ? location_route_get_property(route, list->data) : NULL, FALSE);
+	}
+	__put_text(writer, "},\"features\":[");
+	writer->first = TRUE;
+
+	for (list = location_route_get_route_segment(route), segment_index = 0; list; list = list->next, segment_index++) {
+		step_list = location_route_segment_get_route_step(list->data);
+		for (step_index = 0; step_list; step_list = step_list->next, step_index++) {
+			__write_step(writer, step_list->data, segment_index, step_index);
+		}
+	}
+	__put(writer, "]}", 2);
+}
+
+static void __write_view_step(__writer *writer, const route_view_item_s *step, int segment_index, int step_index)
+{
+	route_view_s view = step->properties;
+	LocationPosition pos;
+	const gchar *key;
+	const gchar *value;
+	guint count = 0;
+	guint i;
+
+	__begin_step(writer, segment_index, step_index, step->distance, step->duration, step->instruction, step->transport_mode);
+	for (i = 0; i < step->property_count; i++) {
+		route_view_read_property(&view, &key, &value);
+		__put_property(writer, key, value, TRUE);
+	}
+	__put_text(writer, "},\"geometry\":");
+
+	if (step->child_count > 0) {
+		count = step->child_count;
+		view = step->children;
+		__begin_geometry(writer, count);
+		for (i = 0; i < count; i++) {
+			if (route_view_read_position(&view, &pos)) {
+				__put_position(writer, &pos, i);
+			}
+		}
+	} else {
+		count = (step->start != NULL) + (step->end != NULL);
+		__begin_geometry(writer, count);
+		if (step->start) {
+			__put_position(writer, step->start, 0);
+		}
+		if (step->end) {
+			__put_position(writer, step->end, step->start != NULL);
+		}
+	}
+	__end_geometry(writer, count);
+	__put(writer, "}", 1);
+}
+
+static void __write_view_route(__writer *writer, const route_view_item_s *route)
+{
+	route_view_s view = route->properties;
+	route_view_s segment_view = route->children;
+	route_view_s step_view;
+	route_view_item_s segment;
+	route_view_item_s step;
+	const gchar *key;
+	const gchar *value;
+	guint i;
+	guint j;
+
+	__begin_route(writer, route->request_id, route->distance, route->duration, route->distance_unit);
+	for (i = 0; i < route->property_count; i++) {
+		route_view_read_property(&view, &key, &value);
+		__put_property(writer, key, value, FALSE);
+	}
+	__put_text(writer, "},\"features\":[");
+	writer->first = TRUE;
+
+	for (i = 0; i < route->child_count && route_view_read_item(&segment_view, ROUTE_VIEW_SEGMENT, &segment); i++) {
+		step_view = segment.children;
+		for (j = 0; j < segment.child_count && route_view_read_item(&step_view, ROUTE_VIEW_STEP, &step); j++) {
+			__write_view_step(writer, &step, i, j);
+		}
+	}
+	__put(writer, "]}", 2);
+}
+
+static void __write(__writer *writer, route_s *route)
+{
+	if (route->record) {
+		__write_view_route(writer, &route->record->item);
+	} else {
+		__write_route(writer, route->route, route->request_id);
+	}
+}
+
+/*
+ * GeoJSON
+ */
+int route_write_geojson(route_h route, char *buffer, int size, int *length)
+{
+	ROUTE_NULL_ARG_CHECK(route);
+	ROUTE_NULL_ARG_CHECK(length);
+	ROUTE_CHECK_CONDITION(size >= 0 && (buffer != NULL || size == 0), ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+
+	/* The last byte is kept for the terminating null character */
+	__writer writer = { buffer, size > 0 ? size - 1 : 0, 0, 0, -1, FALSE, FALSE };
+
+	__write(&writer, (route_s *) route);
+	if (size > 0) {
+		buffer[writer.used] = '\0';
+	}
+	if (writer.length > G_MAXINT) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	*length = writer.length;
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_write_geojson_to_fd(route_h route, int fd)
+{
+	ROUTE_NULL_ARG_CHECK(route);
+	ROUTE_CHECK_CONDITION(fd >= 0, ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+
+	char chunk[ROUTE_GEOJSON_CHUNK_SIZE];
+	__writer writer = { chunk, sizeof(chunk), 0, 0, fd, FALSE, FALSE };
+
+	__write(&writer, (route_s *) route);
+	__flush(&writer);
+	if (writer.failed) {
+		LOGE("[%s] Fail to write to %d", __FUNCTION__, fd);
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_SERVICE_NOT_AVAILABLE);
+	}
+
+	return ROUTE_ERROR_NONE;
+}
@@ -0,0 +1,768 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <location/location.h>
+#include <location/location-types.h>
+#include <location/location-map-service.h>
+
+#include "route_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_ROUTE"
+
+#define ROUTE_GRAPH_EARTH_RADIUS 6371008.8
+#define ROUTE_GRAPH_METER_PER_DEGREE (ROUTE_GRAPH_EARTH_RADIUS * M_PI / 180.0)
+#define ROUTE_GRAPH_MAX_INDEX 0x7fffffffU
+#define ROUTE_GRAPH_TURN_THRESHOLD 30.0
+#define ROUTE_GRAPH_UTURN_THRESHOLD 150.0
+
+typedef struct {
+	double min_lat;
+	double min_lon;
+	double max_lat;
+	double max_lon;
+} __bounds;
+
+/*
+ * Internal implementation
+ */
+/*
+ * A section which does not fit in the file fails every following one too, so that checking the last section
+ * before reading a sentinel covers all the sections read so far.
+ */
+static const void *__section(route_graph_s *graph, gsize *offset, guint64 count, gsize size)
+{
+	const void *section;
+
+	if (*offset > graph->data_size || count > (graph->data_size - *offset) / size) {
+		*offset = G_MAXSIZE;
+		return NULL;
+	}
+	section = graph->data + *offset;
+	*offset += count * size;
+
+	return section;
+}
+
+static gboolean __load_ch(route_graph_s *graph, gsize offset)
+{
+	const route_graph_ch_header_s *header;
+	guint32 n = graph->node_count;
+
+	header = __section(graph, &offset, 1, sizeof(route_graph_ch_header_s));
+	if (header == NULL || memcmp(header->magic, ROUTE_GRAPH_CH_MAGIC, 4) != 0
+	    || header->metric > ROUTE_GRAPH_METRIC_DISTANCE || header->arc_count > ROUTE_GRAPH_MAX_INDEX) {
+		return FALSE;
+	}
+
+	graph->ch_metric = header->metric;
+	graph->arc_count = header->arc_count;
+	graph->rank = __section(graph, &offset, n, sizeof(guint32));
+	graph->arc_source = __section(graph, &offset, graph->arc_count, sizeof(guint32));
+	graph->arc_target = __section(graph, &offset, graph->arc_count, sizeof(guint32));
+	graph->arc_weight = __section(graph, &offset, graph->arc_count, sizeof(float));
+	graph->arc_first = __section(graph, &offset, graph->arc_count, sizeof(guint32));
+	graph->arc_second = __section(graph, &offset, graph->arc_count, sizeof(guint32));
+	graph->up_first = __section(graph, &offset, (guint64) n + 1, sizeof(guint32));
+	if (graph->up_first == NULL || graph->up_first[n] > graph->arc_count) {
+		return FALSE;
+	}
+	graph->up_arc = __section(graph, &offset, graph->up_first[n], sizeof(guint32));
+	graph->down_first = __section(graph, &offset, (guint64) n + 1, sizeof(guint32));
+	if (graph->up_arc == NULL || graph->down_first == NULL || graph->down_first[n] > graph->arc_count) {
+		return FALSE;
+	}
+	graph->down_arc = __section(graph, &offset, graph->down_first[n], sizeof(guint32));
+
+	return graph->down_arc != NULL;
+}
+
+static void __bounds_init(__bounds *bounds)
+{
+	bounds->min_lat = 90;
+	bounds->min_lon = 180;
+	bounds->max_lat = -90;
+	bounds->max_lon = -180;
+}
+
+static void __bounds_extend(__bounds *bounds, double latitude, double longitude)
+{
+	bounds->min_lat = MIN(bounds->min_lat, latitude);
+	bounds->min_lon = MIN(bounds->min_lon, longitude);
+	bounds->max_lat = MAX(bounds->max_lat, latitude);
+	bounds->max_lon = MAX(bounds->max_lon, longitude);
+}
+
+static void __bounds_merge(__bounds *bounds, const __bounds *other)
+{
+	__bounds_extend(bounds, other->min_lat, other->min_lon);
+	__bounds_extend(bounds, other->max_lat, other->max_lon);
+}
+
+static LocationBoundary *__bounds_new_boundary(const __bounds *bounds)
+{
+	LocationBoundary *bbox;
+	LocationPosition *left_top = location_position_new(0, bounds->max_lat, bounds->min_lon, 0, LOCATION_STATUS_2D_FIX);
+	LocationPosition *right_bottom = location_position_new(0, bounds->min_lat, bounds->max_lon, 0, LOCATION_STATUS_2D_FIX);
+
+	bbox = location_boundary_new_for_rect(left_top, right_bottom);
+	location_position_free(left_top);
+	location_position_free(right_bottom);
+
+	return bbox;
+}
+
+static guint32 __edge_point_count(route_graph_s *graph, guint32 edge)
+{
+	return graph->geometry_first[edge + 1] - graph->geometry_first[edge] + 2;
+}
+
+/* Gets the @index th point of the polyline of @edge, from its source node to its target node */
+static void __edge_point(route_graph_s *graph, guint32 edge, guint32 index, double *latitude, double *longitude)
+{
+	guint32 count = __edge_point_count(graph, edge);
+
+	if (index == 0) {
+		*latitude = ROUTE_GRAPH_LAT(graph, graph->edge_source[edge]);
+		*longitude = ROUTE_GRAPH_LON(graph, graph->edge_source[edge]);
+	} else if (index == count - 1) {
+		*latitude = ROUTE_GRAPH_LAT(graph, graph->edge_target[edge]);
+		*longitude = ROUTE_GRAPH_LON(graph, graph->edge_target[edge]);
+	} else {
+		guint32 shape = graph->geometry_first[edge] + index - 1;
+		*latitude = graph->shape_lat[shape] / 1000000.0;
+		*longitude = graph->shape_lon[shape] / 1000000.0;
+	}
+}
+
+static double __edge_length(route_graph_s *graph, guint32 edge)
+{
+	guint32 count = __edge_point_count(graph, edge);
+	double length = 0;
+	double lat1, lon1, lat2, lon2;
+	guint32 i;
+
+	__edge_point(graph, edge, 0, &lat1, &lon1);
+	for (i = 1; i < count; i++) {
+		__edge_point(graph, edge, i, &lat2, &lon2);
+		length += route_graph_distance(lat1, lon1, lat2, lon2);
+		lat1 = lat2;
+		lon1 = lon2;
+	}
+
+	return length;
+}
+
+/* Bearing of the edge where it leaves its source (@at_end FALSE) or enters its target (@at_end TRUE) */
+static double __edge_bearing(route_graph_s *graph, guint32 edge, gboolean at_end)
+{
+	guint32 count = __edge_point_count(graph, edge);
+	double lat1, lon1, lat2, lon2;
+
+	__edge_point(graph, edge, at_end ? count - 2 : 0, &lat1, &lon1);
+	__edge_point(graph, edge, at_end ? count - 1 : 1, &lat2, &lon2);
+
+	return route_graph_bearing(lat1, lon1, lat2, lon2);
+}
+
+/* Projects a point on the segment from (lat1, lon1) to (lat2, lon2) in a local equirectangular frame */
+static double __project(double latitude, double longitude, double lat1, double lon1, double lat2, double lon2,
+			double *ratio)
+{
+	double scale = cos(latitude * M_PI / 180.0);
+	double dx = (lon2 - lon1) * scale;
+	double dy = lat2 - lat1;
+	double px = (longitude - lon1) * scale;
+	double py = latitude - lat1;
+	double length = dx * dx + dy * dy;
+	double t = length > 0 ? (px * dx + py * dy) / length : 0;
+
+	t = t < 0 ? 0 : (t > 1 ? 1 : t);
+	*ratio = t;
+
+	return route_graph_distance(latitude, longitude, lat1 + (lat2 - lat1) * t, lon1 + (lon2 - lon1) * t);
+}
+
+static void __snap_edge(route_graph_s *graph, guint32 edge, double latitude, double longitude, route_graph_snap_s *snap)
+{
+	guint32 count = __edge_point_count(graph, edge);
+	double lat1, lon1, lat2, lon2;
+	double along = 0;
+	double best_along = 0;
+	double best = G_MAXDOUBLE;
+	double best_lat = 0;
+	double best_lon = 0;
+	guint32 i;
+
+	__edge_point(graph, edge, 0, &lat1, &lon1);
+	for (i = 1; i < count; i++) {
+		double ratio;
+		double distance;
+		double length;
+
+		__edge_point(graph, edge, i, &lat2, &lon2);
+		distance = __project(latitude, longitude, lat1, lon1, lat2, lon2, &ratio);
+		length = route_graph_distance(lat1, lon1, lat2, lon2);
+		if (distance < best) {
+			best = distance;
+			best_along = along + length * ratio;
+			best_lat = lat1 + (lat2 - lat1) * ratio;
+			best_lon = lon1 + (lon2 - lon1) * ratio;
+		}
+		along += length;
+		lat1 = lat2;
+		lon1 = lon2;
+	}
+
+	if (best < snap->distance) {
+		snap->edge = edge;
+		snap->fraction = along > 0 ? best_along / along : 0;
+		snap->latitude = best_lat;
+		snap->longitude = best_lon;
+		snap->distance = best;
+	}
+}
+
+static void __snap_cell(route_graph_s *graph, gint64 column, gint64 row, double latitude, double longitude,
+			route_graph_snap_s *snap)
+{
+	guint32 cell;
+	guint32 i;
+
+	if (column < 0 || row < 0 || column >= graph->grid_columns || row >= graph->grid_rows) {
+		return;
+	}
+
+	cell = (guint32) row * graph->grid_columns + (guint32) column;
+	for (i = graph->grid_first[cell]; i < graph->grid_first[cell + 1]; i++) {
+		__snap_edge(graph, graph->grid_edge[i], latitude, longitude, snap);
+	}
+}
+
+static LocationPosition *__new_position(double latitude, double longitude)
+{
+	return location_position_new(0, latitude, longitude, 0, LOCATION_STATUS_2D_FIX);
+}
+
+static void __free_position(gpointer data)
+{
+	location_position_free((LocationPosition *) data);
+}
+
+static void __free_step(gpointer data)
+{
+	location_route_step_free((LocationRouteStep *) data);
+}
+
+static void __free_segment(gpointer data)
+{
+	location_route_segment_free((LocationRouteSegment *) data);
+}
+
+/*
+ * Prepends the points of @edge between the fractions @from and @to of its length to @geometry,
+ * skipping the first one unless @with_first. @geometry may be NULL to only extend @bounds.
+ */
+static void __append_edge_geometry(route_graph_s *graph, guint32 edge, double from, double to, gboolean with_first,
+				   GList **geometry, __bounds *bounds)
+{
+	guint32 count = __edge_point_count(graph, edge);
+	double total = __edge_length(graph, edge);
+	double start = from * total;
+	double end = to * total;
+	double along = 0;
+	double lat1, lon1, lat2, lon2;
+	guint32 i;
+
+	__edge_point(graph, edge, 0, &lat1, &lon1);
+	for (i = 1; i < count; i++) {
+		double length;
+
+		__edge_point(graph, edge, i, &lat2, &lon2);
+		length = route_graph_distance(lat1, lon1, lat2, lon2);
+
+		if (with_first && along + length >= start) {
+			double t = length > 0 ? (start - along) / length : 0;
+			double lat = lat1 + (lat2 - lat1) * t;
+			double lon = lon1 + (lon2 - lon1) * t;
+
+			__bounds_extend(bounds, lat, lon);
+			if (geometry) {
+				*geometry = g_list_prepend(*geometry, __new_position(lat, lon));
+			}
+			with_first = FALSE;
+		}
+		if (along + length >= end) {
+			double t = length > 0 ? (end - along) / length : 1;
+			double lat = lat1 + (lat2 - lat1) * t;
+			double lon = lon1 + (lon2 - lon1) * t;
+
+			__bounds_extend(bounds, lat, lon);
+			if (geometry) {
+				*geometry = g_list_prepend(*geometry, __new_position(lat, lon));
+			}
+			return;
+		}
+		if (!with_first && along + length > start) {
+			__bounds_extend(bounds, lat2, lon2);
+			if (geometry) {
+				*geometry = g_list_prepend(*geometry, __new_position(lat2, lon2));
+			}
+		}
+		along += length;
+		lat1 = lat2;
+		lon1 = lon2;
+	}
+}
+
+static const gchar *__head_instruction(double bearing)
+{
+	static const gchar *instructions[] = {
+		"Head north", "Head northeast", "Head east", "Head southeast",
+		"Head south", "Head southwest", "Head west", "Head northwest",
+	};
+
+	return instructions[((int)floor((bearing + 22.5) / 45.0)) % 8];
+}
+
+static const gchar *__turn_instruction(double turn)
+{
+	if (fabs(turn) >= ROUTE_GRAPH_UTURN_THRESHOLD) {
+		return "Make a U-turn";
+	}
+	return turn < 0 ? "Turn left" : "Turn right";
+}
+
+static double __edge_from(const route_graph_path_s *path, guint i)
+{
+	return i == 0 ? path->start_fraction : 0;
+}
+
+static double __edge_to(const route_graph_path_s *path, guint i)
+{
+	return i == path->edges->len - 1 ? path->end_fraction : 1;
+}
+
+static LocationRouteStep *__new_step(route_graph_s *graph, const route_graph_path_s *path, guint first, guint last,
+				     const gchar *instruction, const route_graph_route_options_s *options)
+{
+	LocationRouteStep *step = location_route_step_new();
+	GList *geometry = NULL;
+	double distance = 0;
+	double duration = 0;
+	__bounds bounds;
+	guint i;
+
+	if (step == NULL) {
+		return NULL;
+	}
+
+	__bounds_init(&bounds);
+	for (i = first; i < last; i++) {
+		guint32 edge = g_array_index(path->edges, guint32, i);
+		double from = __edge_from(path, i);
+		double to = __edge_to(path, i);
+
+		distance += graph->edge_distance[edge] * (to - from);
+		duration += graph->edge_duration[edge] * (to - from);
+		__append_edge_geometry(graph, edge, from, to, i == first, &geometry, &bounds);
+	}
+	geometry = g_list_reverse(geometry);
+
+	location_route_step_set_start_point(step, g_list_first(geometry)->data);
+	location_route_step_set_end_point(step, g_list_last(geometry)->data);
+	if (options->step_geometry_used) {
+		location_route_step_set_geometry(step, geometry);
+	}
+	g_list_free_full(geometry, __free_position);
+
+	if (options->step_bounding_box_used) {
+		LocationBoundary *bbox = __bounds_new_boundary(&bounds);
+		location_route_step_set_bounding_box(step, bbox);
+		location_boundary_free(bbox);
+	}
+
+	location_route_step_set_distance(step, distance);
+	location_route_step_set_duration(step, (glong) lround(duration));
+	location_route_step_set_instruction(step, instruction);
+	location_route_step_set_transport_mode(step, options->transport_mode);
+
+	return step;
+}
+
+/* Splits the path into steps wherever the road turns more than ROUTE_GRAPH_TURN_THRESHOLD degrees */
+static GList *__new_steps(route_graph_s *graph, const route_graph_path_s *path, const route_graph_route_options_s *options)
+{
+	GList *step_list = NULL;
+	const gchar *instruction;
+	guint first = 0;
+	guint i;
+
+	if (path->edges->len == 0) {
+		return NULL;
+	}
+
+	instruction = __head_instruction(__edge_bearing(graph, g_array_index(path->edges, guint32, 0), FALSE));
+	for (i = 1; i <= path->edges->len; i++) {
+		double turn = 0;
+
+		if (i < path->edges->len) {
+			double bearing = __edge_bearing(graph, g_array_index(path->edges, guint32, i - 1), TRUE);
+			double next_bearing = __edge_bearing(graph, g_array_index(path->edges, guint32, i), FALSE);
+
+			turn = fmod(next_bearing - bearing + 540.0, 360.0) - 180.0;
+			if (fabs(turn) <= ROUTE_GRAPH_TURN_THRESHOLD) {
+				continue;
+			}
+		}
+
+		LocationRouteStep *step = __new_step(graph, path, first, i, instruction, options);
+		if (step) {
+			step_list = g_list_prepend(step_list, step);
+		}
+		instruction = __turn_instruction(turn);
+		first = i;
+	}
+
+	return g_list_reverse(step_list);
+}
+
+static LocationRouteSegment *__new_segment(route_graph_s *graph, const route_graph_path_s *path,
+					   const LocationPosition *start, const LocationPosition *end,
+					   const route_graph_route_options_s *options, __bounds *bounds, double *distance,
+					   double *duration)
+{
+	LocationRouteSegment *segment = location_route_segment_new();
+	LocationBoundary *bbox;
+	guint i;
+
+	if (segment == NULL) {
+		return NULL;
+	}
+
+	*distance = 0;
+	*duration = 0;
+	__bounds_init(bounds);
+	__bounds_extend(bounds, start->latitude, start->longitude);
+	__bounds_extend(bounds, end->latitude, end->longitude);
+	for (i = 0; i < path->edges->len; i++) {
+		guint32 edge = g_array_index(path->edges, guint32, i);
+		double from = __edge_from(path, i);
+		double to = __edge_to(path, i);
+
+		*distance += graph->edge_distance[edge] * (to - from);
+		*duration += graph->edge_duration[edge] * (to - from);
+		__append_edge_geometry(graph, edge, from, to, i == 0, NULL, bounds);
+	}
+
+	location_route_segment_set_start_point(segment, start);
+	location_route_segment_set_end_point(segment, end);
+	location_route_segment_set_distance(segment, *distance);
+	location_route_segment_set_duration(segment, (glong) lround(*duration));
+	bbox = __bounds_new_boundary(bounds);
+	location_route_segment_set_bounding_box(segment, bbox);
+	location_boundary_free(bbox);
+
+	if (options->step_used) {
+		GList *step_list = __new_steps(graph, path, options);
+		location_route_segment_set_route_step(segment, step_list);
+		g_list_free_full(step_list, __free_step);
+	}
+
+	return segment;
+}
+
+/*
+ * Road graph
+ */
+route_graph_s *route_graph_load(const char *path)
+{
+	route_graph_s *graph;
+	const route_graph_header_s *header;
+	struct stat st;
+	gsize offset = 0;
+	void *data;
+	int fd;
+
+	fd = open(path, O_RDONLY);
+	if (fd < 0) {
+		LOGE("[%s] Fail to open %s", __FUNCTION__, path);
+		return NULL;
+	}
+	if (fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(route_graph_header_s)) {
+		LOGE("[%s] Invalid graph file %s", __FUNCTION__, path);
+		close(fd);
+		return NULL;
+	}
+
+	/* A read-only shared mapping: pages come from the page cache and are shared by all processes. */
+	data = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);
+	if (data == MAP_FAILED) {
+		LOGE("[%s] Fail to map %s", __FUNCTION__, path);
+		return NULL;
+	}
+
+	graph = (route_graph_s *) malloc(sizeof(route_graph_s));
+	if (graph == NULL) {
+		munmap(data, st.st_size);
+		return NULL;
+	}
+	memset(graph, 0, sizeof(route_graph_s));
+	graph->data = data;
+	graph->data_size = st.st_size;
+
+	header = __section(graph, &offset, 1, sizeof(route_graph_header_s));
+	if (memcmp(header->magic, ROUTE_GRAPH_MAGIC, 4) != 0 || header->version != ROUTE_GRAPH_VERSION
+	    || header->node_count == 0 || header->node_count > ROUTE_GRAPH_MAX_INDEX
+	    || header->edge_count > ROUTE_GRAPH_MAX_INDEX || header->grid_cell_size <= 0) {
+		LOGE("[%s] Unsupported graph file %s", __FUNCTION__, path);
+		route_graph_free(graph);
+		return NULL;
+	}
+
+	guint64 n = header->node_count;
+	guint64 m = header->edge_count;
+	guint64 cells = (guint64) header->grid_columns * header->grid_rows;
+
+	graph->node_count = header->node_count;
+	graph->edge_count = header->edge_count;
+	graph->grid_columns = header->grid_columns;
+	graph->grid_rows = header->grid_rows;
+	graph->grid_min_lat = header->grid_min_lat / 1000000.0;
+	graph->grid_min_lon = header->grid_min_lon / 1000000.0;
+	graph->grid_cell_size = header->grid_cell_size / 1000000.0;
+	graph->max_speed = header->max_speed;
+
+	graph->node_lat = __section(graph, &offset, n, sizeof(gint32));
+	graph->node_lon = __section(graph, &offset, n, sizeof(gint32));
+	graph->first_edge = __section(graph, &offset, n + 1, sizeof(guint32));
+	graph->edge_target = __section(graph, &offset, m, sizeof(guint32));
+	graph->edge_distance = __section(graph, &offset, m, sizeof(float));
+	graph->edge_duration = __section(graph, &offset, m, sizeof(float));
+	graph->edge_source = __section(graph, &offset, m, sizeof(guint32));
+	graph->first_in_edge = __section(graph, &offset, n + 1, sizeof(guint32));
+	graph->in_edge = __section(graph, &offset, m, sizeof(guint32));
+	graph->geometry_first = __section(graph, &offset, m + 1, sizeof(guint32));
+	graph->shape_lat = __section(graph, &offset, header->shape_count, sizeof(gint32));
+	graph->shape_lon = __section(graph, &offset, header->shape_count, sizeof(gint32));
+	graph->grid_first = __section(graph, &offset, cells + 1, sizeof(guint32));
+	graph->grid_edge = __section(graph, &offset, header->grid_entry_count, sizeof(guint32));
+
+	/*
+	 * Only the layout is checked, so that opening a graph does not touch its pages.
+	 * The content is trusted to come from the route_graph_build tool.
+	 */
+	if (graph->grid_edge == NULL || graph->first_edge[n] != m || graph->first_in_edge[n] != m
+	    || graph->geometry_first[m] != header->shape_count || graph->grid_first[cells] != header->grid_entry_count) {
+		LOGE("[%s] Corrupted graph file %s", __FUNCTION__, path);
+		route_graph_free(graph);
+		return NULL;
+	}
+	graph->base_size = offset;
+
+	if (offset < graph->data_size) {
+		graph->has_ch = __load_ch(graph, offset);
+		if (!graph->has_ch) {
+			LOGE("[%s] Ignore the invalid contraction hierarchy of %s", __FUNCTION__, path);
+		}
+	}
+
+	return graph;
+}
+
+void route_graph_free(route_graph_s *graph)
+{
+	if (graph == NULL) {
+		return;
+	}
+
+	munmap((void *)graph->data, graph->data_size);
+	free(graph);
+}
+
+gboolean route_graph_find_nearest(route_graph_s *graph, double latitude, double longitude, route_graph_snap_s *snap)
+{
+	double cell_height = graph->grid_cell_size * ROUTE_GRAPH_METER_PER_DEGREE;
+	double cell_meter = MIN(cell_height, cell_height * cos(latitude * M_PI / 180.0));
+	gint64 column = (gint64) floor((longitude - graph->grid_min_lon) / graph->grid_cell_size);
+	gint64 row = (gint64) floor((latitude - graph->grid_min_lat) / graph->grid_cell_size);
+	gint64 max_ring = MAX(graph->grid_columns, graph->grid_rows) + MAX(ABS(column), ABS(row));
+	gint64 ring;
+	gint64 i;
+
+	snap->edge = ROUTE_GRAPH_NO_ARC;
+	snap->distance = G_MAXDOUBLE;
+
+	/* Visit the grid in growing square rings, until no cell of the next ring can hold a closer edge. */
+	for (ring = 0; ring <= max_ring; ring++) {
+		if (snap->edge != ROUTE_GRAPH_NO_ARC && snap->distance <= (ring - 1) * cell_meter) {
+			break;
+		}
+		if (ring == 0) {
+			__snap_cell(graph, column, row, latitude, longitude, snap);
+			continue;
+		}
+		for (i = -ring; i <= ring; i++) {
+			__snap_cell(graph, column + i, row - ring, latitude, longitude, snap);
+			__snap_cell(graph, column + i, row + ring, latitude, longitude, snap);
+		}
+		for (i = -ring + 1; i < ring; i++) {
+			__snap_cell(graph, column - ring, row + i, latitude, longitude, snap);
+			__snap_cell(graph, column + ring, row + i, latitude, longitude, snap);
+		}
+	}
+
+	return snap->edge != ROUTE_GRAPH_NO_ARC;
+}
+
+guint32 route_graph_find_twin_edge(route_graph_s *graph, guint32 edge)
+{
+	guint32 source = graph->edge_source[edge];
+	guint32 target = graph->edge_target[edge];
+	guint32 count = __edge_point_count(graph, edge);
+	guint32 i;
+
+	for (i = graph->first_edge[target]; i < graph->first_edge[target + 1]; i++) {
+		if (graph->edge_target[i] == source && __edge_point_count(graph, i) == count) {
+			return i;
+		}
+	}
+
+	return ROUTE_GRAPH_NO_ARC;
+}
+
+void route_graph_sample_edge(route_graph_s *graph, guint32 edge, double from, double to, double spacing,
+			     route_graph_sample_cb callback, gpointer user_data)
+{
+	guint32 count = __edge_point_count(graph, edge);
+	double total = __edge_length(graph, edge);
+	double along = 0;
+	double start = from * total;
+	double next = start;
+	double end = to * total;
+	double lat1, lon1, lat2, lon2;
+	guint32 i;
+
+	__edge_point(graph, edge, 0, &lat1, &lon1);
+	for (i = 1; i < count; i++) {
+		double length;
+		double t;
+
+		__edge_point(graph, edge, i, &lat2, &lon2);
+		length = route_graph_distance(lat1, lon1, lat2, lon2);
+
+		while (next < end && next < along + length) {
+			t = length > 0 ? CLAMP((next - along) / length, 0, 1) : 0;
+			callback(lat1 + (lat2 - lat1) * t, lon1 + (lon2 - lon1) * t, next / total, user_data);
+			next += spacing;
+		}
+
+		/* The last sample falls on the end of the range, even if it is closer than @spacing. */
+		if (end <= along + length || i == count - 1) {
+			t = length > 0 ? CLAMP((end - along) / length, 0, 1) : 0;
+			callback(lat1 + (lat2 - lat1) * t, lon1 + (lon2 - lon1) * t, total > 0 ? end / total : to, user_data);
+			return;
+		}
+
+		/* Shape points inside the range are always reported, so that the samples follow the road. */
+		along += length;
+		if (along > start) {
+			callback(lat2, lon2, along / total, user_data);
+		}
+		lat1 = lat2;
+		lon1 = lon2;
+	}
+}
+
+LocationRoute *route_graph_new_route(route_graph_s *graph, const route_graph_path_s *legs, const LocationPosition *points,
+				     int point_count, const route_graph_route_options_s *options)
+{
+	LocationRoute *route;
+	GList *segment_list = NULL;
+	double total_distance = 0;
+	double total_duration = 0;
+	__bounds bounds;
+	int i;
+
+	__bounds_init(&bounds);
+	for (i = 0; i + 1 < point_count; i++) {
+		__bounds leg_bounds;
+		double distance;
+		double duration;
+
+		LocationRouteSegment *segment = __new_segment(graph, &legs[i], &points[i], &points[i + 1], options, &leg_bounds,
+							      &distance, &duration);
+		if (segment == NULL) {
+			g_list_free_full(segment_list, __free_segment);
+			return NULL;
+		}
+		segment_list = g_list_prepend(segment_list, segment);
+		total_distance += distance;
+		total_duration += duration;
+		__bounds_merge(&bounds, &leg_bounds);
+	}
+	segment_list = g_list_reverse(segment_list);
+
+	route = location_route_new();
+	if (route == NULL) {
+		g_list_free_full(segment_list, __free_segment);
+		return NULL;
+	}
+
+	LocationBoundary *bbox = __bounds_new_boundary(&bounds);
+	location_route_set_origin(route, &points[0]);
+	location_route_set_destination(route, &points[point_count - 1]);
+	location_route_set_bounding_box(route, bbox);
+	location_route_set_distance_unit(route, "M");
+	location_route_set_total_distance(route, total_distance);
+	location_route_set_total_duration(route, (glong) lround(total_duration));
+	location_route_set_route_segment(route, segment_list);
+	location_boundary_free(bbox);
+	g_list_free_full(segment_list, __free_segment);
+
+	return route;
+}
+
+double route_graph_distance(double lat1, double lon1, double lat2, double lon2)
+{
+	return route_geodesy_haversine(lat1, lon1, lat2, lon2);
+}
+
+double route_graph_bearing(double lat1, double lon1, double lat2, double lon2)
+{
+	double phi1 = lat1 * M_PI / 180.0;
+	double phi2 = lat2 * M_PI / 180.0;
+	double dlambda = (lon2 - lon1) * M_PI / 180.0;
+	double y = sin(dlambda) * cos(phi2);
+	double x = cos(phi1) * sin(phi2) - sin(phi1) * cos(phi2) * cos(dlambda);
+	double bearing = atan2(y, x) * 180.0 / M_PI;
+
+	return bearing < 0 ? bearing + 360.0 : bearing;
+}
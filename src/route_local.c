@@ -0,0 +1,1134 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <location/location.h>
+#include <location/location-types.h>
+#include <location/location-map-service.h>
+
+#include "route_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_ROUTE"
+
+#define ROUTE_LOCAL_NO_EDGE G_MAXUINT32
+#define ROUTE_LOCAL_SEED 0x80000000U
+#define ROUTE_LOCAL_ISOCHRONE_MAX_CELLS (1 << 20)
+#define ROUTE_LOCAL_ISOCHRONE_MAX_SIDE 1024
+#define ROUTE_LOCAL_ISOCHRONE_MAX_COARSENING 64
+
+enum {
+	ROUTE_LOCAL_FORWARD = 0,
+	ROUTE_LOCAL_BACKWARD = 1,
+};
+
+typedef struct {
+	double key;
+	guint32 node;
+} __heap_item;
+
+typedef struct {
+	route_local_s *local;
+	guint id;
+	guint idle_id;
+	LocationPosition *points;
+	int point_count;
+	gboolean by_distance;
+	gboolean step_used;
+	gboolean step_geometry_used;
+	gboolean step_bounding_box_used;
+	gchar *transport_mode;
+	long max_duration;
+	double resolution;
+	LocationRouteCB callback;
+	route_local_isochrone_cb isochrone_callback;
+	gpointer userdata;
+} __local_request;
+
+typedef struct {
+	guint32 node;
+	guint32 edge;
+	double fraction;
+	double cost;
+} __seed;
+
+typedef struct {
+	route_graph_snap_s snap[2];
+	__seed seeds[2][2];
+	int seed_count[2];
+	gboolean by_distance;
+} __query;
+
+struct _route_local_s {
+	route_graph_s *graph;
+	GMutex lock;
+	GHashTable *requests;
+	guint last_id;
+	GList *goals;
+	GList *transport_modes;
+
+	/* Search workspace, only used from the main loop */
+	double *dist[2];
+	guint32 *parent[2];
+	guint32 *stamp[2];
+	guint32 generation;
+	GArray *heap[2];
+};
+
+/*
+ * Internal implementation
+ */
+static void __heap_push(GArray *heap, double key, guint32 node)
+{
+	__heap_item item = { key, node };
+	guint i;
+
+	g_array_append_val(heap, item);
+	i = heap->len - 1;
+	while (i > 0) {
+		guint parent = (i - 1) / 2;
+		if (g_array_index(heap, __heap_item, parent).key <= key) {
+			break;
+		}
+		g_array_index(heap, __heap_item, i) = g_array_index(heap, __heap_item, parent);
+		i = parent;
+	}
+	g_array_index(heap, __heap_item, i) = item;
+}
+
+static __heap_item __heap_pop(GArray *heap)
+{
+	__heap_item top = g_array_index(heap, __heap_item, 0);
+	__heap_item last = g_array_index(heap, __heap_item, heap->len - 1);
+	guint i = 0;
+
+	g_array_set_size(heap, heap->len - 1);
+	if (heap->len == 0) {
+		return top;
+	}
+
+	while (2 * i + 1 < heap->len) {
+		guint child = 2 * i + 1;
+		if (child + 1 < heap->len
+		    && g_array_index(heap, __heap_item, child + 1).key < g_array_index(heap, __heap_item, child).key) {
+			child++;
+		}
+		if (last.key <= g_array_index(heap, __heap_item, child).key) {
+			break;
+		}
+		g_array_index(heap, __heap_item, i) = g_array_index(heap, __heap_item, child);
+		i = child;
+	}
+	g_array_index(heap, __heap_item, i) = last;
+
+	return top;
+}
+
+static double __heap_top(GArray *heap)
+{
+	return heap->len ? g_array_index(heap, __heap_item, 0).key : G_MAXDOUBLE;
+}
+
+static double __distance(route_local_s *local, int side, guint32 node)
+{
+	return local->stamp[side][node] == local->generation ? local->dist[side][node] : G_MAXDOUBLE;
+}
+
+static void __relax(route_local_s *local, int side, guint32 node, double dist, guint32 edge)
+{
+	local->stamp[side][node] = local->generation;
+	local->dist[side][node] = dist;
+	local->parent[side][node] = edge;
+}
+
+static double __weight(route_graph_s *graph, guint32 edge, gboolean by_distance)
+{
+	return by_distance ? graph->edge_distance[edge] : graph->edge_duration[edge];
+}
+
+/* Lower bound of the cost between a node and a point */
+static double __estimate(route_graph_s *graph, guint32 node, double latitude, double longitude, gboolean by_distance)
+{
+	double distance = route_graph_distance(ROUTE_GRAPH_LAT(graph, node), ROUTE_GRAPH_LON(graph, node), latitude, longitude);
+
+	if (by_distance) {
+		return distance;
+	}
+	return graph->max_speed > 0 ? distance / graph->max_speed : 0;
+}
+
+/* Balanced potential, so that the forward and the backward search see consistent reduced costs */
+static double __potential(route_graph_s *graph, guint32 node, const __query *query)
+{
+	const route_graph_snap_s *origin = &query->snap[ROUTE_LOCAL_FORWARD];
+	const route_graph_snap_s *destination = &query->snap[ROUTE_LOCAL_BACKWARD];
+
+	return (__estimate(graph, node, destination->latitude, destination->longitude, query->by_distance)
+		- __estimate(graph, node, origin->latitude, origin->longitude, query->by_distance)) / 2;
+}
+
+/*
+ * Gets the nodes the forward search starts from, past the snapped origin, and the nodes the backward search
+ * starts from, before the snapped destination, on the snapped edge and on its twin in the other direction.
+ */
+static void __add_seeds(route_graph_s *graph, __query *query, int side)
+{
+	const route_graph_snap_s *snap = &query->snap[side];
+	guint32 edges[2] = { snap->edge, route_graph_find_twin_edge(graph, snap->edge) };
+	double fractions[2] = { snap->fraction, 1 - snap->fraction };
+	int i;
+
+	query->seed_count[side] = 0;
+	for (i = 0; i < 2; i++) {
+		__seed *seed = &query->seeds[side][query->seed_count[side]];
+
+		if (edges[i] == ROUTE_GRAPH_NO_ARC) {
+			continue;
+		}
+		seed->edge = edges[i];
+		seed->fraction = fractions[i];
+		if (side == ROUTE_LOCAL_FORWARD) {
+			seed->node = graph->edge_target[edges[i]];
+			seed->cost = __weight(graph, edges[i], query->by_distance) * (1 - fractions[i]);
+		} else {
+			seed->node = graph->edge_source[edges[i]];
+			seed->cost = __weight(graph, edges[i], query->by_distance) * fractions[i];
+		}
+		query->seed_count[side]++;
+	}
+}
+
+static gboolean __prepare_query(route_local_s *local, const LocationPosition *origin, const LocationPosition *destination,
+				gboolean by_distance, __query *query)
+{
+	route_graph_s *graph = local->graph;
+
+	query->by_distance = by_distance;
+	if (!route_graph_find_nearest(graph, origin->latitude, origin->longitude, &query->snap[ROUTE_LOCAL_FORWARD])
+	    || !route_graph_find_nearest(graph, destination->latitude, destination->longitude,
+					 &query->snap[ROUTE_LOCAL_BACKWARD])) {
+		return FALSE;
+	}
+	__add_seeds(graph, query, ROUTE_LOCAL_FORWARD);
+	__add_seeds(graph, query, ROUTE_LOCAL_BACKWARD);
+
+	return TRUE;
+}
+
+/* Cost of the path staying on one edge, when the destination is ahead of the origin on it */
+static double __direct_cost(route_graph_s *graph, const __query *query, route_graph_path_s *path)
+{
+	double best = G_MAXDOUBLE;
+	int i;
+	int j;
+
+	for (i = 0; i < query->seed_count[ROUTE_LOCAL_FORWARD]; i++) {
+		const __seed *from = &query->seeds[ROUTE_LOCAL_FORWARD][i];
+
+		for (j = 0; j < query->seed_count[ROUTE_LOCAL_BACKWARD]; j++) {
+			const __seed *to = &query->seeds[ROUTE_LOCAL_BACKWARD][j];
+			double cost = __weight(graph, from->edge, query->by_distance) * (to->fraction - from->fraction);
+
+			if (from->edge == to->edge && from->fraction <= to->fraction && cost < best) {
+				best = cost;
+				g_array_set_size(path->edges, 0);
+				g_array_append_val(path->edges, from->edge);
+				path->start_fraction = from->fraction;
+				path->end_fraction = to->fraction;
+			}
+		}
+	}
+
+	return best;
+}
+
+static gboolean __ensure_workspace(route_local_s *local)
+{
+	int side;
+	guint32 count = local->graph->node_count;
+
+	if (local->dist[0]) {
+		return TRUE;
+	}
+
+	for (side = 0; side < 2; side++) {
+		local->dist[side] = (double *) malloc(sizeof(double) * count);
+		local->parent[side] = (guint32 *) malloc(sizeof(guint32) * count);
+		local->stamp[side] = (guint32 *) calloc(count, sizeof(guint32));
+		local->heap[side] = g_array_new(FALSE, FALSE, sizeof(__heap_item));
+		if (local->dist[side] == NULL || local->parent[side] == NULL || local->stamp[side] == NULL) {
+			return FALSE;
+		}
+	}
+
+	return TRUE;
+}
+
+/* Labels the seeds of both sides, and returns the best path found through a seed */
+static double __start_search(route_local_s *local, const __query *query, gboolean with_potential, guint32 *meeting)
+{
+	route_graph_s *graph = local->graph;
+	double best = G_MAXDOUBLE;
+	int side;
+	int i;
+
+	if (++local->generation == 0) {
+		for (side = 0; side < 2; side++) {
+			memset(local->stamp[side], 0, sizeof(guint32) * graph->node_count);
+		}
+		local->generation = 1;
+	}
+
+	for (side = 0; side < 2; side++) {
+		g_array_set_size(local->heap[side], 0);
+		for (i = 0; i < query->seed_count[side]; i++) {
+			const __seed *seed = &query->seeds[side][i];
+			double potential = with_potential ? __potential(graph, seed->node, query) : 0;
+
+			if (seed->cost < __distance(local, side, seed->node)) {
+				__relax(local, side, seed->node, seed->cost, ROUTE_LOCAL_SEED | i);
+				__heap_push(local->heap[side], side == ROUTE_LOCAL_FORWARD ? seed->cost + potential
+					    : seed->cost - potential, seed->node);
+			}
+		}
+	}
+
+	for (i = 0; i < query->seed_count[ROUTE_LOCAL_FORWARD]; i++) {
+		guint32 node = query->seeds[ROUTE_LOCAL_FORWARD][i].node;
+		double other = __distance(local, ROUTE_LOCAL_BACKWARD, node);
+
+		if (other < G_MAXDOUBLE && __distance(local, ROUTE_LOCAL_FORWARD, node) + other < best) {
+			best = __distance(local, ROUTE_LOCAL_FORWARD, node) + other;
+			*meeting = node;
+		}
+	}
+
+	return best;
+}
+
+/*
+ * Bidirectional A* between the snapped points of @query. On success, @path holds the edges
+ * from the origin to the destination in travel order.
+ */
+static gboolean __search(route_local_s *local, const __query *query, route_graph_path_s *path)
+{
+	route_graph_s *graph = local->graph;
+	guint32 meeting = ROUTE_LOCAL_NO_EDGE;
+	double best = __direct_cost(graph, query, path);
+	double through = __start_search(local, query, TRUE, &meeting);
+	guint32 node;
+	int side;
+
+	if (through < best) {
+		best = through;
+	} else {
+		meeting = ROUTE_LOCAL_NO_EDGE;
+	}
+
+	while (local->heap[0]->len && local->heap[1]->len) {
+		double top_forward = __heap_top(local->heap[ROUTE_LOCAL_FORWARD]);
+		double top_backward = __heap_top(local->heap[ROUTE_LOCAL_BACKWARD]);
+
+		/* With balanced potentials the sum of the two keys bounds any path not yet seen. */
+		if (top_forward + top_backward >= best) {
+			break;
+		}
+
+		side = top_forward <= top_backward ? ROUTE_LOCAL_FORWARD : ROUTE_LOCAL_BACKWARD;
+		__heap_item item = __heap_pop(local->heap[side]);
+		double dist = __distance(local, side, item.node);
+		double potential = __potential(graph, item.node, query);
+
+		if (item.key > (side == ROUTE_LOCAL_FORWARD ? dist + potential : dist - potential) + 1e-9) {
+			continue;	/* stale entry */
+		}
+
+		guint32 first = side == ROUTE_LOCAL_FORWARD ? graph->first_edge[item.node] : graph->first_in_edge[item.node];
+		guint32 last = side == ROUTE_LOCAL_FORWARD ? graph->first_edge[item.node + 1] : graph->first_in_edge[item.node + 1];
+		guint32 i;
+
+		for (i = first; i < last; i++) {
+			guint32 edge = side == ROUTE_LOCAL_FORWARD ? i : graph->in_edge[i];
+			guint32 next = side == ROUTE_LOCAL_FORWARD ? graph->edge_target[edge] : graph->edge_source[edge];
+			double next_dist = dist + __weight(graph, edge, query->by_distance);
+
+			if (next_dist >= __distance(local, side, next)) {
+				continue;
+			}
+			__relax(local, side, next, next_dist, edge);
+
+			potential = __potential(graph, next, query);
+			__heap_push(local->heap[side], side == ROUTE_LOCAL_FORWARD ? next_dist + potential : next_dist - potential,
+				    next);
+
+			double other = __distance(local, !side, next);
+			if (other < G_MAXDOUBLE && next_dist + other < best) {
+				best = next_dist + other;
+				meeting = next;
+			}
+		}
+	}
+
+	if (meeting == ROUTE_LOCAL_NO_EDGE) {
+		return best < G_MAXDOUBLE;
+	}
+
+	guint32 parent;
+	guint first;
+	guint last;
+
+	g_array_set_size(path->edges, 0);
+	for (node = meeting; !((parent = local->parent[ROUTE_LOCAL_FORWARD][node]) & ROUTE_LOCAL_SEED);) {
+		g_array_append_val(path->edges, parent);
+		node = graph->edge_source[parent];
+	}
+	const __seed *seed = &query->seeds[ROUTE_LOCAL_FORWARD][parent & ~ROUTE_LOCAL_SEED];
+	g_array_append_val(path->edges, seed->edge);
+	path->start_fraction = seed->fraction;
+	for (first = 0, last = path->edges->len; first + 1 < last; first++, last--) {
+		guint32 edge = g_array_index(path->edges, guint32, first);
+		g_array_index(path->edges, guint32, first) = g_array_index(path->edges, guint32, last - 1);
+		g_array_index(path->edges, guint32, last - 1) = edge;
+	}
+
+	for (node = meeting; !((parent = local->parent[ROUTE_LOCAL_BACKWARD][node]) & ROUTE_LOCAL_SEED);) {
+		g_array_append_val(path->edges, parent);
+		node = graph->edge_target[parent];
+	}
+	seed = &query->seeds[ROUTE_LOCAL_BACKWARD][parent & ~ROUTE_LOCAL_SEED];
+	g_array_append_val(path->edges, seed->edge);
+	path->end_fraction = seed->fraction;
+
+	return TRUE;
+}
+
+/* Appends the road graph edges that @arc stands for, in travel order */
+static void __unpack_arc(route_graph_s *graph, guint32 arc, GArray *stack, GArray *edges)
+{
+	g_array_set_size(stack, 0);
+	g_array_append_val(stack, arc);
+	while (stack->len) {
+		arc = g_array_index(stack, guint32, stack->len - 1);
+		g_array_set_size(stack, stack->len - 1);
+		if (graph->arc_second[arc] == ROUTE_GRAPH_NO_ARC) {
+			g_array_append_val(edges, graph->arc_first[arc]);
+		} else {
+			g_array_append_val(stack, graph->arc_second[arc]);
+			g_array_append_val(stack, graph->arc_first[arc]);
+		}
+	}
+}
+
+/*
+ * Bidirectional upward search on the contraction hierarchy. On success, @path holds the road graph
+ * edges from the origin to the destination in travel order, with all shortcuts unpacked.
+ */
+static gboolean __search_ch(route_local_s *local, const __query *query, route_graph_path_s *path)
+{
+	route_graph_s *graph = local->graph;
+	gboolean done[2] = { FALSE, FALSE };
+	guint32 meeting = ROUTE_LOCAL_NO_EDGE;
+	double best = __direct_cost(graph, query, path);
+	double through = __start_search(local, query, FALSE, &meeting);
+	guint32 node;
+	int side;
+
+	if (through < best) {
+		best = through;
+	} else {
+		meeting = ROUTE_LOCAL_NO_EDGE;
+	}
+
+	while (!done[ROUTE_LOCAL_FORWARD] || !done[ROUTE_LOCAL_BACKWARD]) {
+		if (done[ROUTE_LOCAL_FORWARD]) {
+			side = ROUTE_LOCAL_BACKWARD;
+		} else if (done[ROUTE_LOCAL_BACKWARD]) {
+			side = ROUTE_LOCAL_FORWARD;
+		} else {
+			side = __heap_top(local->heap[ROUTE_LOCAL_FORWARD]) <= __heap_top(local->heap[ROUTE_LOCAL_BACKWARD])
+			    ? ROUTE_LOCAL_FORWARD : ROUTE_LOCAL_BACKWARD;
+		}
+
+		/* Each side only climbs in rank, so it may stop as soon as it cannot improve the best path. */
+		if (__heap_top(local->heap[side]) >= best) {
+			done[side] = TRUE;
+			continue;
+		}
+
+		__heap_item item = __heap_pop(local->heap[side]);
+		double dist = __distance(local, side, item.node);
+		if (item.key > dist) {
+			continue;	/* stale entry */
+		}
+
+		const guint32 *first = side == ROUTE_LOCAL_FORWARD ? graph->up_first : graph->down_first;
+		const guint32 *arcs = side == ROUTE_LOCAL_FORWARD ? graph->up_arc : graph->down_arc;
+		guint32 i;
+
+		for (i = first[item.node]; i < first[item.node + 1]; i++) {
+			guint32 arc = arcs[i];
+			guint32 next = side == ROUTE_LOCAL_FORWARD ? graph->arc_target[arc] : graph->arc_source[arc];
+			double next_dist = dist + graph->arc_weight[arc];
+
+			if (next_dist >= __distance(local, side, next)) {
+				continue;
+			}
+			__relax(local, side, next, next_dist, arc);
+			__heap_push(local->heap[side], next_dist, next);
+
+			double other = __distance(local, !side, next);
+			if (other < G_MAXDOUBLE && next_dist + other < best) {
+				best = next_dist + other;
+				meeting = next;
+			}
+		}
+	}
+
+	if (meeting == ROUTE_LOCAL_NO_EDGE) {
+		return best < G_MAXDOUBLE;
+	}
+
+	GArray *arcs = g_array_new(FALSE, FALSE, sizeof(guint32));
+	GArray *stack = g_array_new(FALSE, FALSE, sizeof(guint32));
+	guint32 parent;
+	guint i;
+
+	for (node = meeting; !((parent = local->parent[ROUTE_LOCAL_FORWARD][node]) & ROUTE_LOCAL_SEED);) {
+		g_array_append_val(arcs, parent);
+		node = graph->arc_source[parent];
+	}
+	const __seed *seed = &query->seeds[ROUTE_LOCAL_FORWARD][parent & ~ROUTE_LOCAL_SEED];
+	g_array_set_size(path->edges, 0);
+	g_array_append_val(path->edges, seed->edge);
+	path->start_fraction = seed->fraction;
+	for (i = arcs->len; i > 0; i--) {
+		__unpack_arc(graph, g_array_index(arcs, guint32, i - 1), stack, path->edges);
+	}
+
+	for (node = meeting; !((parent = local->parent[ROUTE_LOCAL_BACKWARD][node]) & ROUTE_LOCAL_SEED);) {
+		__unpack_arc(graph, parent, stack, path->edges);
+		node = graph->arc_target[parent];
+	}
+	seed = &query->seeds[ROUTE_LOCAL_BACKWARD][parent & ~ROUTE_LOCAL_SEED];
+	g_array_append_val(path->edges, seed->edge);
+	path->end_fraction = seed->fraction;
+
+	g_array_free(arcs, TRUE);
+	g_array_free(stack, TRUE);
+
+	return TRUE;
+}
+
+static LocationError __compute_route(__local_request *req, LocationRoute **route)
+{
+	route_local_s *local = req->local;
+	route_graph_route_options_s options;
+	route_graph_path_s *legs;
+	LocationError error = LOCATION_ERROR_NONE;
+	__query query;
+	int leg_count = req->point_count - 1;
+	int i;
+	gboolean use_ch = local->graph->has_ch
+	    && local->graph->ch_metric == (req->by_distance ? ROUTE_GRAPH_METRIC_DISTANCE : ROUTE_GRAPH_METRIC_DURATION);
+
+	if (!__ensure_workspace(local)) {
+		return LOCATION_ERROR_UNKNOWN;
+	}
+
+	legs = (route_graph_path_s *) calloc(leg_count, sizeof(route_graph_path_s));
+	if (legs == NULL) {
+		return LOCATION_ERROR_UNKNOWN;
+	}
+
+	for (i = 0; i < leg_count && error == LOCATION_ERROR_NONE; i++) {
+		legs[i].edges = g_array_new(FALSE, FALSE, sizeof(guint32));
+		if (!__prepare_query(local, &req->points[i], &req->points[i + 1], req->by_distance, &query)) {
+			error = LOCATION_ERROR_NOT_FOUND;
+		} else if (use_ch ? !__search_ch(local, &query, &legs[i]) : !__search(local, &query, &legs[i])) {
+			error = LOCATION_ERROR_NOT_FOUND;
+		}
+	}
+
+	if (error == LOCATION_ERROR_NONE) {
+		options.step_used = req->step_used;
+		options.step_geometry_used = req->step_geometry_used;
+		options.step_bounding_box_used = req->step_bounding_box_used;
+		options.transport_mode = req->transport_mode;
+		*route = route_graph_new_route(local->graph, legs, req->points, req->point_count, &options);
+		if (*route == NULL) {
+			error = LOCATION_ERROR_UNKNOWN;
+		}
+	}
+
+	for (i = 0; i < leg_count; i++) {
+		if (legs[i].edges) {
+			g_array_free(legs[i].edges, TRUE);
+		}
+	}
+	free(legs);
+
+	return error;
+}
+
+/*
+ * Isochrone
+ */
+typedef struct {
+	route_local_isochrone_s *isochrone;
+	double lat_step;
+	double lon_step;
+	double base;
+	double from;
+	double weight;
+	gboolean fill;
+	gboolean has_previous;
+	double previous_row;
+	double previous_column;
+	double previous_duration;
+} __isochrone_sampler;
+
+static void __isochrone_mark(route_local_isochrone_s *isochrone, int row, int column, double duration)
+{
+	long *cell;
+
+	row = CLAMP(row, 0, isochrone->rows - 1);
+	column = CLAMP(column, 0, isochrone->columns - 1);
+	cell = &isochrone->durations[row * isochrone->columns + column];
+	if (*cell < 0 || lround(duration) < *cell) {
+		*cell = lround(duration);
+	}
+}
+
+/* Marks every cell crossed by the straight line between two samples, with the time at which it is entered */
+static void __isochrone_trace(route_local_isochrone_s *isochrone, double row1, double column1, double duration1,
+			      double row2, double column2, double duration2)
+{
+	int row = (int)floor(row1);
+	int column = (int)floor(column1);
+	int last_row = (int)floor(row2);
+	int last_column = (int)floor(column2);
+	double delta_row = row2 - row1;
+	double delta_column = column2 - column1;
+	double next_row = delta_row > 0 ? (row + 1 - row1) / delta_row : delta_row < 0 ? (row - row1) / delta_row : G_MAXDOUBLE;
+	double next_column = delta_column > 0 ? (column + 1 - column1) / delta_column :
+		delta_column < 0 ? (column - column1) / delta_column : G_MAXDOUBLE;
+	double t;
+
+	__isochrone_mark(isochrone, row, column, duration1);
+	while (row != last_row || column != last_column) {
+		if (next_row < next_column) {
+			t = next_row;
+			row += delta_row > 0 ? 1 : -1;
+			next_row += 1 / fabs(delta_row);
+		} else {
+			t = next_column;
+			column += delta_column > 0 ? 1 : -1;
+			next_column += 1 / fabs(delta_column);
+		}
+		if (t > 1) {
+			break;
+		}
+		__isochrone_mark(isochrone, row, column, duration1 + (duration2 - duration1) * t);
+	}
+}
+
+static void __isochrone_sample(double latitude, double longitude, double fraction, gpointer user_data)
+{
+	__isochrone_sampler *sampler = (__isochrone_sampler *) user_data;
+	route_local_isochrone_s *isochrone = sampler->isochrone;
+	double row;
+	double column;
+	double duration;
+
+	if (!sampler->fill) {
+		isochrone->south = MIN(isochrone->south, latitude);
+		isochrone->west = MIN(isochrone->west, longitude);
+		isochrone->north = MAX(isochrone->north, latitude);
+		isochrone->east = MAX(isochrone->east, longitude);
+		return;
+	}
+
+	row = (latitude - isochrone->south) / sampler->lat_step;
+	column = (longitude - isochrone->west) / sampler->lon_step;
+	duration = sampler->base + (fraction - sampler->from) * sampler->weight;
+	if (sampler->has_previous) {
+		__isochrone_trace(isochrone, sampler->previous_row, sampler->previous_column, sampler->previous_duration,
+				  row, column, duration);
+	} else {
+		__isochrone_mark(isochrone, (int)floor(row), (int)floor(column), duration);
+	}
+	sampler->has_previous = TRUE;
+	sampler->previous_row = row;
+	sampler->previous_column = column;
+	sampler->previous_duration = duration;
+}
+
+/* One-to-all Dijkstra on durations from the seeds of @query, settling the nodes reachable within @budget */
+static void __search_all(route_local_s *local, const __query *query, double budget, GArray *settled)
+{
+	route_graph_s *graph = local->graph;
+	GArray *heap = local->heap[ROUTE_LOCAL_FORWARD];
+	guint32 meeting;
+	guint32 i;
+
+	__start_search(local, query, FALSE, &meeting);
+
+	while (heap->len) {
+		__heap_item item = __heap_pop(heap);
+		double dist = __distance(local, ROUTE_LOCAL_FORWARD, item.node);
+
+		if (item.key > dist) {
+			continue;	/* stale entry */
+		}
+		if (dist > budget) {
+			break;
+		}
+		g_array_append_val(settled, item.node);
+
+		for (i = graph->first_edge[item.node]; i < graph->first_edge[item.node + 1]; i++) {
+			guint32 next = graph->edge_target[i];
+			double next_dist = dist + graph->edge_duration[i];
+
+			if (next_dist > budget || next_dist >= __distance(local, ROUTE_LOCAL_FORWARD, next)) {
+				continue;
+			}
+			__relax(local, ROUTE_LOCAL_FORWARD, next, next_dist, i);
+			__heap_push(heap, next_dist, next);
+		}
+	}
+}
+
+/* Samples the part of each edge reachable within @budget, from the origin and from the settled nodes */
+static void __walk_isochrone(route_local_s *local, const __query *query, GArray *settled, double budget, double spacing,
+			     __isochrone_sampler *sampler)
+{
+	route_graph_s *graph = local->graph;
+	guint32 edge;
+	guint i;
+	int j;
+
+	for (j = 0; j < query->seed_count[ROUTE_LOCAL_FORWARD]; j++) {
+		const __seed *seed = &query->seeds[ROUTE_LOCAL_FORWARD][j];
+
+		sampler->base = 0;
+		sampler->from = seed->fraction;
+		sampler->has_previous = FALSE;
+		sampler->weight = graph->edge_duration[seed->edge];
+		route_graph_sample_edge(graph, seed->edge, seed->fraction,
+					sampler->weight > 0 ? MIN(1, seed->fraction + budget / sampler->weight) : 1, spacing,
+					__isochrone_sample, sampler);
+	}
+
+	for (i = 0; i < settled->len; i++) {
+		guint32 node = g_array_index(settled, guint32, i);
+		double dist = __distance(local, ROUTE_LOCAL_FORWARD, node);
+
+		for (edge = graph->first_edge[node]; edge < graph->first_edge[node + 1]; edge++) {
+			sampler->base = dist;
+			sampler->from = 0;
+			sampler->has_previous = FALSE;
+			sampler->weight = graph->edge_duration[edge];
+			route_graph_sample_edge(graph, edge, 0,
+						sampler->weight > 0 ? MIN(1, (budget - dist) / sampler->weight) : 1, spacing,
+						__isochrone_sample, sampler);
+		}
+	}
+}
+
+static LocationError __compute_isochrone(__local_request *req, route_local_isochrone_s *isochrone)
+{
+	route_local_s *local = req->local;
+	route_graph_s *graph = local->graph;
+	__isochrone_sampler sampler;
+	__query query;
+	GArray *settled;
+	double budget = req->max_duration;
+	double resolution = req->resolution;
+	int i;
+
+	if (!__ensure_workspace(local)) {
+		return LOCATION_ERROR_UNKNOWN;
+	}
+
+	query.by_distance = FALSE;
+	if (!route_graph_find_nearest(graph, req->points[0].latitude, req->points[0].longitude,
+				      &query.snap[ROUTE_LOCAL_FORWARD])) {
+		return LOCATION_ERROR_NOT_FOUND;
+	}
+	__add_seeds(graph, &query, ROUTE_LOCAL_FORWARD);
+	query.seed_count[ROUTE_LOCAL_BACKWARD] = 0;
+
+	settled = g_array_new(FALSE, FALSE, sizeof(guint32));
+	__search_all(local, &query, budget, settled);
+
+	/* A first walk gets the extent of the reachable roads, a second one fills the grid. */
+	memset(&sampler, 0, sizeof(sampler));
+	sampler.isochrone = isochrone;
+	isochrone->south = isochrone->north = query.snap[ROUTE_LOCAL_FORWARD].latitude;
+	isochrone->west = isochrone->east = query.snap[ROUTE_LOCAL_FORWARD].longitude;
+	__walk_isochrone(local, &query, settled, budget, resolution / 2, &sampler);
+
+	/*
+	 * Cells are squares of @resolution meters, made coarser if the grid would be too large. The dimensions are
+	 * computed in doubles, as the extent checked by route_local_request_isochrone() is only an upper bound.
+	 */
+	double meter_per_degree = route_graph_distance(0, 0, 1, 0);
+	double scale = MAX(cos(query.snap[ROUTE_LOCAL_FORWARD].latitude * M_PI / 180.0), 0.01);
+	double rows, columns;
+	int coarsening = 1;
+	for (;;) {
+		sampler.lat_step = resolution / meter_per_degree;
+		sampler.lon_step = sampler.lat_step / scale;
+		rows = floor((isochrone->north - isochrone->south) / sampler.lat_step) + 1;
+		columns = floor((isochrone->east - isochrone->west) / sampler.lon_step) + 1;
+		if (rows * columns <= ROUTE_LOCAL_ISOCHRONE_MAX_CELLS) {
+			break;
+		}
+		if (coarsening >= ROUTE_LOCAL_ISOCHRONE_MAX_COARSENING) {
+			g_array_free(settled, TRUE);
+			return LOCATION_ERROR_PARAMETER;
+		}
+		resolution *= 2;
+		coarsening *= 2;
+	}
+	isochrone->rows = (int) rows;
+	isochrone->columns = (int) columns;
+
+	isochrone->north = isochrone->south + isochrone->rows * sampler.lat_step;
+	isochrone->east = isochrone->west + isochrone->columns * sampler.lon_step;
+	isochrone->durations = (long *) malloc(sizeof(long) * isochrone->rows * isochrone->columns);
+	if (isochrone->durations == NULL) {
+		g_array_free(settled, TRUE);
+		return LOCATION_ERROR_UNKNOWN;
+	}
+	for (i = 0; i < isochrone->rows * isochrone->columns; i++) {
+		isochrone->durations[i] = -1;
+	}
+
+	sampler.fill = TRUE;
+	__walk_isochrone(local, &query, settled, budget, resolution / 2, &sampler);
+	g_array_free(settled, TRUE);
+
+	return LOCATION_ERROR_NONE;
+}
+
+static void __free_request(__local_request *req)
+{
+	if (req) {
+		free(req->points);
+		g_free(req->transport_mode);
+		free(req);
+	}
+}
+
+static gboolean __request_cb(gpointer userdata)
+{
+	__local_request *req = (__local_request *) userdata;
+	route_local_s *local = req->local;
+	LocationRoute *route = NULL;
+	GList *route_list = NULL;
+	gboolean found;
+
+	g_mutex_lock(&local->lock);
+	found = g_hash_table_remove(local->requests, GUINT_TO_POINTER(req->id));
+	g_mutex_unlock(&local->lock);
+
+	if (!found) {
+		return FALSE;
+	}
+
+	if (req->isochrone_callback) {
+		route_local_isochrone_s isochrone;
+
+		memset(&isochrone, 0, sizeof(isochrone));
+		LocationError error = __compute_isochrone(req, &isochrone);
+		req->isochrone_callback(error, req->id, error == LOCATION_ERROR_NONE ? &isochrone : NULL, req->userdata);
+		free(isochrone.durations);
+		__free_request(req);
+		return FALSE;
+	}
+
+	LocationError error = __compute_route(req, &route);
+	if (route) {
+		route_list = g_list_append(NULL, route);
+	}
+	req->callback(error, req->id, route_list, NULL, NULL, req->userdata);
+
+	if (route) {
+		location_route_free(route);
+	}
+	g_list_free(route_list);
+	__free_request(req);
+
+	return FALSE;
+}
+
+static void __queue_request(route_local_s *local, __local_request *req, guint *req_id)
+{
+	req->local = local;
+
+	g_mutex_lock(&local->lock);
+	req->id = ++local->last_id;
+	if (req->id == 0) {
+		req->id = ++local->last_id;
+	}
+	g_hash_table_insert(local->requests, GUINT_TO_POINTER(req->id), req);
+	req->idle_id = g_idle_add(__request_cb, req);
+	*req_id = req->id;
+	g_mutex_unlock(&local->lock);
+}
+
+static void __drop_request(gpointer key, gpointer value, gpointer user_data)
+{
+	__local_request *req = (__local_request *) value;
+
+	g_source_remove(req->idle_id);
+	__free_request(req);
+}
+
+/*
+ * Offline routing provider
+ */
+route_local_s *route_local_new(const char *graph_path)
+{
+	route_local_s *local = (route_local_s *) malloc(sizeof(route_local_s));
+	if (local == NULL) {
+		return NULL;
+	}
+	memset(local, 0, sizeof(route_local_s));
+
+	local->graph = route_graph_load(graph_path);
+	if (local->graph == NULL) {
+		free(local);
+		return NULL;
+	}
+
+	g_mutex_init(&local->lock);
+	local->requests = g_hash_table_new(g_direct_hash, g_direct_equal);
+	local->goals = g_list_append(local->goals, "FASTEST");
+	local->goals = g_list_append(local->goals, "SHORTEST");
+	local->transport_modes = g_list_append(local->transport_modes, "CAR");
+
+	return local;
+}
+
+void route_local_free(route_local_s *local)
+{
+	int side;
+
+	if (local == NULL) {
+		return;
+	}
+
+	g_mutex_lock(&local->lock);
+	g_hash_table_foreach(local->requests, __drop_request, NULL);
+	g_hash_table_destroy(local->requests);
+	g_mutex_unlock(&local->lock);
+	g_mutex_clear(&local->lock);
+
+	for (side = 0; side < 2; side++) {
+		free(local->dist[side]);
+		free(local->parent[side]);
+		free(local->stamp[side]);
+		if (local->heap[side]) {
+			g_array_free(local->heap[side], TRUE);
+		}
+	}
+	g_list_free(local->goals);
+	g_list_free(local->transport_modes);
+	route_graph_free(local->graph);
+	free(local);
+}
+
+int route_local_request_route(route_local_s *local, const LocationPosition *origin, const LocationPosition *destination,
+			      GList *waypoint, LocationRoutePreference *pref, LocationRouteCB callback, gpointer userdata,
+			      guint *req_id)
+{
+	__local_request *req;
+	const gchar *route_type = NULL;
+	const gchar *transport_mode = NULL;
+	int i = 0;
+
+	if (local == NULL || origin == NULL || destination == NULL || callback == NULL || req_id == NULL) {
+		return LOCATION_ERROR_PARAMETER;
+	}
+
+	if (pref) {
+		route_type = location_route_pref_get_route_type(pref);
+		transport_mode = location_route_pref_get_transport_mode(pref);
+	}
+	if (transport_mode
+	    && g_list_find_custom(local->transport_modes, transport_mode, (GCompareFunc) g_ascii_strcasecmp) == NULL) {
+		return LOCATION_ERROR_NOT_SUPPORTED;
+	}
+
+	req = (__local_request *) malloc(sizeof(__local_request));
+	if (req == NULL) {
+		return LOCATION_ERROR_UNKNOWN;
+	}
+	memset(req, 0, sizeof(__local_request));
+
+	req->point_count = g_list_length(waypoint) + 2;
+	req->points = (LocationPosition *) malloc(sizeof(LocationPosition) * req->point_count);
+	if (req->points == NULL) {
+		free(req);
+		return LOCATION_ERROR_UNKNOWN;
+	}
+	req->points[i++] = *origin;
+	for (; waypoint; waypoint = waypoint->next) {
+		req->points[i++] = *(LocationPosition *) waypoint->data;
+	}
+	req->points[i] = *destination;
+
+	if (pref) {
+		req->step_used = location_route_pref_get_instruction_used(pref);
+		req->step_geometry_used = location_route_pref_get_geometry_used(pref)
+		    || location_route_pref_get_instruction_geometry_used(pref);
+		req->step_bounding_box_used = location_route_pref_get_instruction_bounding_box_used(pref);
+	} else {
+		req->step_used = TRUE;
+		req->step_geometry_used = TRUE;
+		req->step_bounding_box_used = TRUE;
+	}
+	req->by_distance = route_type && g_ascii_strcasecmp(route_type, "SHORTEST") == 0;
+	req->transport_mode = g_strdup(transport_mode ? transport_mode : "CAR");
+	req->callback = callback;
+	req->userdata = userdata;
+	__queue_request(local, req, req_id);
+
+	return LOCATION_ERROR_NONE;
+}
+
+int route_local_request_isochrone(route_local_s *local, const LocationPosition *origin, long max_duration,
+				  double resolution, LocationRoutePreference *pref, route_local_isochrone_cb callback,
+				  gpointer userdata, guint *req_id)
+{
+	__local_request *req;
+	const gchar *transport_mode = NULL;
+
+	if (local == NULL || origin == NULL || max_duration <= 0 || resolution <= 0 || callback == NULL || req_id == NULL) {
+		return LOCATION_ERROR_PARAMETER;
+	}
+
+	/*
+	 * Nothing is reached farther than the budget at the top speed of the graph. A request whose grid could need
+	 * more than the most coarsened cells along that diameter is too large, as is the walk sampling its roads.
+	 */
+	if (2 * max_duration * local->graph->max_speed
+	    > resolution * ROUTE_LOCAL_ISOCHRONE_MAX_COARSENING * (ROUTE_LOCAL_ISOCHRONE_MAX_SIDE - 1)) {
+		return LOCATION_ERROR_PARAMETER;
+	}
+
+	/* The durations of the road graph only hold for the transport modes it was built for. */
+	if (pref) {
+		transport_mode = location_route_pref_get_transport_mode(pref);
+	}
+	if (transport_mode
+	    && g_list_find_custom(local->transport_modes, transport_mode, (GCompareFunc) g_ascii_strcasecmp) == NULL) {
+		return LOCATION_ERROR_NOT_SUPPORTED;
+	}
+
+	req = (__local_request *) malloc(sizeof(__local_request));
+	if (req == NULL) {
+		return LOCATION_ERROR_UNKNOWN;
+	}
+	memset(req, 0, sizeof(__local_request));
+
+	req->points = (LocationPosition *) malloc(sizeof(LocationPosition));
+	if (req->points == NULL) {
+		free(req);
+		return LOCATION_ERROR_UNKNOWN;
+	}
+	req->points[0] = *origin;
+	req->point_count = 1;
+	req->max_duration = max_duration;
+	req->resolution = resolution;
+	req->isochrone_callback = callback;
+	req->userdata = userdata;
+	__queue_request(local, req, req_id);
+
+	return LOCATION_ERROR_NONE;
+}
+
+int route_local_cancel_route_request(route_local_s *local, guint req_id)
+{
+	__local_request *req;
+
+	if (local == NULL) {
+		return LOCATION_ERROR_PARAMETER;
+	}
+
+	g_mutex_lock(&local->lock);
+	req = g_hash_table_lookup(local->requests, GUINT_TO_POINTER(req_id));
+	if (req) {
+		g_hash_table_remove(local->requests, GUINT_TO_POINTER(req_id));
+	}
+	g_mutex_unlock(&local->lock);
+
+	if (req == NULL) {
+		return LOCATION_ERROR_NOT_FOUND;
+	}
+
+	g_source_remove(req->idle_id);
+	__free_request(req);
+
+	return LOCATION_ERROR_NONE;
+}
+
+gboolean route_local_is_supported_capability(route_local_s *local, LocationMapServiceType type)
+{
+	switch (type) {
+	case MAP_SERVICE_ROUTE_PREF_GEOMETRY_BOUNDING_BOX:
+	case MAP_SERVICE_ROUTE_PREF_GEOMETRY_RETRIEVAL:
+	case MAP_SERVICE_ROUTE_PREF_INSTRUCTION_GEOMETRY:
+	case MAP_SERVICE_ROUTE_PREF_INSTRUCTION_BOUNDING_BOX:
+	case MAP_SERVICE_ROUTE_PREF_INSTRUCTION_RETRIEVAL:
+	case MAP_SERVICE_ROUTE_PREF_TYPE:
+	case MAP_SERVICE_ROUTE_PREF_TRANSPORT_MODE:
+		return TRUE;
+	default:
+		return FALSE;
+	}
+}
+
+int route_local_get_capability_key(route_local_s *local, LocationMapServiceType type, GList **key)
+{
+	if (local == NULL || key == NULL) {
+		return LOCATION_ERROR_PARAMETER;
+	}
+
+	switch (type) {
+	case MAP_SERVICE_ROUTE_PREF_TYPE:
+		*key = local->goals;
+		break;
+	case MAP_SERVICE_ROUTE_PREF_TRANSPORT_MODE:
+		*key = local->transport_modes;
+		break;
+	default:
+		*key = NULL;
+		break;
+	}
+
+	return LOCATION_ERROR_NONE;
+}
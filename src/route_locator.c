@@ -0,0 +1,349 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <location/location.h>
+#include <location/location-types.h>
+#include <location/location-map-service.h>
+
+#include "route.h"
+#include "route_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_ROUTE"
+
+/*
+ * Internal macros
+ */
+#define ROUTE_CHECK_CONDITION(condition,error,msg)	\
+	if(condition) {} else	\
+	{ LOGE("[%s] %s(0x%08x)", __FUNCTION__, msg, error); return error; };	\
+
+#define ROUTE_PRINT_ERROR_CODE_RETURN(code)	\
+	LOGE("[%s] %s(0x%08x)", __FUNCTION__, #code, code); return code;	\
+
+#define ROUTE_NULL_ARG_CHECK(arg)\
+	ROUTE_CHECK_CONDITION( (arg != NULL), ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER")
+
+#define ROUTE_LOCATOR_METER_PER_DEGREE (6371008.8 * M_PI / 180.0)
+#define ROUTE_LOCATOR_MIN_CELL_SIZE 0.0001
+#define ROUTE_LOCATOR_EDGES_PER_CELL 4
+
+/*
+ * Internal implementation
+ */
+static guint32 __column(route_locator_s *locator, double longitude)
+{
+	double column = floor((longitude - locator->min_lon) / locator->cell_size);
+
+	return (guint32) CLAMP(column, 0, locator->columns - 1);
+}
+
+static guint32 __row(route_locator_s *locator, double latitude)
+{
+	double row = floor((latitude - locator->min_lat) / locator->cell_size);
+
+	return (guint32) CLAMP(row, 0, locator->rows - 1);
+}
+
+/*
+ * Adds the edge to the cells it crosses, by pieces no longer than a cell, so that a long diagonal edge does
+ * not fill its whole bounding box. Only counts the entries of each cell when the CSR edges are not allocated.
+ * @last_edge remembers the last edge added to each cell, as the pieces of an edge share cells.
+ */
+static void __cover_edge(route_locator_s *locator, const route_polyline_s *polyline, guint32 edge,
+			 guint32 *last_edge, guint32 *fill)
+{
+	double lat1 = polyline->latitudes[edge];
+	double lon1 = polyline->longitudes[edge];
+	double dlat = polyline->latitudes[edge + 1] - lat1;
+	double dlon = polyline->longitudes[edge + 1] - lon1;
+	int pieces = MAX(1, (int) ceil(sqrt(dlat * dlat + dlon * dlon) / locator->cell_size));
+	int i;
+
+	for (i = 0; i < pieces; i++) {
+		double from_lat = lat1 + dlat * i / pieces;
+		double from_lon = lon1 + dlon * i / pieces;
+		double to_lat = lat1 + dlat * (i + 1) / pieces;
+		double to_lon = lon1 + dlon * (i + 1) / pieces;
+		guint32 row_end = __row(locator, MAX(from_lat, to_lat));
+		guint32 column_end = __column(locator, MAX(from_lon, to_lon));
+		guint32 row;
+		guint32 column;
+
+		for (row = __row(locator, MIN(from_lat, to_lat)); row <= row_end; row++) {
+			for (column = __column(locator, MIN(from_lon, to_lon)); column <= column_end; column++) {
+				guint32 cell = row * locator->columns + column;
+
+				if (last_edge[cell] == edge + 1) {
+					continue;
+				}
+				last_edge[cell] = edge + 1;
+				if (locator->cell_edge) {
+					locator->cell_edge[fill[cell]++] = edge;
+				} else {
+					locator->cell_first[cell + 1]++;
+				}
+			}
+		}
+	}
+}
+
+static route_locator_s *__locator_new(const route_polyline_s *polyline)
+{
+	route_locator_s grid = { 0, };
+	route_locator_s *locator;
+	guint32 edge_count = polyline->count - 1;
+	double max_lat = polyline->latitudes[0];
+	double max_lon = polyline->longitudes[0];
+	double length = 0;
+	guint32 cells;
+	guint32 *last_edge;
+	guint32 *fill;
+	guint32 i;
+
+	grid.min_lat = polyline->latitudes[0];
+	grid.min_lon = polyline->longitudes[0];
+	for (i = 0; i < edge_count; i++) {
+		double dlat = polyline->latitudes[i + 1] - polyline->latitudes[i];
+		double dlon = polyline->longitudes[i + 1] - polyline->longitudes[i];
+
+		grid.min_lat = MIN(grid.min_lat, polyline->latitudes[i + 1]);
+		grid.min_lon = MIN(grid.min_lon, polyline->longitudes[i + 1]);
+		max_lat = MAX(max_lat, polyline->latitudes[i + 1]);
+		max_lon = MAX(max_lon, polyline->longitudes[i + 1]);
+		length += sqrt(dlat * dlat + dlon * dlon);
+	}
+
+	/* A few edges per cell, without more cells than a few per edge when the route spreads over a wide area. */
+	grid.cell_size = MAX(ROUTE_LOCATOR_EDGES_PER_CELL * length / edge_count,
+			     sqrt((max_lat - grid.min_lat) * (max_lon - grid.min_lon) / (ROUTE_LOCATOR_EDGES_PER_CELL * edge_count)));
+	grid.cell_size = MAX(grid.cell_size, ROUTE_LOCATOR_MIN_CELL_SIZE);
+	grid.columns = (guint32) ((max_lon - grid.min_lon) / grid.cell_size) + 1;
+	grid.rows = (guint32) ((max_lat - grid.min_lat) / grid.cell_size) + 1;
+	cells = grid.columns * grid.rows;
+
+	last_edge = (guint32 *) calloc(cells, sizeof(guint32));
+	grid.cell_first = (guint32 *) calloc(cells + 1, sizeof(guint32));
+	if (last_edge == NULL || grid.cell_first == NULL) {
+		free(last_edge);
+		free(grid.cell_first);
+		return NULL;
+	}
+	for (i = 0; i < edge_count; i++) {
+		__cover_edge(&grid, polyline, i, last_edge, NULL);
+	}
+	for (i = 0; i < cells; i++) {
+		grid.cell_first[i + 1] += grid.cell_first[i];
+	}
+
+	locator = (route_locator_s *) malloc(sizeof(route_locator_s) + (cells + 1 + grid.cell_first[cells]) * sizeof(guint32));
+	if (locator == NULL) {
+		free(last_edge);
+		free(grid.cell_first);
+		return NULL;
+	}
+	*locator = grid;
+	locator->cell_first = (guint32 *)(locator + 1);
+	locator->cell_edge = locator->cell_first + cells + 1;
+	memcpy(locator->cell_first, grid.cell_first, (cells + 1) * sizeof(guint32));
+
+	/* The counts pass left the next free entry of each cell in its CSR offset. */
+	fill = grid.cell_first;
+	memset(last_edge, 0, cells * sizeof(guint32));
+	for (i = 0; i < edge_count; i++) {
+		__cover_edge(locator, polyline, i, last_edge, fill);
+	}
+
+	free(last_edge);
+	free(grid.cell_first);
+	return locator;
+}
+
+/* Projects a point on an edge in a local equirectangular frame */
+double route_locator_snap_edge(const route_polyline_s *polyline, int edge, double latitude, double longitude, double *ratio)
+{
+	double lat1 = polyline->latitudes[edge];
+	double lon1 = polyline->longitudes[edge];
+	double lat2 = polyline->latitudes[edge + 1];
+	double lon2 = polyline->longitudes[edge + 1];
+	double scale = cos(latitude * M_PI / 180.0);
+	double dx = (lon2 - lon1) * scale;
+	double dy = lat2 - lat1;
+	double px = (longitude - lon1) * scale;
+	double py = latitude - lat1;
+	double length = dx * dx + dy * dy;
+	double t = length > 0 ? CLAMP((px * dx + py * dy) / length, 0, 1) : 0;
+
+	*ratio = t;
+
+	return route_graph_distance(latitude, longitude, lat1 + (lat2 - lat1) * t, lon1 + (lon2 - lon1) * t);
+}
+
+static void __snap_cell(route_locator_s *locator, const route_polyline_s *polyline, gint64 column, gint64 row,
+			double latitude, double longitude, route_locator_snap_s *snap)
+{
+	guint32 cell;
+	guint32 i;
+	double ratio;
+	double distance;
+
+	if (column < 0 || row < 0 || column >= locator->columns || row >= locator->rows) {
+		return;
+	}
+
+	cell = (guint32) row * locator->columns + (guint32) column;
+	for (i = locator->cell_first[cell]; i < locator->cell_first[cell + 1]; i++) {
+		distance = route_locator_snap_edge(polyline, locator->cell_edge[i], latitude, longitude, &ratio);
+		if (distance < snap->distance) {
+			snap->edge = locator->cell_edge[i];
+			snap->ratio = ratio;
+			snap->distance = distance;
+		}
+	}
+}
+
+route_locator_s *route_locator_get(route_s *route)
+{
+	route_locator_s *locator = g_atomic_pointer_get(&route->locator);
+	route_polyline_s *polyline;
+
+	if (locator == NULL) {
+		polyline = route_polyline_get(route);
+		if (polyline == NULL || polyline->count < 2) {
+			return NULL;
+		}
+		locator = __locator_new(polyline);
+		if (locator == NULL) {
+			return NULL;
+		}
+		locator = route_publish_lazy((gpointer *) &route->locator, locator, (GDestroyNotify) route_locator_free);
+	}
+
+	return locator;
+}
+
+void route_locator_free(route_locator_s *locator)
+{
+	free(locator);
+}
+
+gboolean route_locator_find_nearest(route_s *route, double latitude, double longitude, route_locator_snap_s *snap)
+{
+	route_locator_s *locator = route_locator_get(route);
+	route_polyline_s *polyline = route_polyline_get(route);
+
+	if (locator == NULL || polyline == NULL) {
+		return FALSE;
+	}
+
+	double cell_height = locator->cell_size * ROUTE_LOCATOR_METER_PER_DEGREE;
+	/* A degree of longitude is shortest at the latitude farthest from the equator, of the point or of the grid */
+	double max_latitude = MAX(ABS(locator->min_lat), ABS(locator->min_lat + locator->rows * locator->cell_size));
+	max_latitude = MAX(max_latitude, ABS(latitude));
+	double cell_meter = MIN(cell_height, cell_height * cos(MIN(max_latitude, 90) * M_PI / 180.0));
+	double column_offset = (longitude - locator->min_lon) / locator->cell_size;
+	double row_offset = (latitude - locator->min_lat) / locator->cell_size;
+	/*
+	 * A point off the grid starts from the nearest cell of the grid. A cell of the ring @ring around it is then
+	 * farther than (ring - 1) cells along the grid, and than the gap from the point to the grid across it.
+	 */
+	double gap_columns = MAX(MAX(-column_offset, column_offset - locator->columns), 0);
+	double gap_rows = MAX(MAX(-row_offset, row_offset - locator->rows), 0);
+	double gap = sqrt(gap_columns * gap_columns + gap_rows * gap_rows);
+	gint64 column = (gint64) CLAMP(floor(column_offset), 0, (double)locator->columns - 1);
+	gint64 row = (gint64) CLAMP(floor(row_offset), 0, (double)locator->rows - 1);
+	gint64 max_ring = MAX(locator->columns, locator->rows);
+	gint64 ring;
+	gint64 i;
+
+	snap->edge = -1;
+	snap->ratio = 0;
+	snap->distance = G_MAXDOUBLE;
+
+	/* Visit the grid in growing square rings, until no cell of the next ring can hold a closer edge. */
+	for (ring = 0; ring <= max_ring; ring++) {
+		if (snap->edge >= 0 && snap->distance <= sqrt((ring - 1) * (ring - 1) + gap * gap) * cell_meter) {
+			break;
+		}
+		if (ring == 0) {
+			__snap_cell(locator, polyline, column, row, latitude, longitude, snap);
+			continue;
+		}
+		for (i = -ring; i <= ring; i++) {
+			__snap_cell(locator, polyline, column + i, row - ring, latitude, longitude, snap);
+			__snap_cell(locator, polyline, column + i, row + ring, latitude, longitude, snap);
+		}
+		for (i = -ring + 1; i < ring; i++) {
+			__snap_cell(locator, polyline, column - ring, row + i, latitude, longitude, snap);
+			__snap_cell(locator, polyline, column + ring, row + i, latitude, longitude, snap);
+		}
+	}
+
+	return snap->edge >= 0;
+}
+
+/*
+ * Nearest position on a route
+ */
+int route_find_nearest_position(route_h route, location_coords_s coords, location_coords_s *snapped, int *segment_index,
+				int *step_index, double *offset)
+{
+	ROUTE_NULL_ARG_CHECK(route);
+	ROUTE_NULL_ARG_CHECK(snapped);
+	ROUTE_NULL_ARG_CHECK(segment_index);
+	ROUTE_NULL_ARG_CHECK(step_index);
+	ROUTE_NULL_ARG_CHECK(offset);
+
+	route_polyline_s *polyline = route_polyline_get((route_s *) route);
+	if (polyline == NULL) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	if (polyline->count == 0) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
+	}
+	if (polyline->count == 1) {
+		snapped->latitude = polyline->latitudes[0];
+		snapped->longitude = polyline->longitudes[0];
+		*segment_index = polyline->segment_indexes[0];
+		*step_index = polyline->step_indexes[0];
+		*offset = 0;
+		return ROUTE_ERROR_NONE;
+	}
+
+	route_locator_snap_s snap;
+	if (!route_locator_find_nearest((route_s *) route, coords.latitude, coords.longitude, &snap)) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	/* An edge belongs to the step its end point comes from. */
+	int edge = snap.edge;
+	snapped->latitude = polyline->latitudes[edge] + (polyline->latitudes[edge + 1] - polyline->latitudes[edge]) * snap.ratio;
+	snapped->longitude = polyline->longitudes[edge] + (polyline->longitudes[edge + 1] - polyline->longitudes[edge]) * snap.ratio;
+	*segment_index = polyline->segment_indexes[edge + 1];
+	*step_index = polyline->step_indexes[edge + 1];
+	*offset = polyline->offsets[edge] + (polyline->offsets[edge + 1] - polyline->offsets[edge]) * snap.ratio;
+
+	return ROUTE_ERROR_NONE;
+}
@@ -0,0 +1,285 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <location/location.h>
+#include <location/location-types.h>
+#include <location/location-map-service.h>
+
+#include "route.h"
+#include "route_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_ROUTE"
+
+/*
+ * Internal macros
+ */
+#define ROUTE_CHECK_CONDITION(condition,error,msg)	\
+	if(condition) {} else	\
+	{ LOGE("[%s] %s(0x%08x)", __FUNCTION__, msg, error); return error; };	\
+
+#define ROUTE_PRINT_ERROR_CODE_RETURN(code)	\
+	LOGE("[%s] %s(0x%08x)", __FUNCTION__, #code, code); return code;	\
+
+#define ROUTE_NULL_ARG_CHECK(arg)\
+	ROUTE_CHECK_CONDITION( (arg != NULL), ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER")
+
+#define ROUTE_PRECISION_CHECK(precision)\
+	ROUTE_CHECK_CONDITION( (precision == ROUTE_POLYLINE_PRECISION_5 || precision == ROUTE_POLYLINE_PRECISION_6),\
+			       ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER")
+
+/* A 32-bit value takes at most 7 chunks of 5 bits */
+#define ROUTE_POLYLINE_MAX_CHUNKS 7
+
+/*
+ * Internal implementation
+ */
+typedef struct {
+	char *out;
+	double factor;
+	gint32 latitude;
+	gint32 longitude;
+} __polyline_encoder;
+
+static double __precision_factor(route_polyline_precision_e precision)
+{
+	return precision == ROUTE_POLYLINE_PRECISION_6 ? 1e6 : 1e5;
+}
+
+/* Writes the chunks of a value at once, the continuation bit being set on all of them but the last */
+static char *__encode_value(char *out, gint32 delta)
+{
+	guint32 value = ((guint32) delta << 1) ^ (guint32) (delta >> 31);
+	int chunks = (g_bit_storage(value | 1) + 4) / 5;
+	int i;
+
+	for (i = 0; i < chunks; i++) {
+		out[i] = (char) ((((value >> (5 * i)) & 0x1f) | ((i + 1 < chunks) << 5)) + 63);
+	}
+
+	return out + chunks;
+}
+
+static void __encode_point(__polyline_encoder *encoder, double latitude, double longitude)
+{
+	gint32 lat = (gint32) lround(latitude * encoder->factor);
+	gint32 lon = (gint32) lround(longitude * encoder->factor);
+
+	encoder->out = __encode_value(encoder->out, lat - encoder->latitude);
+	encoder->out = __encode_value(encoder->out, lon - encoder->longitude);
+	encoder->latitude = lat;
+	encoder->longitude = lon;
+}
+
+static char *__encoder_begin(__polyline_encoder *encoder, route_polyline_precision_e precision, int count)
+{
+	char *encoded = (char *) malloc(2 * ROUTE_POLYLINE_MAX_CHUNKS * count + 1);
+
+	encoder->out = encoded;
+	encoder->factor = __precision_factor(precision);
+	encoder->latitude = 0;
+	encoder->longitude = 0;
+
+	return encoded;
+}
+
+/* Terminates the string and gives back the room reserved for the worst case */
+static char *__encoder_end(__polyline_encoder *encoder, char *encoded)
+{
+	char *shrunk;
+
+	*encoder->out = '\0';
+	shrunk = (char *) realloc(encoded, encoder->out - encoded + 1);
+
+	return shrunk ? shrunk : encoded;
+}
+
+/*
+ * Encoded polyline
+ */
+int route_encode_polyline(route_h route, route_polyline_precision_e precision, char **encoded)
+{
+	ROUTE_NULL_ARG_CHECK(route);
+	ROUTE_NULL_ARG_CHECK(encoded);
+	ROUTE_PRECISION_CHECK(precision);
+
+	const double *latitudes;
+	const double *longitudes;
+	int count;
+	int i;
+
+	int ret = route_get_polyline(route, &latitudes, &longitudes, &count);
+	if (ret != ROUTE_ERROR_NONE) {
+		return ret;
+	}
+
+	__polyline_encoder encoder;
+	char *result = __encoder_begin(&encoder, precision, count);
+	if (result == NULL) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	for (i = 0; i < count; i++) {
+		__encode_point(&encoder, latitudes[i], longitudes[i]);
+	}
+	*encoded = __encoder_end(&encoder, result);
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_step_encode_polyline(route_step_h step, route_polyline_precision_e precision, char **encoded)
+{
+	ROUTE_NULL_ARG_CHECK(step);
+	ROUTE_NULL_ARG_CHECK(encoded);
+	ROUTE_PRECISION_CHECK(precision);
+
+	route_step_s *handle = (route_step_s *) step;
+	GList *geometry_list = handle->view ? NULL : location_route_step_get_geometry(handle->step);
+	const LocationPosition *start = NULL;
+	const LocationPosition *end = NULL;
+	int count;
+
+	if (handle->view && handle->view->child_count > 0) {
+		count = handle->view->child_count;
+	} else if (geometry_list) {
+		count = g_list_length(geometry_list);
+	} else {
+		start = handle->view ? handle->view->start : location_route_step_get_start_point(handle->step);
+		end = handle->view ? handle->view->end : location_route_step_get_end_point(handle->step);
+		count = (start != NULL) + (end != NULL);
+	}
+	if (count == 0) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
+	}
+
+	__polyline_encoder encoder;
+	char *result = __encoder_begin(&encoder, precision, count);
+	if (result == NULL) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	if (handle->view && handle->view->child_count > 0) {
+		route_view_s view = handle->view->children;
+		LocationPosition pos;
+		int i;
+
+		for (i = 0; i < count; i++) {
+			if (route_view_read_position(&view, &pos)) {
+				__encode_point(&encoder, pos.latitude, pos.longitude);
+			}
+		}
+	}
+	for (; geometry_list; geometry_list = geometry_list->next) {
+		LocationPosition *pos = geometry_list->data;
+		__encode_point(&encoder, pos->latitude, pos->longitude);
+	}
+	if (start) {
+		__encode_point(&encoder, start->latitude, start->longitude);
+	}
+	if (end) {
+		__encode_point(&encoder, end->latitude, end->longitude);
+	}
+	*encoded = __encoder_end(&encoder, result);
+
+	return ROUTE_ERROR_NONE;
+}
+
+/* Returns the position after the value, or NULL when the value is malformed or truncated */
+static const char *__decode_value(const char *in, gint64 *delta)
+{
+	guint64 value = 0;
+	int i;
+
+	for (i = 0; i < ROUTE_POLYLINE_MAX_CHUNKS; i++) {
+		int chunk = in[i] - 63;
+
+		if (chunk < 0 || chunk > 0x3f) {
+			return NULL;
+		}
+		value |= (guint64) (chunk & 0x1f) << (5 * i);
+		if (chunk < 0x20) {
+			*delta = (gint64) (value >> 1) ^ -(gint64) (value & 1);
+			return in + i + 1;
+		}
+	}
+
+	return NULL;
+}
+
+int route_decode_polyline(const char *encoded, route_polyline_precision_e precision, double **latitudes,
+			  double **longitudes, int *count)
+{
+	ROUTE_NULL_ARG_CHECK(encoded);
+	ROUTE_NULL_ARG_CHECK(latitudes);
+	ROUTE_NULL_ARG_CHECK(longitudes);
+	ROUTE_NULL_ARG_CHECK(count);
+	ROUTE_PRECISION_CHECK(precision);
+
+	double factor = __precision_factor(precision);
+	gint64 lat = 0;
+	gint64 lon = 0;
+	int values = 0;
+	int point_count = 0;
+	const char *in;
+
+	/* Each value ends with the only one of its chunks below 0x20. */
+	for (in = encoded; *in; in++) {
+		values += (unsigned char) (*in - 63) < 0x20;
+	}
+	ROUTE_CHECK_CONDITION(values % 2 == 0, ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+
+	double *lats = (double *) malloc(sizeof(double) * (values / 2 + 1));
+	double *lons = (double *) malloc(sizeof(double) * (values / 2 + 1));
+	if (lats == NULL || lons == NULL) {
+		free(lats);
+		free(lons);
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	for (in = encoded; *in; point_count++) {
+		gint64 dlat;
+		gint64 dlon;
+
+		in = __decode_value(in, &dlat);
+		if (in) {
+			in = __decode_value(in, &dlon);
+		}
+		if (in == NULL) {
+			free(lats);
+			free(lons);
+			ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_INVALID_PARAMETER);
+		}
+		lat += dlat;
+		lon += dlon;
+		lats[point_count] = lat / factor;
+		lons[point_count] = lon / factor;
+	}
+
+	*latitudes = lats;
+	*longitudes = lons;
+	*count = point_count;
+
+	return ROUTE_ERROR_NONE;
+}
@@ -90,6 +90,22 @@ static int _convert_error_code(int code, const char *func_name)
 	return ret;
 }
 
+static gboolean __is_supported_capability(route_service_s *handle, LocationMapServiceType type)
+{
+	if (handle->local) {
+		return route_local_is_supported_capability(handle->local, type);
+	}
+	return location_map_is_supported_provider_capability(handle->object, type);
+}
+
+static int __get_capability_key(route_service_s *handle, LocationMapServiceType type, GList **key)
+{
+	if (handle->local) {
+		return route_local_get_capability_key(handle->local, type, key);
+	}
+	return location_map_get_provider_capability_key(handle->object, type, key);
+}
+
 /*
  * Route preference
  */
@@ -609,17 +625,17 @@ bool route_preference_is_area_to_avoid_supported(route_service_h service, locati
 	switch (type) {
 	case LOCATION_BOUNDS_RECT:
 		ret =
-		    (bool) location_map_is_supported_provider_capability(handle->object,
+		    (bool) __is_supported_capability(handle,
 									 MAP_SERVICE_ROUTE_REQUEST_RECT_AREA_TO_AVOID);
 		break;
 	case LOCATION_BOUNDS_CIRCLE:
 		ret =
-		    (bool) location_map_is_supported_provider_capability(handle->object,
+		    (bool) __is_supported_capability(handle,
 									 MAP_SERVICE_ROUTE_REQUEST_CIRCLE_AREA_TO_AVOID);
 		break;
 	case LOCATION_BOUNDS_POLYGON:
 		ret =
-		    (bool) location_map_is_supported_provider_capability(handle->object,
+		    (bool) __is_supported_capability(handle,
 									 MAP_SERVICE_ROUTE_REQUEST_POLYGON_AREA_TO_AVOID);
 		break;
 	default:
@@ -635,7 +651,7 @@ bool route_preference_is_address_to_avoid_supported(route_service_h service)
 	ROUTE_PREFERENCE_NULL_ARG_CHECK_RETURN_FALSE(service);
 
 	route_service_s *handle = (route_service_s *) service;
-	bool ret = (bool) location_map_is_supported_provider_capability(handle->object,
+	bool ret = (bool) __is_supported_capability(handle,
 									MAP_SERVICE_ROUTE_REQUEST_FREEFORM_ADDR_TO_AVOID);
 
 	return ret;
@@ -647,7 +663,7 @@ bool route_preference_is_geometry_bounding_box_supported(route_service_h service
 
 	route_service_s *handle = (route_service_s *) service;
 	bool ret =
-	    (bool) location_map_is_supported_provider_capability(handle->object, MAP_SERVICE_ROUTE_PREF_GEOMETRY_BOUNDING_BOX);
+	    (bool) __is_supported_capability(handle, MAP_SERVICE_ROUTE_PREF_GEOMETRY_BOUNDING_BOX);
 
 	return ret;
 }
@@ -658,7 +674,7 @@ bool route_preference_is_geometry_supported(route_service_h service)
 
 	route_service_s *handle = (route_service_s *) service;
 	bool ret =
-	    (bool) location_map_is_supported_provider_capability(handle->object, MAP_SERVICE_ROUTE_PREF_GEOMETRY_RETRIEVAL);
+	    (bool) __is_supported_capability(handle, MAP_SERVICE_ROUTE_PREF_GEOMETRY_RETRIEVAL);
 
 	return ret;
 }
@@ -669,7 +685,7 @@ bool route_preference_is_instruction_geometry_supported(route_service_h service)
 
 	route_service_s *handle = (route_service_s *) service;
 	bool ret =
-	    (bool) location_map_is_supported_provider_capability(handle->object, MAP_SERVICE_ROUTE_PREF_INSTRUCTION_GEOMETRY);
+	    (bool) __is_supported_capability(handle, MAP_SERVICE_ROUTE_PREF_INSTRUCTION_GEOMETRY);
 
 	return ret;
 }
@@ -679,7 +695,7 @@ bool route_preference_is_instruction_bounding_box_supported(route_service_h serv
 	ROUTE_PREFERENCE_NULL_ARG_CHECK_RETURN_FALSE(service);
 
 	route_service_s *handle = (route_service_s *) service;
-	bool ret = (bool) location_map_is_supported_provider_capability(handle->object,
+	bool ret = (bool) __is_supported_capability(handle,
 									MAP_SERVICE_ROUTE_PREF_INSTRUCTION_BOUNDING_BOX);
 
 	return ret;
@@ -691,7 +707,7 @@ bool route_preference_is_instruction_supported(route_service_h service)
 
 	route_service_s *handle = (route_service_s *) service;
 	bool ret =
-	    (bool) location_map_is_supported_provider_capability(handle->object, MAP_SERVICE_ROUTE_PREF_INSTRUCTION_RETRIEVAL);
+	    (bool) __is_supported_capability(handle, MAP_SERVICE_ROUTE_PREF_INSTRUCTION_RETRIEVAL);
 
 	return ret;
 }
@@ -702,7 +718,7 @@ bool route_preference_is_traffic_data_supported(route_service_h service)
 
 	route_service_s *handle = (route_service_s *) service;
 	bool ret =
-	    (bool) location_map_is_supported_provider_capability(handle->object, MAP_SERVICE_ROUTE_PREF_REALTIME_TRAFFIC);
+	    (bool) __is_supported_capability(handle, MAP_SERVICE_ROUTE_PREF_REALTIME_TRAFFIC);
 
 	return ret;
 }
@@ -716,7 +732,7 @@ int route_preference_foreach_available_constraints(route_service_h service, rout
 	route_service_s *handle = (route_service_s *) service;
 	LocationMapServiceType type = MAP_SERVICE_ROUTE_REQUEST_FEATURE_TO_AVOID;
 	GList *constraint_list = NULL;
-	int ret = location_map_get_provider_capability_key(handle->object, type, &constraint_list);
+	int ret = __get_capability_key(handle, type, &constraint_list);
 	if (ret) {
 		return _convert_error_code(ret, __FUNCTION__);
 	}
@@ -741,7 +757,7 @@ int route_preference_foreach_available_goals(route_service_h service, route_pref
 	route_service_s *handle = (route_service_s *) service;
 	LocationMapServiceType type = MAP_SERVICE_ROUTE_PREF_TYPE;
 	GList *goal_list = NULL;
-	int ret = location_map_get_provider_capability_key(handle->object, type, &goal_list);
+	int ret = __get_capability_key(handle, type, &goal_list);
 	if (ret) {
 		return _convert_error_code(ret, __FUNCTION__);
 	}
@@ -766,7 +782,7 @@ int route_preference_foreach_available_transport_modes(route_service_h service,
 	route_service_s *handle = (route_service_s *) service;
 	LocationMapServiceType type = MAP_SERVICE_ROUTE_PREF_TRANSPORT_MODE;
 	GList *mode_list = NULL;
-	int ret = location_map_get_provider_capability_key(handle->object, type, &mode_list);
+	int ret = __get_capability_key(handle, type, &mode_list);
 	if (ret) {
 		return _convert_error_code(ret, __FUNCTION__);
 	}
@@ -791,7 +807,7 @@ int route_preference_foreach_available_property_keys(route_service_h service,
 	route_service_s *handle = (route_service_s *) service;
 	LocationMapServiceType type = MAP_SERVICE_ROUTE_PREF_PROPERTY;
 	GList *key_list = NULL;
-	int ret = location_map_get_provider_capability_key(handle->object, type, &key_list);
+	int ret = __get_capability_key(handle, type, &key_list);
 	if (ret) {
 		return _convert_error_code(ret, __FUNCTION__);
 	}
@@ -817,7 +833,7 @@ int route_preference_foreach_available_property_values(route_service_h service,
 	route_service_s *handle = (route_service_s *) service;
 	LocationMapServiceType type = MAP_SERVICE_ROUTE_PREF_PROPERTY;
 	GList *key_list = NULL;
-	int ret = location_map_get_provider_capability_key(handle->object, type, &key_list);
+	int ret = __get_capability_key(handle, type, &key_list);
 	if (ret) {
 		return _convert_error_code(ret, __FUNCTION__);
 	}
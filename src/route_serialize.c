@@ -0,0 +1,1019 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <location/location.h>
+#include <location/location-types.h>
+#include <location/location-map-service.h>
+
+#include "route.h"
+#include "route_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_ROUTE"
+
+/*
+ * Internal macros
+ */
+#define ROUTE_CHECK_CONDITION(condition,error,msg)	\
+	if(condition) {} else	\
+	{ LOGE("[%s] %s(0x%08x)", __FUNCTION__, msg, error); return error; };	\
+
+#define ROUTE_PRINT_ERROR_CODE_RETURN(code)	\
+	LOGE("[%s] %s(0x%08x)", __FUNCTION__, #code, code); return code;	\
+
+#define ROUTE_NULL_ARG_CHECK(arg)\
+	ROUTE_CHECK_CONDITION( (arg != NULL), ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER")
+
+/*
+ * Layout, all numbers little endian:
+ *   header    "RTE" and the version byte
+ *   route     request id, origin, destination, bounding box, distance unit, total distance, total duration,
+ *             properties, segment count and segments
+ *   segment   start, end, bounding box, distance, duration, properties, step count and steps
+ *   step      start, end, bounding box, distance, duration, transport mode, instruction, properties,
+ *             point count and points
+ * Counts, lengths and durations are variable length integers, distances and coordinates 8 byte doubles.
+ * A position starts with a byte holding its presence, which optional fields follow, and its status.
+ * A string is its length plus one, zero standing for none, then its bytes and a terminating zero, so that
+ * a route read in place hands its strings out as they are.
+ *
+ * A compact route starts with "RTC" instead, and its header is followed by the length of a table holding each
+ * of its strings once, with their terminating zero. A string is then its offset in the table plus one, and the
+ * latitude and longitude of a position the zigzag encoded difference from the previous position of the route,
+ * in millionths of a degree, the first one being taken from zero.
+ */
+#define ROUTE_SERIALIZE_MAGIC "RTE"
+#define ROUTE_SERIALIZE_COMPACT_MAGIC "RTC"
+#define ROUTE_SERIALIZE_MAGIC_LENGTH 3
+#define ROUTE_SERIALIZE_VERSION 2
+#define ROUTE_SERIALIZE_HEADER_LENGTH (ROUTE_SERIALIZE_MAGIC_LENGTH + 1)
+#define ROUTE_SERIALIZE_COMPACT_SCALE 1e6
+
+#define ROUTE_SERIALIZE_POSITION_PRESENT 0x01
+#define ROUTE_SERIALIZE_POSITION_ALTITUDE 0x02
+#define ROUTE_SERIALIZE_POSITION_TIMESTAMP 0x04
+#define ROUTE_SERIALIZE_POSITION_STATUS_SHIFT 3
+
+/*
+ * Internal implementation
+ */
+
+/*
+ * A writer without data only measures, so that the buffer is allocated once at its final size. A compact one
+ * gathers the strings in @table as it measures, @strings giving the offset plus one of those already there.
+ */
+typedef struct {
+	guint8 *data;
+	gsize length;
+	gboolean compact;
+	GHashTable *strings;
+	GString *table;
+	gint32 latitude;
+	gint32 longitude;
+} __writer;
+
+static void __write_bytes(__writer *writer, const void *bytes, gsize length)
+{
+	if (writer->data && length > 0) {
+		memcpy(writer->data + writer->length, bytes, length);
+	}
+	writer->length += length;
+}
+
+static void __write_byte(__writer *writer, guint8 value)
+{
+	__write_bytes(writer, &value, 1);
+}
+
+static void __write_varint(__writer *writer, guint64 value)
+{
+	guint8 bytes[10];
+	gsize length = 0;
+
+	do {
+		bytes[length] = (guint8) (value & 0x7f) | (value > 0x7f ? 0x80 : 0);
+		value >>= 7;
+		length++;
+	} while (value);
+	__write_bytes(writer, bytes, length);
+}
+
+/* Signed values are zigzag encoded, so that small negative ones stay short */
+static void __write_svarint(__writer *writer, gint64 value)
+{
+	__write_varint(writer, ((guint64) value << 1) ^ (guint64) (value >> 63));
+}
+
+static void __write_double(__writer *writer, double value)
+{
+	guint8 bytes[8];
+	guint64 bits;
+	int i;
+
+	memcpy(&bits, &value, sizeof(bits));
+	for (i = 0; i < 8; i++) {
+		bytes[i] = (guint8) (bits >> (8 * i));
+	}
+	__write_bytes(writer, bytes, 8);
+}
+
+static void __write_string(__writer *writer, const gchar *str)
+{
+	gsize length = str ? strlen(str) : 0;
+	gsize reference;
+
+	if (writer->compact) {
+		reference = str ? GPOINTER_TO_SIZE(g_hash_table_lookup(writer->strings, str)) : 0;
+		if (str && reference == 0) {
+			reference = writer->table->len + 1;
+			g_string_append_len(writer->table, str, length + 1);
+			g_hash_table_insert(writer->strings, (gpointer) str, GSIZE_TO_POINTER(reference));
+		}
+		__write_varint(writer, reference);
+		return;
+	}
+
+	__write_varint(writer, str ? length + 1 : 0);
+	if (str) {
+		__write_bytes(writer, str, length + 1);
+	}
+}
+
+/* Coordinates out of range, which no position has, are clamped rather than wrapped */
+static gint32 __fixed_point(double degrees)
+{
+	if (!isfinite(degrees)) {
+		return 0;
+	}
+
+	return (gint32) lround(CLAMP(degrees * ROUTE_SERIALIZE_COMPACT_SCALE, G_MININT32, G_MAXINT32));
+}
+
+static void __write_position(__writer *writer, const LocationPosition *pos)
+{
+	gint32 latitude;
+	gint32 longitude;
+	guint8 flags;
+
+	if (pos == NULL) {
+		__write_byte(writer, 0);
+		return;
+	}
+
+	flags = ROUTE_SERIALIZE_POSITION_PRESENT | ((guint8) pos->status << ROUTE_SERIALIZE_POSITION_STATUS_SHIFT);
+	if (pos->altitude != 0) {
+		flags |= ROUTE_SERIALIZE_POSITION_ALTITUDE;
+	}
+	if (pos->timestamp != 0) {
+		flags |= ROUTE_SERIALIZE_POSITION_TIMESTAMP;
+	}
+	__write_byte(writer, flags);
+	if (writer->compact) {
+		latitude = __fixed_point(pos->latitude);
+		longitude = __fixed_point(pos->longitude);
+		__write_svarint(writer, (gint64) latitude - writer->latitude);
+		__write_svarint(writer, (gint64) longitude - writer->longitude);
+		writer->latitude = latitude;
+		writer->longitude = longitude;
+	} else {
+		__write_double(writer, pos->latitude);
+		__write_double(writer, pos->longitude);
+	}
+	if (flags & ROUTE_SERIALIZE_POSITION_ALTITUDE) {
+		__write_double(writer, pos->altitude);
+	}
+	if (flags & ROUTE_SERIALIZE_POSITION_TIMESTAMP) {
+		__write_varint(writer, pos->timestamp);
+	}
+}
+
+static void __write_positions(__writer *writer, GList *pos_list)
+{
+	__write_varint(writer, g_list_length(pos_list));
+	for (; pos_list; pos_list = pos_list->next) {
+		__write_position(writer, pos_list->data);
+	}
+}
+
+static void __write_boundary(__writer *writer, const LocationBoundary *bbox)
+{
+	if (bbox == NULL) {
+		__write_byte(writer, LOCATION_BOUNDARY_NONE);
+		return;
+	}
+
+	__write_byte(writer, (guint8) bbox->type);
+	switch (bbox->type) {
+	case LOCATION_BOUNDARY_RECT:
+		__write_position(writer, bbox->rect.left_top);
+		__write_position(writer, bbox->rect.right_bottom);
+		break;
+	case LOCATION_BOUNDARY_CIRCLE:
+		__write_position(writer, bbox->circle.center);
+		__write_double(writer, bbox->circle.radius);
+		break;
+	case LOCATION_BOUNDARY_POLYGON:
+		__write_positions(writer, bbox->polygon.position_list);
+		break;
+	default:
+		break;
+	}
+}
+
+/* Only the keys holding a value are written, as route_foreach_properties() only gives those */
+static void __write_properties(__writer *writer, GList *key_list, gconstpointer (*get)(gconstpointer, gconstpointer),
+			       gconstpointer object)
+{
+	GList *iter;
+	int count = 0;
+
+	for (iter = key_list; iter; iter = iter->next) {
+		count += iter->data != NULL && get(object, iter->data) != NULL;
+	}
+	__write_varint(writer, count);
+	for (iter = key_list; iter; iter = iter->next) {
+		const gchar *value = iter->data ? get(object, iter->data) : NULL;
+		if (value != NULL) {
+			__write_string(writer, iter->data);
+			__write_string(writer, value);
+		}
+	}
+}
+
+static void __write_step(__writer *writer, const LocationRouteStep *step)
+{
+	__write_position(writer, location_route_step_get_start_point(step));
+	__write_position(writer, location_route_step_get_end_point(step));
+	__write_boundary(writer, location_route_step_get_bounding_box(step));
+	__write_double(writer, location_route_step_get_distance(step));
+	__write_svarint(writer, location_route_step_get_duration(step));
+	__write_string(writer, location_route_step_get_transport_mode(step));
+	__write_string(writer, location_route_step_get_instruction(step));
+	__write_properties(writer, location_route_step_get_property_key(step),
+			   (gconstpointer (*)(gconstpointer, gconstpointer)) location_route_step_get_property, step);
+	__write_positions(writer, location_route_step_get_geometry(step));
+}
+
+static void __write_segment(__writer *writer, const LocationRouteSegment *segment)
+{
+	GList *step_list = location_route_segment_get_route_step(segment);
+
+	__write_position(writer, location_route_segment_get_start_point(segment));
+	__write_position(writer, location_route_segment_get_end_point(segment));
+	__write_boundary(writer, location_route_segment_get_bounding_box(segment));
+	__write_double(writer, location_route_segment_get_distance(segment));
+	__write_svarint(writer, location_route_segment_get_duration(segment));
+	__write_properties(writer, location_route_segment_get_property_key(segment),
+			   (gconstpointer (*)(gconstpointer, gconstpointer)) location_route_segment_get_property, segment);
+	__write_varint(writer, g_list_length(step_list));
+	for (; step_list; step_list = step_list->next) {
+		__write_step(writer, step_list->data);
+	}
+}
+
+/* The string table of a compact route is only whole once the route has been measured */
+static void __write_header(__writer *writer)
+{
+	__write_bytes(writer, writer->compact ? ROUTE_SERIALIZE_COMPACT_MAGIC : ROUTE_SERIALIZE_MAGIC, ROUTE_SERIALIZE_MAGIC_LENGTH);
+	__write_byte(writer, ROUTE_SERIALIZE_VERSION);
+	if (writer->compact) {
+		__write_varint(writer, writer->table->len);
+		__write_bytes(writer, writer->table->str, writer->table->len);
+	}
+}
+
+static void __write_route(__writer *writer, const LocationRoute *route, int request_id)
+{
+	GList *seg_list = location_route_get_route_segment(route);
+
+	__write_svarint(writer, request_id);
+	__write_position(writer, location_route_get_origin(route));
+	__write_position(writer, location_route_get_destination(route));
+	__write_boundary(writer, location_route_get_bounding_box(route));
+	__write_string(writer, location_route_get_distance_unit(route));
+	__write_double(writer, location_route_get_total_distance(route));
+	__write_svarint(writer, location_route_get_total_duration(route));
+	__write_properties(writer, location_route_get_property_key(route),
+			   (gconstpointer (*)(gconstpointer, gconstpointer)) location_route_get_property, route);
+	__write_varint(writer, g_list_length(seg_list));
+	for (; seg_list; seg_list = seg_list->next) {
+		__write_segment(writer, seg_list->data);
+	}
+}
+
+static const guint8 *__read_bytes(route_view_s *view, gsize length)
+{
+	const guint8 *bytes = view->data + view->offset;
+
+	if (view->failed || length > view->length - view->offset) {
+		view->failed = TRUE;
+		return NULL;
+	}
+	view->offset += length;
+
+	return bytes;
+}
+
+static guint8 __read_byte(route_view_s *view)
+{
+	const guint8 *bytes = __read_bytes(view, 1);
+
+	return bytes ? bytes[0] : 0;
+}
+
+static guint64 __read_varint(route_view_s *view)
+{
+	guint64 value = 0;
+	int shift;
+
+	for (shift = 0; shift < 64; shift += 7) {
+		guint8 byte = __read_byte(view);
+
+		value |= (guint64) (byte & 0x7f) << shift;
+		if (!(byte & 0x80)) {
+			return value;
+		}
+	}
+	view->failed = TRUE;
+
+	return 0;
+}
+
+static gint64 __read_svarint(route_view_s *view)
+{
+	guint64 value = __read_varint(view);
+
+	return (gint64) (value >> 1) ^ -(gint64) (value & 1);
+}
+
+static double __read_double(route_view_s *view)
+{
+	const guint8 *bytes = __read_bytes(view, 8);
+	guint64 bits = 0;
+	double value;
+	int i;
+
+	if (bytes == NULL) {
+		return 0;
+	}
+	for (i = 0; i < 8; i++) {
+		bits |= (guint64) bytes[i] << (8 * i);
+	}
+	memcpy(&value, &bits, sizeof(value));
+
+	return value;
+}
+
+/* Every item takes a byte at least, which bounds a count before anything is allocated for it */
+static guint __read_count(route_view_s *view)
+{
+	guint64 count = __read_varint(view);
+
+	if (count > view->length - view->offset) {
+		view->failed = TRUE;
+		return 0;
+	}
+
+	return (guint) count;
+}
+
+/* The string points into the buffer, NULL standing for none */
+static const gchar *__view_string(route_view_s *view)
+{
+	guint64 length = __read_varint(view);
+	const guint8 *bytes;
+
+	if (length == 0) {
+		return NULL;
+	}
+	/* The table ends with a terminating zero, so any offset in it starts a string */
+	if (view->compact) {
+		if (length > view->strings_length) {
+			view->failed = TRUE;
+			return NULL;
+		}
+		return view->strings + length - 1;
+	}
+	if (length > view->length - view->offset) {
+		view->failed = TRUE;
+		return NULL;
+	}
+	bytes = __read_bytes(view, length);
+	if (bytes == NULL || bytes[length - 1] != '\0') {
+		view->failed = TRUE;
+		return NULL;
+	}
+
+	return (const gchar *) bytes;
+}
+
+/* The string is newly allocated, NULL standing for none */
+static gchar *__read_string(route_view_s *view)
+{
+	return g_strdup(__view_string(view));
+}
+
+/* Adds a difference read from a compact route to its last coordinate, failing rather than overflowing */
+static gint32 __read_delta(route_view_s *view, gint32 last)
+{
+	gint64 value = __read_svarint(view);
+
+	if (value < (gint64) G_MININT32 - last || value > (gint64) G_MAXINT32 - last) {
+		view->failed = TRUE;
+		return last;
+	}
+
+	return (gint32) (last + value);
+}
+
+/* Reads a position into @pos, and tells whether there was one */
+static gboolean __view_position(route_view_s *view, LocationPosition *pos)
+{
+	guint8 flags = __read_byte(view);
+
+	if (!(flags & ROUTE_SERIALIZE_POSITION_PRESENT)) {
+		return FALSE;
+	}
+	if (view->compact) {
+		view->latitude = __read_delta(view, view->latitude);
+		view->longitude = __read_delta(view, view->longitude);
+		pos->latitude = view->latitude / ROUTE_SERIALIZE_COMPACT_SCALE;
+		pos->longitude = view->longitude / ROUTE_SERIALIZE_COMPACT_SCALE;
+	} else {
+		pos->latitude = __read_double(view);
+		pos->longitude = __read_double(view);
+	}
+	pos->altitude = flags & ROUTE_SERIALIZE_POSITION_ALTITUDE ? __read_double(view) : 0;
+	pos->timestamp = flags & ROUTE_SERIALIZE_POSITION_TIMESTAMP ? (guint) __read_varint(view) : 0;
+	pos->status = (LocationStatus) (flags >> ROUTE_SERIALIZE_POSITION_STATUS_SHIFT);
+
+	return !view->failed;
+}
+
+static LocationPosition *__read_position(route_view_s *view)
+{
+	LocationPosition pos;
+
+	if (!__view_position(view, &pos)) {
+		return NULL;
+	}
+
+	return location_position_new(pos.timestamp, pos.latitude, pos.longitude, pos.altitude, pos.status);
+}
+
+static void __free_position(gpointer data)
+{
+	location_position_free((LocationPosition *) data);
+}
+
+static GList *__read_positions(route_view_s *view)
+{
+	GList *pos_list = NULL;
+	guint count = __read_count(view);
+	guint i;
+
+	for (i = 0; i < count && !view->failed; i++) {
+		LocationPosition *pos = __read_position(view);
+		if (pos) {
+			pos_list = g_list_prepend(pos_list, pos);
+		}
+	}
+
+	return g_list_reverse(pos_list);
+}
+
+static LocationBoundary *__read_boundary(route_view_s *view)
+{
+	LocationBoundary *bbox = NULL;
+	LocationPosition *first;
+	LocationPosition *second;
+	GList *pos_list;
+	double radius;
+
+	switch (__read_byte(view)) {
+	case LOCATION_BOUNDARY_NONE:
+		break;
+	case LOCATION_BOUNDARY_RECT:
+		first = __read_position(view);
+		second = __read_position(view);
+		if (first && second) {
+			bbox = location_boundary_new_for_rect(first, second);
+		}
+		location_position_free(first);
+		location_position_free(second);
+		break;
+	case LOCATION_BOUNDARY_CIRCLE:
+		first = __read_position(view);
+		radius = __read_double(view);
+		if (first && !view->failed) {
+			bbox = location_boundary_new_for_circle(first, radius);
+		}
+		location_position_free(first);
+		break;
+	case LOCATION_BOUNDARY_POLYGON:
+		pos_list = __read_positions(view);
+		if (pos_list && !view->failed) {
+			bbox = location_boundary_new_for_polygon(pos_list);
+		}
+		g_list_free_full(pos_list, __free_position);
+		break;
+	default:
+		view->failed = TRUE;
+		break;
+	}
+
+	return bbox;
+}
+
+static void __read_properties(route_view_s *view, gboolean (*set)(gpointer, gconstpointer, gconstpointer), gpointer object)
+{
+	guint count = __read_count(view);
+	guint i;
+
+	for (i = 0; i < count && !view->failed; i++) {
+		gchar *key = __read_string(view);
+		gchar *value = __read_string(view);
+
+		if (key && value) {
+			set(object, key, value);
+		}
+		g_free(key);
+		g_free(value);
+	}
+}
+
+static void __view_boundary(route_view_s *view, route_view_item_s *item)
+{
+	gboolean has_left_top;
+	gboolean has_right_bottom;
+	guint count;
+	guint i;
+
+	item->bbox = NULL;
+	switch (__read_byte(view)) {
+	case LOCATION_BOUNDARY_NONE:
+		break;
+	case LOCATION_BOUNDARY_RECT:
+		/* Only a rectangle is given out, as the box getters do */
+		has_left_top = __view_position(view, &item->positions[2]);
+		has_right_bottom = __view_position(view, &item->positions[3]);
+		if (has_left_top && has_right_bottom) {
+			item->boundary.type = LOCATION_BOUNDARY_RECT;
+			item->boundary.rect.left_top = &item->positions[2];
+			item->boundary.rect.right_bottom = &item->positions[3];
+			item->bbox = &item->boundary;
+		}
+		break;
+	case LOCATION_BOUNDARY_CIRCLE:
+		__view_position(view, &item->positions[2]);
+		__read_double(view);
+		break;
+	case LOCATION_BOUNDARY_POLYGON:
+		count = __read_count(view);
+		for (i = 0; i < count && !view->failed; i++) {
+			__view_position(view, &item->positions[2]);
+		}
+		break;
+	default:
+		view->failed = TRUE;
+		break;
+	}
+}
+
+/* The setters copy what they are given, so the positions, boxes and strings read are freed right after */
+static LocationRouteStep *__read_step(route_view_s *view)
+{
+	LocationRouteStep *step = location_route_step_new();
+	LocationPosition *pos;
+	LocationBoundary *bbox;
+	GList *geometry;
+	gchar *str;
+
+	if (step == NULL) {
+		view->failed = TRUE;
+		return NULL;
+	}
+
+	pos = __read_position(view);
+	location_route_step_set_start_point(step, pos);
+	location_position_free(pos);
+	pos = __read_position(view);
+	location_route_step_set_end_point(step, pos);
+	location_position_free(pos);
+	bbox = __read_boundary(view);
+	location_route_step_set_bounding_box(step, bbox);
+	location_boundary_free(bbox);
+	location_route_step_set_distance(step, __read_double(view));
+	location_route_step_set_duration(step, (glong) __read_svarint(view));
+	str = __read_string(view);
+	location_route_step_set_transport_mode(step, str);
+	g_free(str);
+	str = __read_string(view);
+	location_route_step_set_instruction(step, str);
+	g_free(str);
+	__read_properties(view, (gboolean (*)(gpointer, gconstpointer, gconstpointer)) location_route_step_set_property, step);
+	geometry = __read_positions(view);
+	if (geometry) {
+		location_route_step_set_geometry(step, geometry);
+		g_list_free_full(geometry, __free_position);
+	}
+
+	return step;
+}
+
+static void __free_step(gpointer data)
+{
+	location_route_step_free((LocationRouteStep *) data);
+}
+
+static LocationRouteSegment *__read_segment(route_view_s *view)
+{
+	LocationRouteSegment *segment = location_route_segment_new();
+	LocationPosition *pos;
+	LocationBoundary *bbox;
+	GList *step_list = NULL;
+	guint count;
+	guint i;
+
+	if (segment == NULL) {
+		view->failed = TRUE;
+		return NULL;
+	}
+
+	pos = __read_position(view);
+	location_route_segment_set_start_point(segment, pos);
+	location_position_free(pos);
+	pos = __read_position(view);
+	location_route_segment_set_end_point(segment, pos);
+	location_position_free(pos);
+	bbox = __read_boundary(view);
+	location_route_segment_set_bounding_box(segment, bbox);
+	location_boundary_free(bbox);
+	location_route_segment_set_distance(segment, __read_double(view));
+	location_route_segment_set_duration(segment, (glong) __read_svarint(view));
+	__read_properties(view, (gboolean (*)(gpointer, gconstpointer, gconstpointer)) location_route_segment_set_property,
+			  segment);
+
+	count = __read_count(view);
+	for (i = 0; i < count && !view->failed; i++) {
+		LocationRouteStep *step = __read_step(view);
+		if (step) {
+			step_list = g_list_prepend(step_list, step);
+		}
+	}
+	if (step_list) {
+		step_list = g_list_reverse(step_list);
+		location_route_segment_set_route_step(segment, step_list);
+		g_list_free_full(step_list, __free_step);
+	}
+
+	return segment;
+}
+
+static void __free_segment(gpointer data)
+{
+	location_route_segment_free((LocationRouteSegment *) data);
+}
+
+static LocationRoute *__read_route(route_view_s *view, int *request_id)
+{
+	LocationRoute *route;
+	LocationPosition *pos;
+	LocationBoundary *bbox;
+	GList *seg_list = NULL;
+	gchar *unit;
+	guint count;
+	guint i;
+
+	*request_id = (int) __read_svarint(view);
+	route = location_route_new();
+	if (route == NULL) {
+		view->failed = TRUE;
+		return NULL;
+	}
+
+	pos = __read_position(view);
+	location_route_set_origin(route, pos);
+	location_position_free(pos);
+	pos = __read_position(view);
+	location_route_set_destination(route, pos);
+	location_position_free(pos);
+	bbox = __read_boundary(view);
+	location_route_set_bounding_box(route, bbox);
+	location_boundary_free(bbox);
+	unit = __read_string(view);
+	location_route_set_distance_unit(route, unit);
+	g_free(unit);
+	location_route_set_total_distance(route, __read_double(view));
+	location_route_set_total_duration(route, (glong) __read_svarint(view));
+	__read_properties(view, (gboolean (*)(gpointer, gconstpointer, gconstpointer)) location_route_set_property, route);
+
+	count = __read_count(view);
+	for (i = 0; i < count && !view->failed; i++) {
+		LocationRouteSegment *segment = __read_segment(view);
+		if (segment) {
+			seg_list = g_list_prepend(seg_list, segment);
+		}
+	}
+	if (seg_list) {
+		seg_list = g_list_reverse(seg_list);
+		location_route_set_route_segment(route, seg_list);
+		g_list_free_full(seg_list, __free_segment);
+	}
+
+	return route;
+}
+
+/* Sets @view on the route that follows the header, and on the string table of a compact route */
+static int __view_init(route_view_s *view, const guint8 *data, gsize length)
+{
+	guint64 strings_length;
+
+	memset(view, 0, sizeof(route_view_s));
+	view->data = data;
+	view->length = length;
+	view->offset = ROUTE_SERIALIZE_HEADER_LENGTH;
+
+	if (length <= ROUTE_SERIALIZE_HEADER_LENGTH) {
+		return ROUTE_ERROR_INVALID_PARAMETER;
+	}
+	view->compact = memcmp(data, ROUTE_SERIALIZE_COMPACT_MAGIC, ROUTE_SERIALIZE_MAGIC_LENGTH) == 0;
+	if (!view->compact && memcmp(data, ROUTE_SERIALIZE_MAGIC, ROUTE_SERIALIZE_MAGIC_LENGTH) != 0) {
+		return ROUTE_ERROR_INVALID_PARAMETER;
+	}
+	if (data[ROUTE_SERIALIZE_MAGIC_LENGTH] != ROUTE_SERIALIZE_VERSION) {
+		return ROUTE_ERROR_SERVICE_NOT_SUPPORTED;
+	}
+
+	if (view->compact) {
+		strings_length = __read_varint(view);
+		if (strings_length > view->length - view->offset) {
+			return ROUTE_ERROR_INVALID_PARAMETER;
+		}
+		view->strings = (const gchar *) __read_bytes(view, strings_length);
+		view->strings_length = strings_length;
+		if (view->failed || (strings_length > 0 && view->strings[strings_length - 1] != '\0')) {
+			return ROUTE_ERROR_INVALID_PARAMETER;
+		}
+	}
+
+	return ROUTE_ERROR_NONE;
+}
+
+gboolean route_view_read_item(route_view_s *view, route_view_level_e level, route_view_item_s *item)
+{
+	route_view_item_s child;
+	LocationPosition pos;
+	const gchar *key;
+	const gchar *value;
+	guint i;
+
+	item->source = *view;
+	item->request_id = level == ROUTE_VIEW_ROUTE ? (int) __read_svarint(view) : 0;
+	item->start = __view_position(view, &item->positions[0]) ? &item->positions[0] : NULL;
+	item->end = __view_position(view, &item->positions[1]) ? &item->positions[1] : NULL;
+	__view_boundary(view, item);
+	item->distance_unit = level == ROUTE_VIEW_ROUTE ? __view_string(view) : NULL;
+	item->distance = __read_double(view);
+	item->duration = (glong) __read_svarint(view);
+	item->transport_mode = level == ROUTE_VIEW_STEP ? __view_string(view) : NULL;
+	item->instruction = level == ROUTE_VIEW_STEP ? __view_string(view) : NULL;
+
+	item->property_count = __read_count(view);
+	item->properties = *view;
+	for (i = 0; i < item->property_count && !view->failed; i++) {
+		route_view_read_property(view, &key, &value);
+	}
+
+	/* The children are walked over, so that @view ends up on the next item */
+	item->child_count = __read_count(view);
+	item->children = *view;
+	for (i = 0; i < item->child_count && !view->failed; i++) {
+		if (level == ROUTE_VIEW_STEP) {
+			route_view_read_position(view, &pos);
+		} else {
+			route_view_read_item(view, level + 1, &child);
+		}
+	}
+
+	return !view->failed;
+}
+
+void route_view_read_property(route_view_s *view, const gchar **key, const gchar **value)
+{
+	*key = __view_string(view);
+	*value = __view_string(view);
+}
+
+gboolean route_view_read_position(route_view_s *view, LocationPosition *pos)
+{
+	return __view_position(view, pos);
+}
+
+gboolean route_view_open(const guint8 *data, gsize length, route_view_item_s *item)
+{
+	route_view_s view;
+
+	if (__view_init(&view, data, length) != ROUTE_ERROR_NONE) {
+		return FALSE;
+	}
+
+	return route_view_read_item(&view, ROUTE_VIEW_ROUTE, item) && view.offset == view.length;
+}
+
+/* The positions and box of an item point into the item, so those of the copy are set to its own */
+void route_view_copy_item(route_view_item_s *copy, const route_view_item_s *item)
+{
+	*copy = *item;
+	copy->start = item->start ? &copy->positions[0] : NULL;
+	copy->end = item->end ? &copy->positions[1] : NULL;
+	if (item->bbox) {
+		copy->boundary.rect.left_top = &copy->positions[2];
+		copy->boundary.rect.right_bottom = &copy->positions[3];
+		copy->bbox = &copy->boundary;
+	}
+}
+
+LocationRoute *route_view_get_location_route(route_s *route)
+{
+	LocationRoute *location_route = g_atomic_pointer_get(&route->route);
+
+	if (location_route == NULL && route->record) {
+		route_view_s view;
+		int request_id;
+
+		__view_init(&view, route->record->data, route->record->length);
+		location_route = __read_route(&view, &request_id);
+		if (location_route == NULL || view.failed) {
+			if (location_route) {
+				location_route_free(location_route);
+			}
+			return NULL;
+		}
+		location_route = route_publish_lazy((gpointer *) &route->route, location_route,
+						    (GDestroyNotify) location_route_free);
+	}
+
+	return location_route;
+}
+
+/*
+ * Route serialization
+ */
+int route_serialize(route_h route, unsigned char **buffer, int *length)
+{
+	ROUTE_NULL_ARG_CHECK(route);
+	ROUTE_NULL_ARG_CHECK(buffer);
+	ROUTE_NULL_ARG_CHECK(length);
+
+	route_s *handle = (route_s *) route;
+	__writer writer = { NULL, 0 };
+
+	/* A route read in place already is its own serialized form */
+	if (handle->record) {
+		*buffer = (unsigned char *) malloc(handle->record->length);
+		if (*buffer == NULL) {
+			ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+		}
+		memcpy(*buffer, handle->record->data, handle->record->length);
+		*length = (int) handle->record->length;
+		return ROUTE_ERROR_NONE;
+	}
+
+	__write_header(&writer);
+	__write_route(&writer, handle->route, handle->request_id);
+	if (writer.length > G_MAXINT) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	writer.data = (guint8 *) malloc(writer.length);
+	if (writer.data == NULL) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	writer.length = 0;
+	__write_header(&writer);
+	__write_route(&writer, handle->route, handle->request_id);
+
+	*buffer = writer.data;
+	*length = (int) writer.length;
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_deserialize(const unsigned char *buffer, int length, route_h *route)
+{
+	ROUTE_NULL_ARG_CHECK(buffer);
+	ROUTE_NULL_ARG_CHECK(route);
+	ROUTE_CHECK_CONDITION(length > 0, ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+
+	route_view_s view;
+	int ret = __view_init(&view, buffer, length);
+	if (ret != ROUTE_ERROR_NONE) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ret);
+	}
+
+	int request_id = 0;
+	LocationRoute *location_route = __read_route(&view, &request_id);
+
+	/* A truncated buffer or one with trailing bytes is not a route of this version */
+	if (view.failed || view.offset != view.length) {
+		if (location_route) {
+			location_route_free(location_route);
+		}
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_INVALID_PARAMETER);
+	}
+
+	route_s *handle = (route_s *) malloc(sizeof(route_s));
+	if (handle == NULL) {
+		location_route_free(location_route);
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	handle->route = location_route;
+	handle->request_id = request_id;
+	handle->ref_count = 1;
+	handle->response = NULL;
+	handle->record = NULL;
+	handle->polyline = NULL;
+	handle->locator = NULL;
+	handle->timing = NULL;
+	handle->bvh = NULL;
+
+	*route = (route_h) handle;
+
+	return ROUTE_ERROR_NONE;
+}
+
+/*
+ * Compact routes
+ */
+int route_clone_compact(route_h *compact_route, route_h origin)
+{
+	ROUTE_NULL_ARG_CHECK(compact_route);
+	ROUTE_NULL_ARG_CHECK(origin);
+
+	route_s *handle = (route_s *) origin;
+	LocationRoute *location_route;
+	__writer writer = { NULL, 0 };
+
+	if (handle->record && memcmp(handle->record->data, ROUTE_SERIALIZE_COMPACT_MAGIC, ROUTE_SERIALIZE_MAGIC_LENGTH) == 0) {
+		return route_clone(compact_route, origin);
+	}
+
+	location_route = handle->record ? route_view_get_location_route(handle) : handle->route;
+	if (location_route == NULL) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	/* The route is measured first, which gathers its strings, as the header holds them */
+	writer.compact = TRUE;
+	writer.strings = g_hash_table_new(g_str_hash, g_str_equal);
+	writer.table = g_string_new(NULL);
+	__write_route(&writer, location_route, handle->request_id);
+	__write_header(&writer);
+
+	route_s *compact = NULL;
+
+	if (writer.length <= G_MAXINT) {
+		writer.data = (guint8 *) malloc(writer.length);
+	}
+	if (writer.data) {
+		writer.length = 0;
+		writer.latitude = writer.longitude = 0;
+		__write_header(&writer);
+		__write_route(&writer, location_route, handle->request_id);
+		compact = route_record_new(NULL, writer.data, writer.length);
+		free(writer.data);
+	}
+	g_hash_table_destroy(writer.strings);
+	g_string_free(writer.table, TRUE);
+
+	if (compact == NULL) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	*compact_route = (route_h) compact;
+
+	return ROUTE_ERROR_NONE;
+}
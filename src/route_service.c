@@ -18,6 +18,7 @@
 #include <location/location-types.h>
 #include <location/location-map-service.h>
 
+#include "route.h"
 #include "route_service.h"
 #include "route_preference.h"
 #include "route_private.h"
@@ -46,11 +47,82 @@
 #define ROUTE_SERVICE_NULL_ARG_CHECK(arg)\
 	ROUTE_SERVICE_CHECK_CONDITION( (arg != NULL), ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER")
 
+typedef struct {
+	route_service_s *service;
+	gchar *key;
+	guint provider_id;
+	GList *waiters;
+	volatile gint cancelled;
+	volatile gint ref_count;
+} __inflight_request;
+
 typedef struct {
 	void *data;
 	route_service_found_cb callback;
+	guint request_id;
+	guint idle_id;
+	__inflight_request *inflight;
+	route_cache_entry_s *cache_entry;
+	route_service_s *service;
+	double max_similarity;
 } __callback_data;
 
+typedef struct _batch_request __batch_request;
+
+typedef struct {
+	__batch_request *batch;
+	int index;
+	guint request_id;
+	gboolean done;
+} __batch_slot;
+
+struct _batch_request {
+	route_service_s *service;
+	guint batch_id;
+	route_service_batch_item_s *items;
+	__batch_slot *slots;
+	int item_count;
+	int max_pending;
+	int next;
+	int pending;
+	int completed;
+	int failed;
+	gboolean pumping;
+	gboolean cancelled;
+	guint idle_id;
+	volatile gint ref_count;
+	route_service_batch_found_cb found_callback;
+	route_service_batch_completed_cb completed_callback;
+	void *user_data;
+	GDestroyNotify destroy;
+	LocationRoutePreference *preference;
+};
+
+typedef struct {
+	route_service_matrix_found_cb callback;
+	void *user_data;
+	int origin_count;
+	int destination_count;
+	double *distances;
+	long *durations;
+	int *item_first_cell;
+	int *next_cell;
+	gboolean found;
+} __matrix_request;
+
+typedef struct {
+	route_service_s *service;
+	guint request_id;
+	guint provider_id;
+	route_service_isochrone_found_cb callback;
+	void *user_data;
+} __isochrone_request;
+
+static void __free_batch(__batch_request *batch);
+static void __batch_pump(__batch_request *batch);
+static gboolean __cancel_batch(route_service_s *handle, guint batch_id);
+static gboolean __cancel_isochrone(route_service_s *handle, guint request_id);
+
 /*
  * Internal implementation
  */
@@ -100,44 +172,201 @@ static void __free_waypoint(gpointer data)
 	}
 }
 
+static int __cancel_provider_request(route_service_s *handle, guint provider_id)
+{
+	if (handle->local) {
+		return route_local_cancel_route_request(handle->local, provider_id);
+	}
+	return location_map_cancel_route_request(handle->object, provider_id);
+}
+
+static void __free_callback_data(__callback_data *calldata)
+{
+	if (calldata) {
+		route_cache_entry_unref(calldata->cache_entry);
+		free(calldata);
+	}
+}
+
+static void __unref_inflight(__inflight_request *inflight)
+{
+	if (inflight && g_atomic_int_dec_and_test(&inflight->ref_count)) {
+		g_list_free(inflight->waiters);
+		g_free(inflight->key);
+		free(inflight);
+	}
+}
+
+static void __register_request_locked(route_service_s *handle, __callback_data *calldata)
+{
+	calldata->request_id = ++handle->last_request_id;
+	if (calldata->request_id == 0) {
+		calldata->request_id = ++handle->last_request_id;
+	}
+	g_hash_table_insert(handle->requests, GUINT_TO_POINTER(calldata->request_id), calldata);
+}
+
+/* Detaches all waiters from @inflight. Must be called with the service lock held. */
+static GList *__take_waiters_locked(route_service_s *handle, __inflight_request *inflight)
+{
+	GList *waiters = inflight->waiters;
+	GList *iter;
+
+	if (g_hash_table_lookup(handle->inflight, inflight->key) == inflight) {
+		g_hash_table_remove(handle->inflight, inflight->key);
+	}
+	for (iter = waiters; iter; iter = iter->next) {
+		__callback_data *calldata = iter->data;
+		g_hash_table_remove(handle->requests, GUINT_TO_POINTER(calldata->request_id));
+		calldata->inflight = NULL;
+	}
+	inflight->waiters = NULL;
+
+	return waiters;
+}
+
+/* The handles of one delivery share a single allocation, see route_retain(). */
+static void __deliver_routes(__callback_data *calldata, int ret, GList *route_list, route_cache_entry_s *cache_entry)
+{
+	route_response_s *response = NULL;
+	int index = 0;
+	int total = 0;
+
+	if (route_list && ret == 0) {
+		GList *kept = NULL;
+
+		/* Near-duplicate alternatives are dropped before any handle is made for them. */
+		if (calldata->max_similarity < 1 && route_list->next) {
+			kept = route_similarity_filter(route_list, calldata->max_similarity);
+		}
+		response = route_response_new(kept ? kept : route_list, cache_entry, calldata->request_id);
+		g_list_free(kept);
+		if (response == NULL) {
+			ret = ROUTE_ERROR_OUT_OF_MEMORY;
+		}
+	}
+	if (response == NULL) {
+		calldata->callback(ret, index, total, NULL, calldata->data);
+		return;
+	}
+
+	total = route_response_get_count(response);
+	for (index = 0; index < total; index++) {
+		if (calldata->callback(ret, index, total, route_response_get_route(response, index), calldata->data) == false) {
+			break;
+		}
+	}
+	route_response_unref(response);
+}
+
+static void __deliver_to_waiters(GList *waiters, int ret, GList *route_list, route_cache_entry_s *cache_entry)
+{
+	GList *iter;
+
+	for (iter = waiters; iter; iter = iter->next) {
+		__callback_data *calldata = iter->data;
+		__deliver_routes(calldata, ret, route_list, cache_entry);
+		__free_callback_data(calldata);
+	}
+	g_list_free(waiters);
+}
+
 /*
  * Route service
  */
 static void __LocationRouteCB(LocationError error, guint req_id, GList * route_list, gchar * error_code, gchar * error_msg,
 			      gpointer userdata)
 {
-	__callback_data *calldata = (__callback_data *) userdata;
-	if (calldata == NULL || calldata->callback == NULL) {
+	__inflight_request *inflight = (__inflight_request *) userdata;
+	if (inflight == NULL) {
 		return;
 	}
 
+	/* Set under the service lock, but read here without it as the callback may race a cancellation */
+	if (g_atomic_int_get(&inflight->cancelled) || inflight->service == NULL) {
+		__unref_inflight(inflight);
+		return;
+	}
+
+	route_service_s *handle = inflight->service;
+
+	g_mutex_lock(&handle->lock);
+	GList *waiters = __take_waiters_locked(handle, inflight);
+	g_mutex_unlock(&handle->lock);
+
 	int ret = _convert_error_code(error, "found_callback");
-	GList *routes_list = route_list;
-	int index = 0;
-	int total = 0;
+	route_cache_entry_s *cache_entry = NULL;
+	if (ret == ROUTE_ERROR_NONE && route_list) {
+		cache_entry = route_cache_insert(handle->cache, inflight->key, route_list);
+	}
 
-	if (routes_list == NULL || ret != 0) {
-		calldata->callback(ret, index, total, NULL, calldata->data);
-		free(calldata);
-		return;
+	/* Delivering the cached copies lets the handles be retained without copying the routes again. */
+	__deliver_to_waiters(waiters, ret, cache_entry ? route_cache_entry_get_routes(cache_entry) : route_list, cache_entry);
+	route_cache_entry_unref(cache_entry);
+	__unref_inflight(inflight);
+}
+
+static gboolean __cache_hit_cb(gpointer userdata)
+{
+	__callback_data *calldata = (__callback_data *) userdata;
+	route_service_s *handle = calldata->service;
+	gboolean found = FALSE;
+
+	g_mutex_lock(&handle->lock);
+	if (g_hash_table_lookup(handle->requests, GUINT_TO_POINTER(calldata->request_id)) == calldata) {
+		g_hash_table_remove(handle->requests, GUINT_TO_POINTER(calldata->request_id));
+		found = TRUE;
 	}
+	g_mutex_unlock(&handle->lock);
 
-	total = g_list_length(routes_list);
-	while (routes_list) {
-		route_s *route = (route_s *) malloc(sizeof(route_s));
-		if (route == NULL) {
-			break;
-		}
-		route->route = routes_list->data;
-		route->request_id = req_id;
-		if (calldata->callback(ret, index++, total, route, calldata->data) == false) {
-			free(route);
-			break;
-		}
-		routes_list = routes_list->next;
-		free(route);
+	if (found) {
+		__deliver_routes(calldata, ROUTE_ERROR_NONE, route_cache_entry_get_routes(calldata->cache_entry),
+				 calldata->cache_entry);
+		__free_callback_data(calldata);
+	}
+
+	return FALSE;
+}
+
+/* Collects the detached requests in @user_data, each with a reference, so that their provider requests can be cancelled. */
+static void __detach_inflight(gpointer key, gpointer value, gpointer user_data)
+{
+	__inflight_request *inflight = (__inflight_request *) value;
+	GList **detached = (GList **) user_data;
+
+	g_list_free(inflight->waiters);
+	inflight->waiters = NULL;
+	inflight->service = NULL;
+	g_atomic_int_set(&inflight->cancelled, TRUE);
+	if (inflight->provider_id) {
+		g_atomic_int_inc(&inflight->ref_count);
+		*detached = g_list_prepend(*detached, inflight);
+	}
+}
+
+static void __detach_batch(gpointer key, gpointer value, gpointer user_data)
+{
+	__batch_request *batch = (__batch_request *) value;
+
+	if (batch->idle_id) {
+		g_source_remove(batch->idle_id);
 	}
-	free(calldata);
+	__free_batch(batch);
+}
+
+static void __detach_isochrone(gpointer key, gpointer value, gpointer user_data)
+{
+	free(value);
+}
+
+static void __detach_request(gpointer key, gpointer value, gpointer user_data)
+{
+	__callback_data *calldata = (__callback_data *) value;
+
+	if (calldata->idle_id) {
+		g_source_remove(calldata->idle_id);
+	}
+	__free_callback_data(calldata);
 }
 
 int route_service_create(route_service_h * service)
@@ -155,19 +384,79 @@ int route_service_create(route_service_h * service)
 		ROUTE_SERVICE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
 	}
 	memset(handle, 0, sizeof(route_service_s));
+	handle->max_similarity = 1;
 
 	if (ROUTE_ERROR_NONE != route_preference_create(&handle->route_preference)) {
 		free(handle);
 		ROUTE_SERVICE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
 	}
 
+	handle->cache = route_cache_new();
+	if (handle->cache == NULL) {
+		route_preference_destroy(handle->route_preference);
+		free(handle);
+		ROUTE_SERVICE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
 	handle->object = location_map_new(NULL);
 	if (handle->object == NULL) {
+		route_cache_free(handle->cache);
+		route_preference_destroy(handle->route_preference);
 		free(handle);
 		LOGE("Fail to location_map_new");
 		ROUTE_SERVICE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_SERVICE_NOT_AVAILABLE);
 	}
 
+	handle->requests = g_hash_table_new(g_direct_hash, g_direct_equal);
+	handle->inflight = g_hash_table_new(g_str_hash, g_str_equal);
+	handle->batches = g_hash_table_new(g_direct_hash, g_direct_equal);
+	handle->isochrones = g_hash_table_new(g_direct_hash, g_direct_equal);
+	g_mutex_init(&handle->lock);
+
+	*service = (route_service_h) handle;
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_service_create_offline(route_service_h * service, const char *graph_path)
+{
+	ROUTE_SERVICE_NULL_ARG_CHECK(service);
+	ROUTE_SERVICE_NULL_ARG_CHECK(graph_path);
+
+	route_service_s *handle = (route_service_s *) malloc(sizeof(route_service_s));
+	if (handle == NULL) {
+		ROUTE_SERVICE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	memset(handle, 0, sizeof(route_service_s));
+	handle->max_similarity = 1;
+
+	if (ROUTE_ERROR_NONE != route_preference_create(&handle->route_preference)) {
+		free(handle);
+		ROUTE_SERVICE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	handle->cache = route_cache_new();
+	if (handle->cache == NULL) {
+		route_preference_destroy(handle->route_preference);
+		free(handle);
+		ROUTE_SERVICE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	handle->local = route_local_new(graph_path);
+	if (handle->local == NULL) {
+		route_cache_free(handle->cache);
+		route_preference_destroy(handle->route_preference);
+		free(handle);
+		LOGE("Fail to load road graph %s", graph_path);
+		ROUTE_SERVICE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_SERVICE_NOT_AVAILABLE);
+	}
+
+	handle->requests = g_hash_table_new(g_direct_hash, g_direct_equal);
+	handle->inflight = g_hash_table_new(g_str_hash, g_str_equal);
+	handle->batches = g_hash_table_new(g_direct_hash, g_direct_equal);
+	handle->isochrones = g_hash_table_new(g_direct_hash, g_direct_equal);
+	g_mutex_init(&handle->lock);
+
 	*service = (route_service_h) handle;
 
 	return ROUTE_ERROR_NONE;
@@ -178,15 +467,48 @@ int route_service_destroy(route_service_h service)
 	ROUTE_SERVICE_NULL_ARG_CHECK(service);
 
 	route_service_s *handle = (route_service_s *) service;
+	GList *detached = NULL;
+	GList *iter;
+
+	/* A cancelled provider request never calls back, so its reference is dropped here. */
+	g_mutex_lock(&handle->lock);
+	g_hash_table_foreach(handle->inflight, __detach_inflight, &detached);
+	g_hash_table_remove_all(handle->inflight);
+	g_mutex_unlock(&handle->lock);
+	for (iter = detached; iter; iter = iter->next) {
+		__inflight_request *inflight = iter->data;
+		if (__cancel_provider_request(handle, inflight->provider_id) == LOCATION_ERROR_NONE) {
+			__unref_inflight(inflight);
+		}
+		__unref_inflight(inflight);
+	}
+	g_list_free(detached);
 
 	if (handle->route_preference) {
 		route_preference_destroy(handle->route_preference);
 	}
 
-	int ret = location_map_free(handle->object);
-	if (ret != LOCATION_ERROR_NONE) {
-		return _convert_error_code(ret, __FUNCTION__);
+	if (handle->local) {
+		route_local_free(handle->local);
+	} else {
+		int ret = location_map_free(handle->object);
+		if (ret != LOCATION_ERROR_NONE) {
+			return _convert_error_code(ret, __FUNCTION__);
+		}
 	}
+
+	g_mutex_lock(&handle->lock);
+	g_hash_table_destroy(handle->inflight);
+	g_hash_table_foreach(handle->requests, __detach_request, NULL);
+	g_hash_table_destroy(handle->requests);
+	g_hash_table_foreach(handle->batches, __detach_batch, NULL);
+	g_hash_table_destroy(handle->batches);
+	g_hash_table_foreach(handle->isochrones, __detach_isochrone, NULL);
+	g_hash_table_destroy(handle->isochrones);
+	g_mutex_unlock(&handle->lock);
+	g_mutex_clear(&handle->lock);
+
+	route_cache_free(handle->cache);
 	free(handle);
 	handle = NULL;
 
@@ -223,22 +545,16 @@ int route_service_set_preference(route_service_h service, route_preference_h pre
 	return ROUTE_ERROR_NONE;
 }
 
-int route_service_find(route_service_h service, location_coords_s origin, location_coords_s destination,
-		       location_coords_s * waypoint_list, int waypoint_num, route_service_found_cb callback, void *user_data,
-		       int *request_id)
+static int __find_route(route_service_s *handle, LocationRoutePreference *preference, location_coords_s origin,
+			location_coords_s destination, location_coords_s *waypoint_list, int waypoint_num,
+			route_service_found_cb callback, void *user_data, int *request_id)
 {
-	ROUTE_SERVICE_NULL_ARG_CHECK(service);
-	ROUTE_SERVICE_NULL_ARG_CHECK(callback);
-
 	LocationPosition start;
 	LocationPosition end;
 	unsigned int reqid;
 	int ret;
 	int i;
 
-	route_service_s *handle = (route_service_s *) service;
-	route_preference_s *pref = (route_preference_s *) handle->route_preference;
-
 	start.latitude = origin.latitude;
 	start.longitude = origin.longitude;
 	start.altitude = 0;
@@ -254,52 +570,864 @@ int route_service_find(route_service_h service, location_coords_s origin, locati
 
 	for (i = 0; i < waypoint_num; i++) {
 		via_pos =
-		    location_position_new(0, waypoint_list->latitude, waypoint_list->longitude, 0, LOCATION_STATUS_2D_FIX);
+		    location_position_new(0, waypoint_list[i].latitude, waypoint_list[i].longitude, 0, LOCATION_STATUS_2D_FIX);
 		if (via_pos == NULL) {
 			ROUTE_SERVICE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
 		} else {
-			waypoint_list++;
 			waypoint = g_list_append(waypoint, (gpointer) via_pos);
 		}
-		location_position_free(via_pos);
 	}
 
 	__callback_data *calldata = (__callback_data *) malloc(sizeof(__callback_data));
 	if (calldata == NULL) {
+		g_list_free_full(waypoint, __free_waypoint);
 		ROUTE_SERVICE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
 	}
+	memset(calldata, 0, sizeof(__callback_data));
 
 	calldata->callback = callback;
 	calldata->data = user_data;
+	calldata->service = handle;
+	calldata->max_similarity = handle->max_similarity;
+
+	gchar *key = route_cache_build_key(origin, destination, waypoint_list, waypoint_num, preference);
+	calldata->cache_entry = route_cache_lookup(handle->cache, key);
+
+	g_mutex_lock(&handle->lock);
+	__register_request_locked(handle, calldata);
+	guint id = calldata->request_id;
 
-	ret = location_map_request_route(handle->object, &start, &end, waypoint, pref->preference, __LocationRouteCB, calldata,
-				   &reqid);
+	if (calldata->cache_entry) {
+		calldata->idle_id = g_idle_add(__cache_hit_cb, calldata);
+		g_mutex_unlock(&handle->lock);
+		g_free(key);
+		g_list_free_full(waypoint, __free_waypoint);
+		if (request_id) {
+			*request_id = id;
+		}
+		return ROUTE_ERROR_NONE;
+	}
+
+	__inflight_request *inflight = g_hash_table_lookup(handle->inflight, key);
+	if (inflight) {
+		inflight->waiters = g_list_append(inflight->waiters, calldata);
+		calldata->inflight = inflight;
+		g_mutex_unlock(&handle->lock);
+		g_free(key);
+		g_list_free_full(waypoint, __free_waypoint);
+		if (request_id) {
+			*request_id = id;
+		}
+		return ROUTE_ERROR_NONE;
+	}
+
+	inflight = (__inflight_request *) malloc(sizeof(__inflight_request));
+	if (inflight == NULL) {
+		g_hash_table_remove(handle->requests, GUINT_TO_POINTER(id));
+		g_mutex_unlock(&handle->lock);
+		__free_callback_data(calldata);
+		g_free(key);
+		g_list_free_full(waypoint, __free_waypoint);
+		ROUTE_SERVICE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	memset(inflight, 0, sizeof(__inflight_request));
+
+	/* One reference for the provider callback, one held until the provider request id is known. */
+	inflight->ref_count = 2;
+	inflight->service = handle;
+	inflight->key = key;
+	inflight->waiters = g_list_append(NULL, calldata);
+	calldata->inflight = inflight;
+	g_hash_table_insert(handle->inflight, inflight->key, inflight);
+	handle->provider_requests++;
+	g_mutex_unlock(&handle->lock);
+
+	if (handle->local) {
+		ret = route_local_request_route(handle->local, &start, &end, waypoint, preference, __LocationRouteCB, inflight,
+						&reqid);
+		g_list_free_full(waypoint, __free_waypoint);
+		waypoint = NULL;
+	} else {
+		ret = location_map_request_route(handle->object, &start, &end, waypoint, preference, __LocationRouteCB,
+					   inflight, &reqid);
+	}
 	if (ret != LOCATION_ERROR_NONE) {
-		free(calldata);
+		g_mutex_lock(&handle->lock);
+		GList *waiters = __take_waiters_locked(handle, inflight);
+		g_mutex_unlock(&handle->lock);
+
+		ret = _convert_error_code(ret, __func__);
+		waiters = g_list_remove(waiters, calldata);
+		__deliver_to_waiters(waiters, ret, NULL, NULL);
+		__free_callback_data(calldata);
+		__unref_inflight(inflight);
+		__unref_inflight(inflight);
 		g_list_free_full(waypoint, __free_waypoint);
-		return _convert_error_code(ret, __func__);
+		return ret;
+	}
+
+	g_mutex_lock(&handle->lock);
+	inflight->provider_id = reqid;
+	gboolean cancelled = g_atomic_int_get(&inflight->cancelled);
+	g_mutex_unlock(&handle->lock);
+
+	/* Once cancelled, the provider does not call back and its reference is ours to drop */
+	if (cancelled && __cancel_provider_request(handle, reqid) == LOCATION_ERROR_NONE) {
+		__unref_inflight(inflight);
 	}
+	__unref_inflight(inflight);
 
 	if (request_id) {
-		*request_id = reqid;
+		*request_id = id;
 	}
 
 	return ROUTE_ERROR_NONE;
 }
 
+int route_service_find(route_service_h service, location_coords_s origin, location_coords_s destination,
+		       location_coords_s * waypoint_list, int waypoint_num, route_service_found_cb callback, void *user_data,
+		       int *request_id)
+{
+	ROUTE_SERVICE_NULL_ARG_CHECK(service);
+	ROUTE_SERVICE_NULL_ARG_CHECK(callback);
+
+	route_service_s *handle = (route_service_s *) service;
+	route_preference_s *pref = (route_preference_s *) handle->route_preference;
+
+	return __find_route(handle, pref->preference, origin, destination, waypoint_list, waypoint_num, callback, user_data,
+			    request_id);
+}
+
+static int __cancel_request(route_service_s *handle, guint request_id, gboolean *found)
+{
+	int ret;
+	__callback_data *calldata;
+	__inflight_request *inflight = NULL;
+	guint idle_id = 0;
+	guint provider_id = 0;
+
+	g_mutex_lock(&handle->lock);
+	calldata = g_hash_table_lookup(handle->requests, GUINT_TO_POINTER(request_id));
+	if (calldata) {
+		g_hash_table_remove(handle->requests, GUINT_TO_POINTER(request_id));
+		idle_id = calldata->idle_id;
+		inflight = calldata->inflight;
+		if (inflight) {
+			inflight->waiters = g_list_remove(inflight->waiters, calldata);
+			if (inflight->waiters == NULL) {
+				g_hash_table_remove(handle->inflight, inflight->key);
+				g_atomic_int_set(&inflight->cancelled, TRUE);
+				provider_id = inflight->provider_id;
+			}
+		}
+	}
+	g_mutex_unlock(&handle->lock);
+
+	*found = (calldata != NULL);
+	if (calldata == NULL) {
+		return ROUTE_ERROR_NONE;
+	}
+
+	if (idle_id) {
+		g_source_remove(idle_id);
+	}
+	__free_callback_data(calldata);
+
+	if (provider_id == 0) {
+		return ROUTE_ERROR_NONE;
+	}
+
+	ret = __cancel_provider_request(handle, provider_id);
+
+	if (ret != LOCATION_ERROR_NONE) {
+		return _convert_error_code(ret, __func__);
+	}
+	/* The provider no longer calls back, so the reference it held is dropped here */
+	__unref_inflight(inflight);
+
+	return ROUTE_ERROR_NONE;
+}
+
 int route_service_cancel(route_service_h service, int request_id)
 {
 	ROUTE_SERVICE_NULL_ARG_CHECK(service);
 
 	int ret;
+	gboolean found = FALSE;
+
+	route_service_s *handle = (route_service_s *) service;
+
+	ret = __cancel_request(handle, (guint) request_id, &found);
+	if (found) {
+		return ret;
+	}
+
+	if (__cancel_batch(handle, (guint) request_id) || __cancel_isochrone(handle, (guint) request_id)) {
+		return ROUTE_ERROR_NONE;
+	}
+
+	g_mutex_lock(&handle->lock);
+	found = request_id > 0 && (guint) request_id <= handle->last_request_id;
+	g_mutex_unlock(&handle->lock);
+	ROUTE_SERVICE_CHECK_CONDITION(found, ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+
+	return ROUTE_ERROR_NONE;
+}
+
+/*
+ * Route batch
+ */
+static void __free_batch(__batch_request *batch)
+{
+	if (batch->destroy) {
+		batch->destroy(batch->user_data);
+	}
+	if (batch->preference) {
+		location_route_pref_free(batch->preference);
+	}
+	free(batch->items);
+	free(batch->slots);
+	free(batch);
+}
+
+static void __unref_batch(__batch_request *batch)
+{
+	if (batch && g_atomic_int_dec_and_test(&batch->ref_count)) {
+		__free_batch(batch);
+	}
+}
+
+static void __batch_slot_done(__batch_slot *slot, gboolean failed)
+{
+	__batch_request *batch = slot->batch;
+	route_service_s *handle = batch->service;
+	gboolean completed = FALSE;
+
+	g_mutex_lock(&handle->lock);
+	if (slot->done) {
+		g_mutex_unlock(&handle->lock);
+		return;
+	}
+	slot->done = TRUE;
+	batch->pending--;
+	batch->completed++;
+	if (failed) {
+		batch->failed++;
+	}
+	if (!batch->cancelled && batch->completed == batch->item_count) {
+		g_hash_table_remove(handle->batches, GUINT_TO_POINTER(batch->batch_id));
+		completed = TRUE;
+	}
+	g_mutex_unlock(&handle->lock);
+
+	if (completed) {
+		if (batch->completed_callback) {
+			batch->completed_callback(batch->batch_id, batch->failed, batch->user_data);
+		}
+		/* Drops the reference held while the batch is registered. */
+		__unref_batch(batch);
+	} else if (!batch->cancelled) {
+		__batch_pump(batch);
+	}
+	__unref_batch(batch);
+}
+
+static bool __batch_found_cb(route_error_e error, int index, int total, route_h route, void *user_data)
+{
+	__batch_slot *slot = (__batch_slot *) user_data;
+	__batch_request *batch = slot->batch;
+	bool next = false;
+
+	if (!batch->cancelled) {
+		next = batch->found_callback(error, slot->index, index, total, route, batch->user_data);
+	}
+
+	if (route == NULL || index + 1 >= total || next == false) {
+		__batch_slot_done(slot, error != ROUTE_ERROR_NONE);
+		return false;
+	}
+
+	return true;
+}
+
+static void __batch_pump(__batch_request *batch)
+{
+	route_service_s *handle = batch->service;
+	route_preference_s *pref = (route_preference_s *) handle->route_preference;
+	route_service_batch_item_s *item;
+	__batch_slot *slot;
+	int request_id;
+	int ret;
+
+	g_mutex_lock(&handle->lock);
+	if (batch->pumping) {
+		g_mutex_unlock(&handle->lock);
+		return;
+	}
+	batch->pumping = TRUE;
+	g_atomic_int_inc(&batch->ref_count);
+
+	while (!batch->cancelled && batch->next < batch->item_count && batch->pending < batch->max_pending) {
+		slot = &batch->slots[batch->next++];
+		batch->pending++;
+		g_atomic_int_inc(&batch->ref_count);
+		g_mutex_unlock(&handle->lock);
+
+		item = &batch->items[slot->index];
+		ret = __find_route(handle, batch->preference ? batch->preference : pref->preference, item->origin,
+				   item->destination, item->waypoint_list, item->waypoint_num, __batch_found_cb, slot, &request_id);
+		if (ret != ROUTE_ERROR_NONE) {
+			if (!batch->cancelled) {
+				batch->found_callback(ret, slot->index, 0, 0, NULL, batch->user_data);
+			}
+			__batch_slot_done(slot, TRUE);
+			g_mutex_lock(&handle->lock);
+			continue;
+		}
+
+		g_mutex_lock(&handle->lock);
+		if (!slot->done) {
+			slot->request_id = (guint) request_id;
+		}
+	}
+
+	batch->pumping = FALSE;
+	g_mutex_unlock(&handle->lock);
+	__unref_batch(batch);
+}
+
+static gboolean __cancel_batch(route_service_s *handle, guint batch_id)
+{
+	__batch_request *batch;
+	guint *request_ids;
+	guint idle_id;
+	int count = 0;
+	int i;
+
+	g_mutex_lock(&handle->lock);
+	batch = g_hash_table_lookup(handle->batches, GUINT_TO_POINTER(batch_id));
+	if (batch == NULL) {
+		g_mutex_unlock(&handle->lock);
+		return FALSE;
+	}
+	g_hash_table_remove(handle->batches, GUINT_TO_POINTER(batch_id));
+	batch->cancelled = TRUE;
+	idle_id = batch->idle_id;
+	batch->idle_id = 0;
+	g_atomic_int_inc(&batch->ref_count);
+
+	request_ids = (guint *) malloc(sizeof(guint) * batch->item_count);
+	for (i = 0; request_ids && i < batch->next; i++) {
+		request_ids[i] = (!batch->slots[i].done) ? batch->slots[i].request_id : 0;
+	}
+	count = batch->next;
+	g_mutex_unlock(&handle->lock);
+
+	for (i = 0; request_ids && i < count; i++) {
+		gboolean found = FALSE;
+		if (request_ids[i] != 0) {
+			__cancel_request(handle, request_ids[i], &found);
+		}
+		if (found) {
+			__batch_slot_done(&batch->slots[i], FALSE);
+		}
+	}
+	free(request_ids);
+	if (idle_id) {
+		g_source_remove(idle_id);
+	}
+
+	/* Drops the reference held while the batch is registered and the one taken above. */
+	__unref_batch(batch);
+	__unref_batch(batch);
+
+	return TRUE;
+}
+
+/* A batch without items completes from the main loop, as if its last item had just been found */
+static gboolean __batch_empty_cb(gpointer user_data)
+{
+	__batch_request *batch = (__batch_request *) user_data;
+	route_service_s *handle = batch->service;
+	gboolean completed = FALSE;
+
+	g_mutex_lock(&handle->lock);
+	if (g_hash_table_lookup(handle->batches, GUINT_TO_POINTER(batch->batch_id)) == batch) {
+		g_hash_table_remove(handle->batches, GUINT_TO_POINTER(batch->batch_id));
+		completed = TRUE;
+	}
+	batch->idle_id = 0;
+	g_mutex_unlock(&handle->lock);
+
+	if (completed) {
+		if (batch->completed_callback) {
+			batch->completed_callback(batch->batch_id, 0, batch->user_data);
+		}
+		/* Drops the reference held while the batch is registered. */
+		__unref_batch(batch);
+	}
+
+	return FALSE;
+}
+
+static void __unref_batch_cb(gpointer user_data)
+{
+	__unref_batch((__batch_request *) user_data);
+}
+
+/* Takes the ownership of @preference. A NULL @preference uses the preference of the service for each item. */
+static int __start_batch(route_service_s *handle, const route_service_batch_item_s *items, int item_count, int max_pending,
+			 LocationRoutePreference *preference, route_service_batch_found_cb found_callback,
+			 route_service_batch_completed_cb completed_callback, void *user_data, GDestroyNotify destroy,
+			 int *batch_id)
+{
+	location_coords_s *waypoints;
+	size_t size;
+	int waypoint_total = 0;
+	int i;
+
+	for (i = 0; i < item_count; i++) {
+		waypoint_total += items[i].waypoint_num;
+	}
+
+	__batch_request *batch = (__batch_request *) malloc(sizeof(__batch_request));
+	if (batch == NULL) {
+		if (preference) {
+			location_route_pref_free(preference);
+		}
+		ROUTE_SERVICE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	memset(batch, 0, sizeof(__batch_request));
+
+	/* Items and their waypoints are copied into a single block. */
+	size = sizeof(route_service_batch_item_s) * item_count + sizeof(location_coords_s) * waypoint_total;
+	batch->items = (route_service_batch_item_s *) malloc(size);
+	batch->slots = (__batch_slot *) malloc(sizeof(__batch_slot) * item_count);
+	if (item_count > 0 && (batch->items == NULL || batch->slots == NULL)) {
+		free(batch->items);
+		free(batch->slots);
+		free(batch);
+		if (preference) {
+			location_route_pref_free(preference);
+		}
+		ROUTE_SERVICE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	memset(batch->slots, 0, sizeof(__batch_slot) * item_count);
+
+	waypoints = (location_coords_s *) (batch->items + item_count);
+	for (i = 0; i < item_count; i++) {
+		batch->items[i] = items[i];
+		if (items[i].waypoint_num > 0) {
+			memcpy(waypoints, items[i].waypoint_list, sizeof(location_coords_s) * items[i].waypoint_num);
+			batch->items[i].waypoint_list = waypoints;
+			waypoints += items[i].waypoint_num;
+		} else {
+			batch->items[i].waypoint_list = NULL;
+		}
+		batch->slots[i].batch = batch;
+		batch->slots[i].index = i;
+	}
+
+	batch->service = handle;
+	batch->item_count = item_count;
+	batch->max_pending = max_pending;
+	batch->found_callback = found_callback;
+	batch->completed_callback = completed_callback;
+	batch->user_data = user_data;
+	batch->destroy = destroy;
+	batch->preference = preference;
+	batch->ref_count = 1;
+
+	g_mutex_lock(&handle->lock);
+	batch->batch_id = ++handle->last_request_id;
+	if (batch->batch_id == 0) {
+		batch->batch_id = ++handle->last_request_id;
+	}
+	g_hash_table_insert(handle->batches, GUINT_TO_POINTER(batch->batch_id), batch);
+	if (item_count == 0) {
+		/* The source holds a reference of its own, dropped once it is dispatched or removed. */
+		g_atomic_int_inc(&batch->ref_count);
+		batch->idle_id = g_idle_add_full(G_PRIORITY_DEFAULT_IDLE, __batch_empty_cb, batch, __unref_batch_cb);
+	}
+	g_mutex_unlock(&handle->lock);
+
+	if (batch_id) {
+		*batch_id = batch->batch_id;
+	}
+
+	__batch_pump(batch);
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_service_find_batch(route_service_h service, const route_service_batch_item_s * items, int item_count,
+			     int max_pending, route_service_batch_found_cb found_callback,
+			     route_service_batch_completed_cb completed_callback, void *user_data, int *batch_id)
+{
+	ROUTE_SERVICE_NULL_ARG_CHECK(service);
+	ROUTE_SERVICE_NULL_ARG_CHECK(items);
+	ROUTE_SERVICE_NULL_ARG_CHECK(found_callback);
+	ROUTE_SERVICE_CHECK_CONDITION(item_count > 0, ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+	ROUTE_SERVICE_CHECK_CONDITION(max_pending > 0, ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+
+	route_service_s *handle = (route_service_s *) service;
+	int i;
+
+	for (i = 0; i < item_count; i++) {
+		ROUTE_SERVICE_CHECK_CONDITION(items[i].waypoint_num >= 0 && (items[i].waypoint_num == 0 || items[i].waypoint_list),
+					      ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+	}
+
+	return __start_batch(handle, items, item_count, max_pending, NULL, found_callback, completed_callback, user_data,
+			     NULL, batch_id);
+}
+
+/*
+ * Route matrix
+ */
+static void __free_matrix(gpointer data)
+{
+	__matrix_request *matrix = (__matrix_request *) data;
+
+	free(matrix->distances);
+	free(matrix->durations);
+	free(matrix->item_first_cell);
+	free(matrix->next_cell);
+	free(matrix);
+}
+
+static bool __matrix_found_cb(route_error_e error, int item_index, int index, int total, route_h route, void *user_data)
+{
+	__matrix_request *matrix = (__matrix_request *) user_data;
+	double distance = 0;
+	long duration = 0;
+	int cell;
+
+	if (error != ROUTE_ERROR_NONE || route == NULL) {
+		return false;
+	}
+
+	route_get_total_distance(route, &distance);
+	route_get_total_duration(route, &duration);
+	for (cell = matrix->item_first_cell[item_index]; cell >= 0; cell = matrix->next_cell[cell]) {
+		matrix->distances[cell] = distance;
+		matrix->durations[cell] = duration;
+	}
+	matrix->found = TRUE;
+
+	/* Only the best route of each pair is needed. */
+	return false;
+}
+
+static void __matrix_completed_cb(int batch_id, int failed_count, void *user_data)
+{
+	__matrix_request *matrix = (__matrix_request *) user_data;
+
+	matrix->callback(matrix->found ? ROUTE_ERROR_NONE : ROUTE_ERROR_RESULT_NOT_FOUND, matrix->origin_count,
+			 matrix->destination_count, matrix->distances, matrix->durations, matrix->user_data);
+}
+
+static gboolean __coords_equal(const location_coords_s *a, const location_coords_s *b)
+{
+	return a->latitude == b->latitude && a->longitude == b->longitude;
+}
+
+static LocationRoutePreference *__summary_preference(route_service_s *handle)
+{
+	route_preference_s *pref = (route_preference_s *) handle->route_preference;
+	LocationRoutePreference *summary = location_route_pref_copy(pref->preference);
+
+	if (summary) {
+		location_route_pref_set_geometry_used(summary, FALSE);
+		location_route_pref_set_instruction_used(summary, FALSE);
+		location_route_pref_set_instruction_geometry_used(summary, FALSE);
+		location_route_pref_set_instruction_bounding_box_used(summary, FALSE);
+		location_route_pref_set_max_result(summary, 1);
+	}
+
+	return summary;
+}
+
+int route_service_find_matrix(route_service_h service, const location_coords_s * origins, int origin_count,
+			      const location_coords_s * destinations, int destination_count, bool symmetric, int max_pending,
+			      route_service_matrix_found_cb callback, void *user_data, int *request_id)
+{
+	ROUTE_SERVICE_NULL_ARG_CHECK(service);
+	ROUTE_SERVICE_NULL_ARG_CHECK(origins);
+	ROUTE_SERVICE_NULL_ARG_CHECK(destinations);
+	ROUTE_SERVICE_NULL_ARG_CHECK(callback);
+	ROUTE_SERVICE_CHECK_CONDITION(origin_count > 0 && destination_count > 0, ROUTE_ERROR_INVALID_PARAMETER,
+				      "ROUTE_ERROR_INVALID_PARAMETER");
+	ROUTE_SERVICE_CHECK_CONDITION(max_pending > 0, ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+	/* Every cell gets an item, the largest of the per cell allocations */
+	ROUTE_SERVICE_CHECK_CONDITION((gsize) origin_count <= G_MAXINT / sizeof(route_service_batch_item_s) / destination_count,
+				      ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+
+	route_service_s *handle = (route_service_s *) service;
+	int cell_count = origin_count * destination_count;
+	route_service_batch_item_s *items;
+	GHashTable *pairs;
+	int item_count = 0;
+	int ret;
+	int i, j;
+
+	__matrix_request *matrix = (__matrix_request *) malloc(sizeof(__matrix_request));
+	if (matrix == NULL) {
+		ROUTE_SERVICE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	memset(matrix, 0, sizeof(__matrix_request));
+
+	matrix->callback = callback;
+	matrix->user_data = user_data;
+	matrix->origin_count = origin_count;
+	matrix->destination_count = destination_count;
+	matrix->distances = (double *) malloc(sizeof(double) * cell_count);
+	matrix->durations = (long *) malloc(sizeof(long) * cell_count);
+	matrix->item_first_cell = (int *) malloc(sizeof(int) * cell_count);
+	matrix->next_cell = (int *) malloc(sizeof(int) * cell_count);
+	items = (route_service_batch_item_s *) malloc(sizeof(route_service_batch_item_s) * cell_count);
+	if (matrix->distances == NULL || matrix->durations == NULL || matrix->item_first_cell == NULL
+	    || matrix->next_cell == NULL || items == NULL) {
+		free(items);
+		__free_matrix(matrix);
+		ROUTE_SERVICE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	/* Each distinct pair becomes one batch item, and the cells answered by an item are chained from it. */
+	pairs = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, NULL);
+	for (i = 0; i < origin_count; i++) {
+		for (j = 0; j < destination_count; j++) {
+			const location_coords_s *from = &origins[i];
+			const location_coords_s *to = &destinations[j];
+			int cell = i * destination_count + j;
+			gpointer item_index;
+			gchar *key;
+
+			matrix->next_cell[cell] = -1;
+			if (__coords_equal(from, to)) {
+				matrix->distances[cell] = 0;
+				matrix->durations[cell] = 0;
+				matrix->found = TRUE;
+				continue;
+			}
+			matrix->distances[cell] = -1;
+			matrix->durations[cell] = -1;
+
+			if (symmetric && (from->latitude > to->latitude
+					  || (from->latitude == to->latitude && from->longitude > to->longitude))) {
+				const location_coords_s *tmp = from;
+				from = to;
+				to = tmp;
+			}
+			key = g_strdup_printf("%.6f,%.6f;%.6f,%.6f", from->latitude, from->longitude, to->latitude, to->longitude);
+			if (g_hash_table_lookup_extended(pairs, key, NULL, &item_index)) {
+				int item = GPOINTER_TO_INT(item_index);
+				matrix->next_cell[cell] = matrix->item_first_cell[item];
+				matrix->item_first_cell[item] = cell;
+				g_free(key);
+				continue;
+			}
+
+			items[item_count].origin = *from;
+			items[item_count].destination = *to;
+			items[item_count].waypoint_list = NULL;
+			items[item_count].waypoint_num = 0;
+			matrix->item_first_cell[item_count] = cell;
+			g_hash_table_insert(pairs, key, GINT_TO_POINTER(item_count));
+			item_count++;
+		}
+	}
+	g_hash_table_destroy(pairs);
+
+	/* A matrix whose origins are all its destinations is complete already, and is still a request to cancel. */
+	ret = __start_batch(handle, items, item_count, max_pending, __summary_preference(handle), __matrix_found_cb,
+			    __matrix_completed_cb, matrix, __free_matrix, request_id);
+	free(items);
+	if (ret != ROUTE_ERROR_NONE) {
+		__free_matrix(matrix);
+	}
+
+	return ret;
+}
+
+/*
+ * Isochrone
+ */
+static void __isochrone_cb(LocationError error, guint req_id, const route_local_isochrone_s *isochrone, gpointer userdata)
+{
+	__isochrone_request *request = (__isochrone_request *) userdata;
+	route_service_s *handle = request->service;
+	location_coords_s south_west = { 0, 0 };
+	location_coords_s north_east = { 0, 0 };
+	gboolean found = FALSE;
+
+	g_mutex_lock(&handle->lock);
+	if (g_hash_table_lookup(handle->isochrones, GUINT_TO_POINTER(request->request_id)) == request) {
+		g_hash_table_remove(handle->isochrones, GUINT_TO_POINTER(request->request_id));
+		found = TRUE;
+	}
+	g_mutex_unlock(&handle->lock);
+
+	if (!found) {
+		return;
+	}
+
+	int ret = _convert_error_code(error, "isochrone_found_callback");
+	if (ret == ROUTE_ERROR_NONE && isochrone) {
+		south_west.latitude = isochrone->south;
+		south_west.longitude = isochrone->west;
+		north_east.latitude = isochrone->north;
+		north_east.longitude = isochrone->east;
+		request->callback(ret, south_west, north_east, isochrone->rows, isochrone->columns, isochrone->durations,
+				  request->user_data);
+	} else {
+		request->callback(ret, south_west, north_east, 0, 0, NULL, request->user_data);
+	}
+	free(request);
+}
+
+static gboolean __cancel_isochrone(route_service_s *handle, guint request_id)
+{
+	__isochrone_request *request;
+
+	g_mutex_lock(&handle->lock);
+	request = g_hash_table_lookup(handle->isochrones, GUINT_TO_POINTER(request_id));
+	if (request) {
+		g_hash_table_remove(handle->isochrones, GUINT_TO_POINTER(request_id));
+	}
+	g_mutex_unlock(&handle->lock);
+
+	if (request == NULL) {
+		return FALSE;
+	}
+
+	route_local_cancel_route_request(handle->local, request->provider_id);
+	free(request);
+
+	return TRUE;
+}
+
+int route_service_find_isochrone(route_service_h service, location_coords_s origin, long max_duration, double resolution,
+				 route_service_isochrone_found_cb callback, void *user_data, int *request_id)
+{
+	ROUTE_SERVICE_NULL_ARG_CHECK(service);
+	ROUTE_SERVICE_NULL_ARG_CHECK(callback);
+	ROUTE_SERVICE_CHECK_CONDITION(max_duration > 0, ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+	ROUTE_SERVICE_CHECK_CONDITION(resolution > 0, ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
 
 	route_service_s *handle = (route_service_s *) service;
+	route_preference_s *pref = (route_preference_s *) handle->route_preference;
+	LocationPosition start;
+	guint id;
+	int ret;
+
+	/* The map service provider has no one-to-all search. */
+	ROUTE_SERVICE_CHECK_CONDITION(handle->local != NULL, ROUTE_ERROR_SERVICE_NOT_SUPPORTED,
+				      "ROUTE_ERROR_SERVICE_NOT_SUPPORTED");
 
-	ret = location_map_cancel_route_request(handle->object, request_id);
+	start.latitude = origin.latitude;
+	start.longitude = origin.longitude;
+	start.altitude = 0;
+	start.status = LOCATION_STATUS_2D_FIX;
+
+	__isochrone_request *request = (__isochrone_request *) malloc(sizeof(__isochrone_request));
+	if (request == NULL) {
+		ROUTE_SERVICE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	memset(request, 0, sizeof(__isochrone_request));
+	request->service = handle;
+	request->callback = callback;
+	request->user_data = user_data;
+
+	/* The offline provider answers from an idle callback, so it is safe to request it with the lock held. */
+	g_mutex_lock(&handle->lock);
+	request->request_id = ++handle->last_request_id;
+	if (request->request_id == 0) {
+		request->request_id = ++handle->last_request_id;
+	}
+	id = request->request_id;
+	ret = route_local_request_isochrone(handle->local, &start, max_duration, resolution, pref->preference,
+					    __isochrone_cb, request, &request->provider_id);
+	if (ret == LOCATION_ERROR_NONE) {
+		g_hash_table_insert(handle->isochrones, GUINT_TO_POINTER(request->request_id), request);
+	}
+	g_mutex_unlock(&handle->lock);
 
 	if (ret != LOCATION_ERROR_NONE) {
+		free(request);
 		return _convert_error_code(ret, __func__);
 	}
 
+	if (request_id) {
+		*request_id = id;
+	}
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_service_set_cache_policy(route_service_h service, int ttl, size_t max_size)
+{
+	ROUTE_SERVICE_NULL_ARG_CHECK(service);
+	ROUTE_SERVICE_CHECK_CONDITION(ttl >= 0, ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+
+	route_service_s *handle = (route_service_s *) service;
+
+	route_cache_set_policy(handle->cache, ttl, max_size);
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_service_set_alternative_filter(route_service_h service, double max_similarity)
+{
+	ROUTE_SERVICE_NULL_ARG_CHECK(service);
+	ROUTE_SERVICE_CHECK_CONDITION(max_similarity >= 0 && max_similarity <= 1, ROUTE_ERROR_INVALID_PARAMETER,
+				      "ROUTE_ERROR_INVALID_PARAMETER");
+
+	route_service_s *handle = (route_service_s *) service;
+
+	handle->max_similarity = max_similarity;
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_service_clear_cache(route_service_h service)
+{
+	ROUTE_SERVICE_NULL_ARG_CHECK(service);
+
+	route_service_s *handle = (route_service_s *) service;
+
+	route_cache_clear(handle->cache);
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_service_get_cache_statistics(route_service_h service, int *hits, int *misses)
+{
+	ROUTE_SERVICE_NULL_ARG_CHECK(service);
+	ROUTE_SERVICE_NULL_ARG_CHECK(hits);
+	ROUTE_SERVICE_NULL_ARG_CHECK(misses);
+
+	route_service_s *handle = (route_service_s *) service;
+	guint cache_hits;
+	guint cache_misses;
+
+	route_cache_get_statistics(handle->cache, &cache_hits, &cache_misses);
+	*hits = (int) MIN(cache_hits, G_MAXINT);
+	*misses = (int) MIN(cache_misses, G_MAXINT);
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_service_get_provider_request_count(route_service_h service, int *count)
+{
+	ROUTE_SERVICE_NULL_ARG_CHECK(service);
+	ROUTE_SERVICE_NULL_ARG_CHECK(count);
+
+	route_service_s *handle = (route_service_s *) service;
+
+	g_mutex_lock(&handle->lock);
+	*count = (int) MIN(handle->provider_requests, G_MAXINT);
+	g_mutex_unlock(&handle->lock);
+
 	return ROUTE_ERROR_NONE;
 }
@@ -0,0 +1,229 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <location/location.h>
+#include <location/location-types.h>
+#include <location/location-map-service.h>
+
+#include "route.h"
+#include "route_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_ROUTE"
+
+/*
+ * Internal macros
+ */
+#define ROUTE_CHECK_CONDITION(condition,error,msg)	\
+	if(condition) {} else	\
+	{ LOGE("[%s] %s(0x%08x)", __FUNCTION__, msg, error); return error; };	\
+
+#define ROUTE_PRINT_ERROR_CODE_RETURN(code)	\
+	LOGE("[%s] %s(0x%08x)", __FUNCTION__, #code, code); return code;	\
+
+#define ROUTE_NULL_ARG_CHECK(arg)\
+	ROUTE_CHECK_CONDITION( (arg != NULL), ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER")
+
+/* About 30 meters, so that both carriageways of a road fall in the same cells */
+#define ROUTE_SIMILARITY_CELL_SIZE 0.0003
+
+/*
+ * Internal implementation
+ */
+static guint64 __cell_key(double latitude, double longitude)
+{
+	guint32 row = (guint32) (gint32) floor(latitude / ROUTE_SIMILARITY_CELL_SIZE);
+	guint32 column = (guint32) (gint32) floor(longitude / ROUTE_SIMILARITY_CELL_SIZE);
+
+	return ((guint64) row << 32) | column;
+}
+
+/* Edges are sampled every half cell, so that no cell they cross is skipped. */
+static int __edge_samples(const route_polyline_s *polyline, int edge)
+{
+	double dlat = fabs(polyline->latitudes[edge + 1] - polyline->latitudes[edge]);
+	double dlon = fabs(polyline->longitudes[edge + 1] - polyline->longitudes[edge]);
+
+	return (int) ceil(MAX(dlat, dlon) / (ROUTE_SIMILARITY_CELL_SIZE / 2)) + 1;
+}
+
+static int __compare_keys(const void *a, const void *b)
+{
+	guint64 ka = *(const guint64 *) a;
+	guint64 kb = *(const guint64 *) b;
+
+	return ka < kb ? -1 : ka > kb;
+}
+
+route_signature_s *route_signature_new(const route_polyline_s *polyline)
+{
+	route_signature_s *signature;
+	int capacity = polyline->count > 0 ? 1 : 0;
+	int count = 0;
+	int edge;
+	int i;
+
+	for (edge = 0; edge < polyline->count - 1; edge++) {
+		capacity += __edge_samples(polyline, edge);
+	}
+
+	signature = (route_signature_s *) malloc(sizeof(route_signature_s) + capacity * sizeof(guint64));
+	if (signature == NULL) {
+		return NULL;
+	}
+	signature->cells = (guint64 *)(signature + 1);
+
+	for (edge = 0; edge < polyline->count - 1; edge++) {
+		double lat = polyline->latitudes[edge];
+		double lon = polyline->longitudes[edge];
+		double dlat = polyline->latitudes[edge + 1] - lat;
+		double dlon = polyline->longitudes[edge + 1] - lon;
+		int samples = __edge_samples(polyline, edge);
+
+		for (i = 0; i < samples; i++) {
+			guint64 key = __cell_key(lat + dlat * i / samples, lon + dlon * i / samples);
+			/* Most samples fall in the cell of the previous one */
+			if (count == 0 || signature->cells[count - 1] != key) {
+				signature->cells[count++] = key;
+			}
+		}
+	}
+	if (polyline->count > 0) {
+		signature->cells[count++] = __cell_key(polyline->latitudes[polyline->count - 1], polyline->longitudes[polyline->count - 1]);
+	}
+
+	qsort(signature->cells, count, sizeof(guint64), __compare_keys);
+	signature->count = 0;
+	for (i = 0; i < count; i++) {
+		if (signature->count == 0 || signature->cells[signature->count - 1] != signature->cells[i]) {
+			signature->cells[signature->count++] = signature->cells[i];
+		}
+	}
+
+	return signature;
+}
+
+void route_signature_free(route_signature_s *signature)
+{
+	free(signature);
+}
+
+double route_signature_similarity(const route_signature_s *a, const route_signature_s *b)
+{
+	int shared = 0;
+	int i = 0;
+	int j = 0;
+
+	if (a->count == 0 || b->count == 0) {
+		return 0;
+	}
+
+	while (i < a->count && j < b->count) {
+		if (a->cells[i] < b->cells[j]) {
+			i++;
+		} else if (a->cells[i] > b->cells[j]) {
+			j++;
+		} else {
+			shared++;
+			i++;
+			j++;
+		}
+	}
+
+	return (double) shared / MIN(a->count, b->count);
+}
+
+GList *route_similarity_filter(GList *route_list, double max_similarity)
+{
+	route_signature_s **signatures = (route_signature_s **) malloc(sizeof(route_signature_s *) * g_list_length(route_list));
+	GList *kept = NULL;
+	GList *iter;
+	int count = 0;
+	int i;
+
+	if (signatures == NULL) {
+		return g_list_copy(route_list);
+	}
+
+	for (iter = route_list; iter; iter = iter->next) {
+		route_polyline_s *polyline = route_polyline_new(iter->data);
+		route_signature_s *signature = polyline ? route_signature_new(polyline) : NULL;
+		gboolean similar = FALSE;
+
+		free(polyline);
+		/* A route that cannot be compared is kept */
+		for (i = 0; signature && i < count && !similar; i++) {
+			similar = route_signature_similarity(signature, signatures[i]) > max_similarity;
+		}
+		if (similar) {
+			route_signature_free(signature);
+			continue;
+		}
+		if (signature) {
+			signatures[count++] = signature;
+		}
+		kept = g_list_prepend(kept, iter->data);
+	}
+
+	for (i = 0; i < count; i++) {
+		route_signature_free(signatures[i]);
+	}
+	free(signatures);
+
+	return g_list_reverse(kept);
+}
+
+/*
+ * Route similarity
+ */
+int route_get_similarity(route_h route, route_h other, double *similarity)
+{
+	ROUTE_NULL_ARG_CHECK(route);
+	ROUTE_NULL_ARG_CHECK(other);
+	ROUTE_NULL_ARG_CHECK(similarity);
+
+	route_polyline_s *polyline = route_polyline_get((route_s *) route);
+	route_polyline_s *other_polyline = route_polyline_get((route_s *) other);
+	if (polyline == NULL || other_polyline == NULL) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	if (polyline->count == 0 || other_polyline->count == 0) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
+	}
+
+	route_signature_s *signature = route_signature_new(polyline);
+	route_signature_s *other_signature = route_signature_new(other_polyline);
+	if (signature == NULL || other_signature == NULL) {
+		route_signature_free(signature);
+		route_signature_free(other_signature);
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	*similarity = route_signature_similarity(signature, other_signature);
+	route_signature_free(signature);
+	route_signature_free(other_signature);
+
+	return ROUTE_ERROR_NONE;
+}
@@ -0,0 +1,432 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <location/location.h>
+#include <location/location-types.h>
+#include <location/location-map-service.h>
+
+#include "route.h"
+#include "route_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+/* The AVX2 path is built for that target alone and taken when the CPU has it, the rest keeps the baseline ISA */
+#if defined(__GNUC__) && defined(__x86_64__)
+#define ROUTE_SIMPLIFY_AVX2
+#include <immintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_ROUTE"
+
+/*
+ * Internal macros
+ */
+#define ROUTE_CHECK_CONDITION(condition,error,msg)	\
+	if(condition) {} else	\
+	{ LOGE("[%s] %s(0x%08x)", __FUNCTION__, msg, error); return error; };	\
+
+#define ROUTE_PRINT_ERROR_CODE_RETURN(code)	\
+	LOGE("[%s] %s(0x%08x)", __FUNCTION__, #code, code); return code;	\
+
+#define ROUTE_NULL_ARG_CHECK(arg)\
+	ROUTE_CHECK_CONDITION( (arg != NULL), ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER")
+
+#define ROUTE_EARTH_RADIUS 6371008.8
+
+/*
+ * Internal implementation
+ */
+
+/* Projects the points on a plane tangent at the first one, in meters */
+static void __project(const double *latitudes, const double *longitudes, int count, double *x, double *y)
+{
+	double scale = ROUTE_EARTH_RADIUS * M_PI / 180.0;
+	double x_scale = scale * cos(latitudes[0] * M_PI / 180.0);
+	int i;
+
+	for (i = 0; i < count; i++) {
+		x[i] = (longitudes[i] - longitudes[0]) * x_scale;
+		y[i] = (latitudes[i] - latitudes[0]) * scale;
+	}
+}
+
+/*
+ * Squared distances from the points @first + 1 to @last - 1 to the segment between @first and @last.
+ * Returns the largest one and its index in @index.
+ */
+static double __farthest_point_scalar(const double *x, const double *y, int from, int to, double ax, double ay,
+				      double dx, double dy, double inv_length, int *index)
+{
+	double max = -1;
+	int i;
+
+	for (i = from; i < to; i++) {
+		double px = x[i] - ax;
+		double py = y[i] - ay;
+		double t = CLAMP((px * dx + py * dy) * inv_length, 0, 1);
+		double ex = px - t * dx;
+		double ey = py - t * dy;
+		double distance = ex * ex + ey * ey;
+
+		if (distance > max) {
+			max = distance;
+			*index = i;
+		}
+	}
+
+	return max;
+}
+
+#if defined(ROUTE_SIMPLIFY_AVX2)
+/* __farthest_point() four points at a time from @i, returns the first point left for the scalar code */
+__attribute__((target("avx2")))
+static int __farthest_point_avx2(const double *x, const double *y, int i, int last, double ax, double ay, double dx,
+				 double dy, double inv_length, double *max, int *index)
+{
+	__m256d vax = _mm256_set1_pd(ax), vay = _mm256_set1_pd(ay);
+	__m256d vdx = _mm256_set1_pd(dx), vdy = _mm256_set1_pd(dy);
+	__m256d vinv = _mm256_set1_pd(inv_length);
+	__m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1);
+	__m256d vmax = _mm256_set1_pd(-1);
+	__m256d vindex = _mm256_setzero_pd();
+	__m256d lane = _mm256_set_pd(i + 3, i + 2, i + 1, i);
+	__m256d four = _mm256_set1_pd(4);
+	double maxes[4];
+	double indexes[4];
+	int k;
+
+	for (; i + 4 <= last; i += 4) {
+		__m256d px = _mm256_sub_pd(_mm256_loadu_pd(x + i), vax);
+		__m256d py = _mm256_sub_pd(_mm256_loadu_pd(y + i), vay);
+		__m256d t = _mm256_mul_pd(_mm256_add_pd(_mm256_mul_pd(px, vdx), _mm256_mul_pd(py, vdy)), vinv);
+		t = _mm256_min_pd(_mm256_max_pd(t, zero), one);
+		__m256d ex = _mm256_sub_pd(px, _mm256_mul_pd(t, vdx));
+		__m256d ey = _mm256_sub_pd(py, _mm256_mul_pd(t, vdy));
+		__m256d distance = _mm256_add_pd(_mm256_mul_pd(ex, ex), _mm256_mul_pd(ey, ey));
+		__m256d greater = _mm256_cmp_pd(distance, vmax, _CMP_GT_OQ);
+
+		vmax = _mm256_blendv_pd(vmax, distance, greater);
+		vindex = _mm256_blendv_pd(vindex, lane, greater);
+		lane = _mm256_add_pd(lane, four);
+	}
+	_mm256_storeu_pd(maxes, vmax);
+	_mm256_storeu_pd(indexes, vindex);
+	for (k = 0; k < 4; k++) {
+		if (maxes[k] > *max || (maxes[k] == *max && (int)indexes[k] < *index)) {
+			*max = maxes[k];
+			*index = (int)indexes[k];
+		}
+	}
+
+	return i;
+}
+#endif
+
+static double __farthest_point(const double *x, const double *y, int first, int last, int *index)
+{
+	double ax = x[first];
+	double ay = y[first];
+	double dx = x[last] - ax;
+	double dy = y[last] - ay;
+	double length = dx * dx + dy * dy;
+	double inv_length = length > 0 ? 1 / length : 0;
+	double max = -1;
+	int i = first + 1;
+
+#if defined(ROUTE_SIMPLIFY_AVX2)
+	if (last - i >= 4 && __builtin_cpu_supports("avx2")) {
+		i = __farthest_point_avx2(x, y, i, last, ax, ay, dx, dy, inv_length, &max, index);
+	}
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+	if (last - i >= 2) {
+		float64x2_t vax = vdupq_n_f64(ax), vay = vdupq_n_f64(ay);
+		float64x2_t vdx = vdupq_n_f64(dx), vdy = vdupq_n_f64(dy);
+		float64x2_t vinv = vdupq_n_f64(inv_length);
+		float64x2_t zero = vdupq_n_f64(0), one = vdupq_n_f64(1);
+		float64x2_t vmax = vdupq_n_f64(-1);
+		float64x2_t vindex = vdupq_n_f64(0);
+		float64x2_t lane = { i, i + 1 };
+		float64x2_t two = vdupq_n_f64(2);
+		int k;
+
+		for (; i + 2 <= last; i += 2) {
+			float64x2_t px = vsubq_f64(vld1q_f64(x + i), vax);
+			float64x2_t py = vsubq_f64(vld1q_f64(y + i), vay);
+			float64x2_t t = vmulq_f64(vfmaq_f64(vmulq_f64(px, vdx), py, vdy), vinv);
+			t = vminq_f64(vmaxq_f64(t, zero), one);
+			float64x2_t ex = vfmsq_f64(px, t, vdx);
+			float64x2_t ey = vfmsq_f64(py, t, vdy);
+			float64x2_t distance = vfmaq_f64(vmulq_f64(ex, ex), ey, ey);
+			uint64x2_t greater = vcgtq_f64(distance, vmax);
+
+			vmax = vbslq_f64(greater, distance, vmax);
+			vindex = vbslq_f64(greater, lane, vindex);
+			lane = vaddq_f64(lane, two);
+		}
+		for (k = 0; k < 2; k++) {
+			double lane_max = k ? vgetq_lane_f64(vmax, 1) : vgetq_lane_f64(vmax, 0);
+			int lane_index = (int)(k ? vgetq_lane_f64(vindex, 1) : vgetq_lane_f64(vindex, 0));
+
+			if (lane_max > max || (lane_max == max && lane_index < *index)) {
+				max = lane_max;
+				*index = lane_index;
+			}
+		}
+	}
+#endif
+
+	if (i < last) {
+		int tail_index = i;
+		double tail_max = __farthest_point_scalar(x, y, i, last, ax, ay, dx, dy, inv_length, &tail_index);
+
+		if (tail_max > max) {
+			max = tail_max;
+			*index = tail_index;
+		}
+	}
+
+	return max;
+}
+
+/* Marks the points to keep in @keep */
+static gboolean __douglas_peucker(const double *x, const double *y, int count, double tolerance, gboolean *keep)
+{
+	double limit = tolerance * tolerance;
+	int *stack = (int *) malloc(sizeof(int) * 2 * count);
+	int depth = 0;
+
+	if (stack == NULL) {
+		return FALSE;
+	}
+
+	keep[0] = keep[count - 1] = TRUE;
+	stack[depth++] = 0;
+	stack[depth++] = count - 1;
+	while (depth) {
+		int last = stack[--depth];
+		int first = stack[--depth];
+		int index = first;
+
+		if (last - first < 2) {
+			continue;
+		}
+		if (__farthest_point(x, y, first, last, &index) > limit) {
+			keep[index] = TRUE;
+			stack[depth++] = first;
+			stack[depth++] = index;
+			stack[depth++] = index;
+			stack[depth++] = last;
+		}
+	}
+
+	free(stack);
+	return TRUE;
+}
+
+typedef struct {
+	double area;
+	int index;
+} __area_item;
+
+static void __area_push(__area_item *heap, int *size, double area, int index)
+{
+	int i = (*size)++;
+
+	while (i > 0 && heap[(i - 1) / 2].area > area) {
+		heap[i] = heap[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	heap[i].area = area;
+	heap[i].index = index;
+}
+
+static __area_item __area_pop(__area_item *heap, int *size)
+{
+	__area_item top = heap[0];
+	__area_item last = heap[--(*size)];
+	int i = 0;
+
+	while (2 * i + 1 < *size) {
+		int child = 2 * i + 1;
+		if (child + 1 < *size && heap[child + 1].area < heap[child].area) {
+			child++;
+		}
+		if (heap[child].area >= last.area) {
+			break;
+		}
+		heap[i] = heap[child];
+		i = child;
+	}
+	if (*size) {
+		heap[i] = last;
+	}
+
+	return top;
+}
+
+static double __triangle_area(const double *x, const double *y, int a, int b, int c)
+{
+	return fabs((x[b] - x[a]) * (y[c] - y[a]) - (x[c] - x[a]) * (y[b] - y[a])) / 2;
+}
+
+/* Removes the point of the smallest effective area while it is below the square of @tolerance */
+static gboolean __visvalingam_whyatt(const double *x, const double *y, int count, double tolerance, gboolean *keep)
+{
+	double limit = tolerance * tolerance;
+	int *prev = (int *) malloc(sizeof(int) * count);
+	int *next = (int *) malloc(sizeof(int) * count);
+	double *area = (double *) malloc(sizeof(double) * count);
+	/* Each removal pushes at most two points again. */
+	__area_item *heap = (__area_item *) malloc(sizeof(__area_item) * 3 * count);
+	int size = 0;
+	int i;
+
+	if (prev == NULL || next == NULL || area == NULL || heap == NULL) {
+		free(prev);
+		free(next);
+		free(area);
+		free(heap);
+		return FALSE;
+	}
+
+	for (i = 0; i < count; i++) {
+		prev[i] = i - 1;
+		next[i] = i + 1;
+		keep[i] = TRUE;
+	}
+	for (i = 1; i + 1 < count; i++) {
+		area[i] = __triangle_area(x, y, i - 1, i, i + 1);
+		__area_push(heap, &size, area[i], i);
+	}
+
+	while (size) {
+		__area_item item = __area_pop(heap, &size);
+		int point = item.index;
+
+		if (!keep[point] || item.area != area[point]) {
+			continue;	/* stale entry */
+		}
+		if (item.area >= limit) {
+			break;
+		}
+
+		keep[point] = FALSE;
+		next[prev[point]] = next[point];
+		prev[next[point]] = prev[point];
+
+		/* A neighbour never gets a smaller area than the point removed before it. */
+		if (prev[point] > 0) {
+			int p = prev[point];
+			area[p] = MAX(__triangle_area(x, y, prev[p], p, next[p]), item.area);
+			__area_push(heap, &size, area[p], p);
+		}
+		if (next[point] < count - 1) {
+			int n = next[point];
+			area[n] = MAX(__triangle_area(x, y, prev[n], n, next[n]), item.area);
+			__area_push(heap, &size, area[n], n);
+		}
+	}
+
+	free(prev);
+	free(next);
+	free(area);
+	free(heap);
+	return TRUE;
+}
+
+/*
+ * Route geometry simplification
+ */
+int route_simplify_geometry(route_h route, double tolerance, route_simplify_method_e method, double **latitudes,
+			    double **longitudes, int *count)
+{
+	ROUTE_NULL_ARG_CHECK(route);
+	ROUTE_NULL_ARG_CHECK(latitudes);
+	ROUTE_NULL_ARG_CHECK(longitudes);
+	ROUTE_NULL_ARG_CHECK(count);
+	ROUTE_CHECK_CONDITION(tolerance >= 0, ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+	ROUTE_CHECK_CONDITION(method >= ROUTE_SIMPLIFY_DOUGLAS_PEUCKER && method <= ROUTE_SIMPLIFY_VISVALINGAM_WHYATT,
+			      ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+
+	const double *lats;
+	const double *lons;
+	int point_count;
+	int kept = 0;
+	gboolean done;
+	int i;
+
+	int ret = route_get_polyline(route, &lats, &lons, &point_count);
+	if (ret != ROUTE_ERROR_NONE) {
+		return ret;
+	}
+
+	double *x = (double *) malloc(sizeof(double) * 2 * point_count);
+	gboolean *keep = (gboolean *) calloc(point_count, sizeof(gboolean));
+	if (x == NULL || keep == NULL) {
+		free(x);
+		free(keep);
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	double *y = x + point_count;
+
+	__project(lats, lons, point_count, x, y);
+	if (point_count < 3) {
+		for (i = 0; i < point_count; i++) {
+			keep[i] = TRUE;
+		}
+		done = TRUE;
+	} else if (method == ROUTE_SIMPLIFY_DOUGLAS_PEUCKER) {
+		done = __douglas_peucker(x, y, point_count, tolerance, keep);
+	} else {
+		done = __visvalingam_whyatt(x, y, point_count, tolerance, keep);
+	}
+	free(x);
+
+	for (i = 0; i < point_count; i++) {
+		kept += keep[i] ? 1 : 0;
+	}
+	*latitudes = (double *) malloc(sizeof(double) * kept);
+	*longitudes = (double *) malloc(sizeof(double) * kept);
+	if (!done || *latitudes == NULL || *longitudes == NULL) {
+		free(keep);
+		free(*latitudes);
+		free(*longitudes);
+		*latitudes = *longitudes = NULL;
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	for (i = 0, kept = 0; i < point_count; i++) {
+		if (keep[i]) {
+			(*latitudes)[kept] = lats[i];
+			(*longitudes)[kept] = lons[i];
+			kept++;
+		}
+	}
+	free(keep);
+	*count = kept;
+
+	return ROUTE_ERROR_NONE;
+}
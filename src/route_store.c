@@ -0,0 +1,439 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <location/location.h>
+#include <location/location-types.h>
+#include <location/location-map-service.h>
+
+#include "route.h"
+#include "route_store.h"
+#include "route_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_ROUTE"
+
+/*
+ * Internal macros
+ */
+#define ROUTE_CHECK_CONDITION(condition,error,msg)	\
+	if(condition) {} else	\
+	{ LOGE("[%s] %s(0x%08x)", __FUNCTION__, msg, error); return error; };	\
+
+#define ROUTE_PRINT_ERROR_CODE_RETURN(code)	\
+	LOGE("[%s] %s(0x%08x)", __FUNCTION__, #code, code); return code;	\
+
+#define ROUTE_NULL_ARG_CHECK(arg)\
+	ROUTE_CHECK_CONDITION( (arg != NULL), ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER")
+
+#define ROUTE_STORE_INDEX_SUFFIX ".idx"
+
+/* The files of a store as mapped at one time. Routes read from it keep it mapped after the store has grown or closed. */
+struct _route_store_map_s {
+	volatile gint ref_count;
+	void *data;
+	gsize data_size;
+	void *index;
+	gsize index_size;
+	guint count;
+};
+
+typedef struct _route_store_s {
+	GMutex lock;
+	char *path;
+	int data_fd;
+	int index_fd;
+	gboolean writable;
+	guint64 data_size;
+	guint count;
+	route_store_map_s *map;
+} route_store_s;
+
+/*
+ * Internal implementation
+ */
+static gboolean __write_all(int fd, const void *buffer, gsize length, guint64 offset)
+{
+	const guint8 *data = buffer;
+
+	while (length > 0) {
+		ssize_t written = pwrite(fd, data, length, offset);
+		if (written < 0 && errno == EINTR) {
+			continue;
+		}
+		if (written <= 0) {
+			return FALSE;
+		}
+		data += written;
+		length -= written;
+		offset += written;
+	}
+
+	return TRUE;
+}
+
+static gboolean __read_all(int fd, void *buffer, gsize length, guint64 offset)
+{
+	guint8 *data = buffer;
+
+	while (length > 0) {
+		ssize_t read_size = pread(fd, data, length, offset);
+		if (read_size < 0 && errno == EINTR) {
+			continue;
+		}
+		if (read_size <= 0) {
+			return FALSE;
+		}
+		data += read_size;
+		length -= read_size;
+		offset += read_size;
+	}
+
+	return TRUE;
+}
+
+/* Opens a file of the store, writing its header when it is new. @size is left at the size of the file. */
+static int __open_file(const char *path, const char *magic, gboolean *writable, guint64 *size)
+{
+	route_store_header_s header;
+	struct stat st;
+	int fd = -1;
+
+	if (*writable) {
+		fd = open(path, O_RDWR | O_CREAT, 0644);
+	}
+	if (fd < 0) {
+		fd = open(path, O_RDONLY);
+		*writable = FALSE;
+	}
+	if (fd < 0) {
+		LOGE("[%s] Fail to open %s", __FUNCTION__, path);
+		return -1;
+	}
+	if (fstat(fd, &st) != 0) {
+		LOGE("[%s] Fail to open %s", __FUNCTION__, path);
+		close(fd);
+		return -1;
+	}
+
+	if (st.st_size == 0 && *writable) {
+		memcpy(header.magic, magic, 4);
+		header.version = ROUTE_STORE_VERSION;
+		if (!__write_all(fd, &header, sizeof(header), 0)) {
+			LOGE("[%s] Fail to write %s", __FUNCTION__, path);
+			close(fd);
+			return -1;
+		}
+		*size = sizeof(header);
+		return fd;
+	}
+
+	if (st.st_size < (off_t) sizeof(header) || !__read_all(fd, &header, sizeof(header), 0)
+	    || memcmp(header.magic, magic, 4) != 0 || header.version != ROUTE_STORE_VERSION) {
+		LOGE("[%s] Unsupported store file %s", __FUNCTION__, path);
+		close(fd);
+		return -1;
+	}
+	*size = st.st_size;
+
+	return fd;
+}
+
+/*
+ * Routes are written before their index entry, so a store cut short while appending can only end with entries
+ * whose route is missing, or with bytes that no entry refers to. Both are dropped, and overwritten by the next append.
+ */
+static gboolean __recover(route_store_s *store, guint64 data_file_size, guint64 index_file_size)
+{
+	route_store_entry_s entry;
+
+	store->count = (index_file_size - sizeof(route_store_header_s)) / sizeof(route_store_entry_s);
+	store->data_size = sizeof(route_store_header_s);
+
+	while (store->count > 0) {
+		if (!__read_all(store->index_fd, &entry, sizeof(entry), sizeof(route_store_header_s) + (guint64) (store->count - 1) * sizeof(entry))) {
+			return FALSE;
+		}
+		if (entry.offset >= sizeof(route_store_header_s) && entry.length <= data_file_size
+		    && entry.offset <= data_file_size - entry.length) {
+			store->data_size = entry.offset + entry.length;
+			break;
+		}
+		store->count--;
+	}
+
+	return TRUE;
+}
+
+static route_store_map_s *__map_new(route_store_s *store)
+{
+	route_store_map_s *map = (route_store_map_s *) malloc(sizeof(route_store_map_s));
+
+	if (map == NULL) {
+		return NULL;
+	}
+
+	map->ref_count = 1;
+	map->count = store->count;
+	map->data_size = store->data_size;
+	map->index_size = sizeof(route_store_header_s) + (gsize) store->count * sizeof(route_store_entry_s);
+
+	/* Appends only write past what is mapped, so the pages seen by the routes never change. */
+	map->data = mmap(NULL, map->data_size, PROT_READ, MAP_SHARED, store->data_fd, 0);
+	if (map->data == MAP_FAILED) {
+		LOGE("[%s] Fail to map %s", __FUNCTION__, store->path);
+		free(map);
+		return NULL;
+	}
+	map->index = mmap(NULL, map->index_size, PROT_READ, MAP_SHARED, store->index_fd, 0);
+	if (map->index == MAP_FAILED) {
+		LOGE("[%s] Fail to map the index of %s", __FUNCTION__, store->path);
+		munmap(map->data, map->data_size);
+		free(map);
+		return NULL;
+	}
+
+	return map;
+}
+
+route_s *route_record_new(route_store_map_s *map, const guint8 *data, gsize length)
+{
+	/* The record follows the handle in the same block, and so do the bytes of a route no mapping holds. */
+	route_s *route = (route_s *) malloc(sizeof(route_s) + sizeof(route_record_s) + (map ? 0 : length));
+	route_record_s *record;
+
+	if (route == NULL) {
+		return NULL;
+	}
+	record = (route_record_s *)(route + 1);
+	if (map == NULL) {
+		memcpy(record + 1, data, length);
+		data = (const guint8 *)(record + 1);
+	}
+
+	if (!route_view_open(data, length, &record->item)) {
+		LOGE("[%s] Corrupted route record", __FUNCTION__);
+		free(route);
+		return NULL;
+	}
+
+	if (map) {
+		g_atomic_int_inc(&map->ref_count);
+	}
+	record->map = map;
+	record->data = data;
+	record->length = length;
+
+	route->route = NULL;
+	route->request_id = record->item.request_id;
+	route->ref_count = 1;
+	route->response = NULL;
+	route->record = record;
+	route->polyline = NULL;
+	route->locator = NULL;
+	route->timing = NULL;
+	route->bvh = NULL;
+
+	return route;
+}
+
+void route_store_map_unref(route_store_map_s *map)
+{
+	if (map == NULL || !g_atomic_int_dec_and_test(&map->ref_count)) {
+		return;
+	}
+
+	munmap(map->data, map->data_size);
+	munmap(map->index, map->index_size);
+	free(map);
+}
+
+/*
+ * Route store
+ */
+int route_store_open(const char *path, route_store_h *store)
+{
+	ROUTE_NULL_ARG_CHECK(path);
+	ROUTE_NULL_ARG_CHECK(store);
+
+	route_store_s *handle = (route_store_s *) malloc(sizeof(route_store_s));
+	if (handle == NULL) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	memset(handle, 0, sizeof(route_store_s));
+
+	char *index_path = g_strdup_printf("%s%s", path, ROUTE_STORE_INDEX_SUFFIX);
+	guint64 data_file_size = 0;
+	guint64 index_file_size = 0;
+	gboolean index_writable;
+
+	handle->path = g_strdup(path);
+	handle->writable = TRUE;
+	handle->data_fd = __open_file(path, ROUTE_STORE_MAGIC, &handle->writable, &data_file_size);
+	index_writable = handle->writable;
+	handle->index_fd = handle->data_fd < 0 ? -1 : __open_file(index_path, ROUTE_STORE_INDEX_MAGIC, &index_writable, &index_file_size);
+	handle->writable = handle->writable && index_writable;
+	g_free(index_path);
+
+	if (handle->index_fd < 0 || !__recover(handle, data_file_size, index_file_size)) {
+		if (handle->data_fd >= 0) {
+			close(handle->data_fd);
+		}
+		if (handle->index_fd >= 0) {
+			close(handle->index_fd);
+		}
+		g_free(handle->path);
+		free(handle);
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_SERVICE_NOT_AVAILABLE);
+	}
+
+	g_mutex_init(&handle->lock);
+	*store = (route_store_h) handle;
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_store_close(route_store_h store)
+{
+	ROUTE_NULL_ARG_CHECK(store);
+
+	route_store_s *handle = (route_store_s *) store;
+
+	route_store_map_unref(handle->map);
+	close(handle->data_fd);
+	close(handle->index_fd);
+	g_mutex_clear(&handle->lock);
+	g_free(handle->path);
+	free(handle);
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_store_append(route_store_h store, route_h route, int *index)
+{
+	ROUTE_NULL_ARG_CHECK(store);
+	ROUTE_NULL_ARG_CHECK(route);
+	ROUTE_NULL_ARG_CHECK(index);
+
+	route_store_s *handle = (route_store_s *) store;
+	route_store_entry_s entry;
+	unsigned char *buffer;
+	int length;
+	int ret;
+
+	if (!handle->writable) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_SERVICE_NOT_AVAILABLE);
+	}
+
+	ret = route_serialize(route, &buffer, &length);
+	if (ret != ROUTE_ERROR_NONE) {
+		return ret;
+	}
+
+	g_mutex_lock(&handle->lock);
+	if (handle->count >= G_MAXINT) {
+		g_mutex_unlock(&handle->lock);
+		free(buffer);
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_SERVICE_NOT_AVAILABLE);
+	}
+	entry.offset = handle->data_size;
+	entry.length = length;
+	if (!__write_all(handle->data_fd, buffer, length, entry.offset)
+	    || !__write_all(handle->index_fd, &entry, sizeof(entry), sizeof(route_store_header_s) + (guint64) handle->count * sizeof(entry))) {
+		g_mutex_unlock(&handle->lock);
+		free(buffer);
+		LOGE("[%s] Fail to write %s", __FUNCTION__, handle->path);
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_SERVICE_NOT_AVAILABLE);
+	}
+	handle->data_size += length;
+	*index = handle->count++;
+	g_mutex_unlock(&handle->lock);
+	free(buffer);
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_store_get_count(route_store_h store, int *count)
+{
+	ROUTE_NULL_ARG_CHECK(store);
+	ROUTE_NULL_ARG_CHECK(count);
+
+	route_store_s *handle = (route_store_s *) store;
+
+	g_mutex_lock(&handle->lock);
+	*count = handle->count;
+	g_mutex_unlock(&handle->lock);
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_store_get_route(route_store_h store, int index, route_h *route)
+{
+	ROUTE_NULL_ARG_CHECK(store);
+	ROUTE_NULL_ARG_CHECK(route);
+
+	route_store_s *handle = (route_store_s *) store;
+	route_store_map_s *map;
+
+	g_mutex_lock(&handle->lock);
+	if (index < 0 || (guint) index >= handle->count) {
+		g_mutex_unlock(&handle->lock);
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_INVALID_PARAMETER);
+	}
+	/* Routes appended since the last mapping need a larger one. The old one lives on in the routes read from it. */
+	if (handle->map == NULL || (guint) index >= handle->map->count) {
+		map = __map_new(handle);
+		if (map == NULL) {
+			g_mutex_unlock(&handle->lock);
+			ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_SERVICE_NOT_AVAILABLE);
+		}
+		route_store_map_unref(handle->map);
+		handle->map = map;
+	}
+	map = handle->map;
+	g_atomic_int_inc(&map->ref_count);
+	g_mutex_unlock(&handle->lock);
+
+	/* Only the layout was checked when opening, so the entry is checked before the route is read. */
+	const route_store_entry_s *entry = (const route_store_entry_s *)((const guint8 *) map->index + sizeof(route_store_header_s)) + index;
+	route_s *record_route = NULL;
+
+	if (entry->offset >= sizeof(route_store_header_s) && entry->length <= map->data_size
+	    && entry->offset <= map->data_size - entry->length) {
+		record_route = route_record_new(map, (const guint8 *) map->data + entry->offset, entry->length);
+	}
+	route_store_map_unref(map);
+	if (record_route == NULL) {
+		LOGE("[%s] Corrupted route %d in %s", __FUNCTION__, index, handle->path);
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_SERVICE_NOT_AVAILABLE);
+	}
+
+	*route = (route_h) record_route;
+
+	return ROUTE_ERROR_NONE;
+}
@@ -0,0 +1,315 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <location/location.h>
+#include <location/location-types.h>
+#include <location/location-map-service.h>
+
+#include "route.h"
+#include "route_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_ROUTE"
+
+/*
+ * Internal macros
+ */
+#define ROUTE_CHECK_CONDITION(condition,error,msg)	\
+	if(condition) {} else	\
+	{ LOGE("[%s] %s(0x%08x)", __FUNCTION__, msg, error); return error; };	\
+
+#define ROUTE_PRINT_ERROR_CODE_RETURN(code)	\
+	LOGE("[%s] %s(0x%08x)", __FUNCTION__, #code, code); return code;	\
+
+#define ROUTE_NULL_ARG_CHECK(arg)\
+	ROUTE_CHECK_CONDITION( (arg != NULL), ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER")
+
+/*
+ * Internal implementation
+ */
+/* Steps of the route, a segment without any counting as one. Only counts them when @steps is NULL. */
+static int __walk_steps(LocationRoute *route, route_timing_step_s *steps)
+{
+	GList *seg_list;
+	GList *step_list;
+	int segment_index = 0;
+	int step_index;
+	int i = 0;
+
+	for (seg_list = location_route_get_route_segment(route); seg_list; seg_list = seg_list->next, segment_index++) {
+		LocationRouteSegment *segment = seg_list->data;
+
+		step_list = location_route_segment_get_route_step(segment);
+		if (step_list == NULL) {
+			if (steps) {
+				steps[i].distance = location_route_segment_get_distance(segment);
+				steps[i].duration = location_route_segment_get_duration(segment);
+				steps[i].segment_index = segment_index;
+				steps[i].step_index = -1;
+			}
+			i++;
+			continue;
+		}
+		for (step_index = 0; step_list; step_list = step_list->next, step_index++) {
+			if (steps) {
+				steps[i].distance = location_route_step_get_distance(step_list->data);
+				steps[i].duration = location_route_step_get_duration(step_list->data);
+				steps[i].segment_index = segment_index;
+				steps[i].step_index = step_index;
+			}
+			i++;
+		}
+	}
+
+	return i;
+}
+
+/* The same walk over a route read in place */
+static int __walk_steps_view(const route_view_item_s *route, route_timing_step_s *steps)
+{
+	route_view_s seg_view = route->children;
+	route_view_item_s segment;
+	route_view_item_s step;
+	int segment_index;
+	int step_index;
+	int i = 0;
+
+	for (segment_index = 0; segment_index < (int) route->child_count
+	     && route_view_read_item(&seg_view, ROUTE_VIEW_SEGMENT, &segment); segment_index++) {
+		route_view_s step_view = segment.children;
+
+		if (segment.child_count == 0) {
+			if (steps) {
+				steps[i].distance = segment.distance;
+				steps[i].duration = segment.duration;
+				steps[i].segment_index = segment_index;
+				steps[i].step_index = -1;
+			}
+			i++;
+			continue;
+		}
+		for (step_index = 0; step_index < (int) segment.child_count
+		     && route_view_read_item(&step_view, ROUTE_VIEW_STEP, &step); step_index++) {
+			if (steps) {
+				steps[i].distance = step.distance;
+				steps[i].duration = step.duration;
+				steps[i].segment_index = segment_index;
+				steps[i].step_index = step_index;
+			}
+			i++;
+		}
+	}
+
+	return i;
+}
+
+/* Lays the steps along the route geometry, and gives the step of each edge */
+static void __locate_steps(route_timing_s *timing, const route_polyline_s *polyline)
+{
+	route_timing_step_s *steps = timing->steps;
+	int edge;
+	int i;
+
+	for (i = 0; i < timing->step_count; i++) {
+		steps[i].start = -1;
+	}
+
+	/* An edge belongs to the step its end point comes from, and the steps come in route order. */
+	for (edge = 0, i = 0; edge < polyline->count - 1; edge++) {
+		int segment_index = polyline->segment_indexes[edge + 1];
+		int step_index = polyline->step_indexes[edge + 1];
+
+		while (i < timing->step_count - 1
+		       && (steps[i].segment_index != segment_index || steps[i].step_index != step_index)) {
+			i++;
+		}
+		if (steps[i].start < 0) {
+			steps[i].start = polyline->offsets[edge];
+		}
+		steps[i].end = polyline->offsets[edge + 1];
+		timing->edge_steps[edge] = i;
+	}
+
+	/* A step whose points all merged into its neighbours takes no length. */
+	for (i = 0; i < timing->step_count; i++) {
+		if (steps[i].start < 0) {
+			steps[i].start = steps[i].end = i > 0 ? steps[i - 1].end : 0;
+		}
+	}
+
+	steps[0].elapsed = 0;
+	for (i = 1; i < timing->step_count; i++) {
+		steps[i].elapsed = steps[i - 1].elapsed + steps[i - 1].duration;
+	}
+	steps[timing->step_count - 1].distance_after = 0;
+	steps[timing->step_count - 1].duration_after = 0;
+	for (i = timing->step_count - 2; i >= 0; i--) {
+		steps[i].distance_after = steps[i + 1].distance_after + steps[i + 1].distance;
+		steps[i].duration_after = steps[i + 1].duration_after + steps[i + 1].duration;
+	}
+}
+
+static route_timing_s *__timing_new(route_s *route)
+{
+	route_polyline_s *polyline = route_polyline_get(route);
+	route_timing_s *timing;
+	int step_count;
+
+	if (polyline == NULL || polyline->count < 2) {
+		return NULL;
+	}
+
+	/* A route read in place is walked as it is, rather than decoded whole */
+	step_count = route->record ? __walk_steps_view(&route->record->item, NULL) : __walk_steps(route->route, NULL);
+	if (step_count == 0) {
+		return NULL;
+	}
+
+	timing = (route_timing_s *) malloc(sizeof(route_timing_s) + step_count * sizeof(route_timing_step_s)
+					   + (polyline->count - 1) * sizeof(int));
+	if (timing == NULL) {
+		return NULL;
+	}
+	timing->step_count = step_count;
+	timing->steps = (route_timing_step_s *)(timing + 1);
+	timing->edge_steps = (int *)(timing->steps + step_count);
+
+	if (route->record) {
+		__walk_steps_view(&route->record->item, timing->steps);
+	} else {
+		__walk_steps(route->route, timing->steps);
+	}
+	__locate_steps(timing, polyline);
+
+	return timing;
+}
+
+static long __elapsed_at(const route_timing_s *timing, double offset)
+{
+	const route_timing_step_s *step = &timing->steps[route_timing_find_step(timing, offset)];
+
+	return step->elapsed + (long) (step->duration * route_timing_step_progress(step, offset) + 0.5);
+}
+
+route_timing_s *route_timing_get(route_s *route)
+{
+	route_timing_s *timing = g_atomic_pointer_get(&route->timing);
+
+	if (timing == NULL) {
+		timing = __timing_new(route);
+		if (timing == NULL) {
+			return NULL;
+		}
+		timing = route_publish_lazy((gpointer *) &route->timing, timing, (GDestroyNotify) route_timing_free);
+	}
+
+	return timing;
+}
+
+void route_timing_free(route_timing_s *timing)
+{
+	free(timing);
+}
+
+int route_timing_find_step(const route_timing_s *timing, double offset)
+{
+	/* The first step ending at or after @offset */
+	int low = 0;
+	int high = timing->step_count - 1;
+
+	while (low < high) {
+		int middle = (low + high) / 2;
+		if (timing->steps[middle].end >= offset) {
+			high = middle;
+		} else {
+			low = middle + 1;
+		}
+	}
+
+	return low;
+}
+
+double route_timing_step_progress(const route_timing_step_s *step, double offset)
+{
+	if (step->end <= step->start) {
+		return offset >= step->end ? 1 : 0;
+	}
+
+	return CLAMP((offset - step->start) / (step->end - step->start), 0, 1);
+}
+
+/*
+ * Elapsed time along a route
+ */
+int route_get_elapsed_time_at_distance(route_h route, double distance, long *elapsed)
+{
+	ROUTE_NULL_ARG_CHECK(route);
+	ROUTE_NULL_ARG_CHECK(elapsed);
+
+	route_s *handle = (route_s *) route;
+	route_polyline_s *polyline = route_polyline_get(handle);
+	if (polyline == NULL) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	if (polyline->count < 2) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
+	}
+	ROUTE_CHECK_CONDITION(distance >= 0 && distance <= polyline->offsets[polyline->count - 1],
+			      ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+
+	route_timing_s *timing = route_timing_get(handle);
+	if (timing == NULL) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	*elapsed = __elapsed_at(timing, distance);
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_get_elapsed_time_at_position(route_h route, location_coords_s coords, long *elapsed)
+{
+	ROUTE_NULL_ARG_CHECK(route);
+	ROUTE_NULL_ARG_CHECK(elapsed);
+
+	route_s *handle = (route_s *) route;
+	route_polyline_s *polyline = route_polyline_get(handle);
+	if (polyline == NULL) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	if (polyline->count < 2) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
+	}
+
+	route_timing_s *timing = route_timing_get(handle);
+	route_locator_snap_s snap;
+	if (timing == NULL || !route_locator_find_nearest(handle, coords.latitude, coords.longitude, &snap)) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	double offset = polyline->offsets[snap.edge] + (polyline->offsets[snap.edge + 1] - polyline->offsets[snap.edge]) * snap.ratio;
+	*elapsed = __elapsed_at(timing, offset);
+
+	return ROUTE_ERROR_NONE;
+}
@@ -0,0 +1,238 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+#include <location/location.h>
+#include <location/location-types.h>
+#include <location/location-map-service.h>
+
+#include "route.h"
+#include "route_tracker.h"
+#include "route_private.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <dlog.h>
+
+#ifdef LOG_TAG
+#undef LOG_TAG
+#endif
+#define LOG_TAG "TIZEN_N_ROUTE"
+
+/*
+ * Internal macros
+ */
+#define ROUTE_CHECK_CONDITION(condition,error,msg)	\
+	if(condition) {} else	\
+	{ LOGE("[%s] %s(0x%08x)", __FUNCTION__, msg, error); return error; };	\
+
+#define ROUTE_PRINT_ERROR_CODE_RETURN(code)	\
+	LOGE("[%s] %s(0x%08x)", __FUNCTION__, #code, code); return code;	\
+
+#define ROUTE_NULL_ARG_CHECK(arg)\
+	ROUTE_CHECK_CONDITION( (arg != NULL), ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER")
+
+/* Edges searched behind and ahead of the last matched one, before searching the whole route */
+#define ROUTE_TRACKER_WINDOW_BEHIND 2
+#define ROUTE_TRACKER_WINDOW_AHEAD 16
+
+typedef struct _route_tracker_s {
+	route_h route;
+	route_polyline_s *polyline;
+	route_timing_s *timing;
+	double off_route_distance;
+	int edge;
+	double ratio;
+	int step;
+	gboolean off_route;
+} route_tracker_s;
+
+/*
+ * Internal implementation
+ */
+/* The part of the current step still ahead of the matched position */
+static double __step_remaining(route_tracker_s *tracker)
+{
+	route_polyline_s *polyline = tracker->polyline;
+	double offset = polyline->offsets[tracker->edge]
+		+ (polyline->offsets[tracker->edge + 1] - polyline->offsets[tracker->edge]) * tracker->ratio;
+
+	return 1 - route_timing_step_progress(&tracker->timing->steps[tracker->step], offset);
+}
+
+/*
+ * Route tracker module
+ */
+int route_tracker_create(route_h route, double off_route_distance, route_tracker_h * tracker)
+{
+	ROUTE_NULL_ARG_CHECK(route);
+	ROUTE_NULL_ARG_CHECK(tracker);
+	ROUTE_CHECK_CONDITION(off_route_distance > 0, ROUTE_ERROR_INVALID_PARAMETER, "ROUTE_ERROR_INVALID_PARAMETER");
+
+	route_tracker_s *handle = (route_tracker_s *) calloc(1, sizeof(route_tracker_s));
+	if (handle == NULL) {
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	int ret = route_clone(&handle->route, route);
+	if (ret != ROUTE_ERROR_NONE) {
+		free(handle);
+		return ret;
+	}
+
+	handle->polyline = route_polyline_get((route_s *) handle->route);
+	if (handle->polyline == NULL) {
+		route_tracker_destroy(handle);
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+	if (handle->polyline->count < 2) {
+		route_tracker_destroy(handle);
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_RESULT_NOT_FOUND);
+	}
+
+	handle->timing = route_timing_get((route_s *) handle->route);
+	if (handle->timing == NULL) {
+		route_tracker_destroy(handle);
+		ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+	}
+
+	handle->off_route_distance = off_route_distance;
+	handle->edge = 0;
+	handle->ratio = 0;
+	handle->step = handle->timing->edge_steps[0];
+	handle->off_route = FALSE;
+
+	*tracker = (route_tracker_h) handle;
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_tracker_destroy(route_tracker_h tracker)
+{
+	ROUTE_NULL_ARG_CHECK(tracker);
+
+	route_tracker_s *handle = (route_tracker_s *) tracker;
+	route_destroy(handle->route);
+	free(handle);
+	handle = NULL;
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_tracker_update(route_tracker_h tracker, location_coords_s position)
+{
+	ROUTE_NULL_ARG_CHECK(tracker);
+
+	route_tracker_s *handle = (route_tracker_s *) tracker;
+	route_polyline_s *polyline = handle->polyline;
+	int first = MAX(0, handle->edge - ROUTE_TRACKER_WINDOW_BEHIND);
+	int last = MIN(polyline->count - 2, handle->edge + ROUTE_TRACKER_WINDOW_AHEAD);
+	route_locator_snap_s snap = { -1, 0, G_MAXDOUBLE };
+	int edge;
+
+	for (edge = first; edge <= last; edge++) {
+		double ratio;
+		double distance = route_locator_snap_edge(polyline, edge, position.latitude, position.longitude, &ratio);
+
+		if (distance < snap.distance) {
+			snap.edge = edge;
+			snap.ratio = ratio;
+			snap.distance = distance;
+		}
+	}
+
+	/* Lost the route near the last match, after a gap in the fixes or a detour */
+	if (snap.distance > handle->off_route_distance) {
+		if (!route_locator_find_nearest((route_s *) handle->route, position.latitude, position.longitude, &snap)) {
+			ROUTE_PRINT_ERROR_CODE_RETURN(ROUTE_ERROR_OUT_OF_MEMORY);
+		}
+	}
+
+	handle->off_route = snap.distance > handle->off_route_distance;
+	if (!handle->off_route) {
+		handle->edge = snap.edge;
+		handle->ratio = snap.ratio;
+		handle->step = handle->timing->edge_steps[snap.edge];
+	}
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_tracker_get_matched_position(route_tracker_h tracker, location_coords_s * position)
+{
+	ROUTE_NULL_ARG_CHECK(tracker);
+	ROUTE_NULL_ARG_CHECK(position);
+
+	route_tracker_s *handle = (route_tracker_s *) tracker;
+	route_polyline_s *polyline = handle->polyline;
+	int edge = handle->edge;
+
+	position->latitude = polyline->latitudes[edge] + (polyline->latitudes[edge + 1] - polyline->latitudes[edge]) * handle->ratio;
+	position->longitude = polyline->longitudes[edge] + (polyline->longitudes[edge + 1] - polyline->longitudes[edge]) * handle->ratio;
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_tracker_get_remaining_distance(route_tracker_h tracker, double *distance)
+{
+	ROUTE_NULL_ARG_CHECK(tracker);
+	ROUTE_NULL_ARG_CHECK(distance);
+
+	route_tracker_s *handle = (route_tracker_s *) tracker;
+	route_timing_step_s *step = &handle->timing->steps[handle->step];
+
+	*distance = step->distance * __step_remaining(handle) + step->distance_after;
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_tracker_get_remaining_duration(route_tracker_h tracker, long *duration)
+{
+	ROUTE_NULL_ARG_CHECK(tracker);
+	ROUTE_NULL_ARG_CHECK(duration);
+
+	route_tracker_s *handle = (route_tracker_s *) tracker;
+	route_timing_step_s *step = &handle->timing->steps[handle->step];
+
+	*duration = (long) (step->duration * __step_remaining(handle) + 0.5) + step->duration_after;
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_tracker_get_current_step(route_tracker_h tracker, int *segment_index, int *step_index)
+{
+	ROUTE_NULL_ARG_CHECK(tracker);
+	ROUTE_NULL_ARG_CHECK(segment_index);
+	ROUTE_NULL_ARG_CHECK(step_index);
+
+	route_tracker_s *handle = (route_tracker_s *) tracker;
+	*segment_index = handle->timing->steps[handle->step].segment_index;
+	*step_index = handle->timing->steps[handle->step].step_index;
+
+	return ROUTE_ERROR_NONE;
+}
+
+int route_tracker_is_off_route(route_tracker_h tracker, bool *off_route)
+{
+	ROUTE_NULL_ARG_CHECK(tracker);
+	ROUTE_NULL_ARG_CHECK(off_route);
+
+	route_tracker_s *handle = (route_tracker_s *) tracker;
+	*off_route = handle->off_route;
+
+	return ROUTE_ERROR_NONE;
+}
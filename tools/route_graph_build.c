@@ -0,0 +1,697 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/*
+ * Builds a road graph file for the offline route service from an OpenStreetMap XML extract.
+ * PBF extracts have to be converted first, e.g. with "osmium cat input.osm.pbf -o input.osm".
+ *
+ * usage: route_graph_build <input osm> <output graph>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <glib.h>
+
+#include <route_private.h>
+
+#define BUILD_CHUNK_SIZE 65536
+#define BUILD_NO_NODE G_MAXUINT32
+#define BUILD_MIN_CELL_SIZE 1000	/* degree * 1e6 */
+#define BUILD_EDGES_PER_CELL 4
+
+typedef struct {
+	gint64 id;
+	gint32 lat;
+	gint32 lon;
+} build_node_s;
+
+typedef struct {
+	guint first;
+	guint count;
+	double speed;
+	int oneway;
+} build_way_s;
+
+typedef struct {
+	guint32 source;
+	guint32 target;
+	float distance;
+	float duration;
+	guint32 shape_first;
+	guint32 shape_count;
+	gboolean reversed;
+} build_edge_s;
+
+typedef struct {
+	gint32 lat;
+	gint32 lon;
+} build_point_s;
+
+typedef struct {
+	GArray *nodes;
+	GArray *ways;
+	GArray *refs;
+
+	/* tags of the way being parsed */
+	gboolean in_way;
+	guint way_first;
+	gchar *highway;
+	gchar *oneway;
+	gchar *maxspeed;
+	gchar *junction;
+	gchar *access;
+
+	guint32 *ref_node;
+	guint32 *graph_node;
+	guint32 node_count;
+	GArray *edges;
+	GArray *shape;
+} build_s;
+
+/* Default speeds in km/h, for the highway types cars may use */
+static const struct {
+	const char *highway;
+	double speed;
+} speeds[] = {
+	{ "motorway", 100 }, { "motorway_link", 60 },
+	{ "trunk", 80 }, { "trunk_link", 50 },
+	{ "primary", 60 }, { "primary_link", 45 },
+	{ "secondary", 50 }, { "secondary_link", 40 },
+	{ "tertiary", 40 }, { "tertiary_link", 30 },
+	{ "unclassified", 30 }, { "residential", 25 },
+	{ "living_street", 10 }, { "service", 15 }, { "road", 25 },
+};
+
+static const gchar *find_attribute(const gchar **names, const gchar **values, const gchar *name)
+{
+	int i;
+
+	for (i = 0; names[i]; i++) {
+		if (strcmp(names[i], name) == 0) {
+			return values[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void clear_tags(build_s *ctx)
+{
+	g_free(ctx->highway);
+	g_free(ctx->oneway);
+	g_free(ctx->maxspeed);
+	g_free(ctx->junction);
+	g_free(ctx->access);
+	ctx->highway = NULL;
+	ctx->oneway = NULL;
+	ctx->maxspeed = NULL;
+	ctx->junction = NULL;
+	ctx->access = NULL;
+}
+
+static void start_element(GMarkupParseContext *context, const gchar *element_name, const gchar **attribute_names,
+			  const gchar **attribute_values, gpointer user_data, GError **error)
+{
+	build_s *ctx = (build_s *) user_data;
+
+	if (strcmp(element_name, "node") == 0) {
+		const gchar *id = find_attribute(attribute_names, attribute_values, "id");
+		const gchar *lat = find_attribute(attribute_names, attribute_values, "lat");
+		const gchar *lon = find_attribute(attribute_names, attribute_values, "lon");
+		build_node_s node;
+
+		if (id && lat && lon) {
+			node.id = g_ascii_strtoll(id, NULL, 10);
+			node.lat = (gint32) lround(g_ascii_strtod(lat, NULL) * 1000000.0);
+			node.lon = (gint32) lround(g_ascii_strtod(lon, NULL) * 1000000.0);
+			g_array_append_val(ctx->nodes, node);
+		}
+	} else if (strcmp(element_name, "way") == 0) {
+		ctx->in_way = TRUE;
+		ctx->way_first = ctx->refs->len;
+	} else if (ctx->in_way && strcmp(element_name, "nd") == 0) {
+		const gchar *ref = find_attribute(attribute_names, attribute_values, "ref");
+
+		if (ref) {
+			gint64 id = g_ascii_strtoll(ref, NULL, 10);
+			g_array_append_val(ctx->refs, id);
+		}
+	} else if (ctx->in_way && strcmp(element_name, "tag") == 0) {
+		const gchar *key = find_attribute(attribute_names, attribute_values, "k");
+		const gchar *value = find_attribute(attribute_names, attribute_values, "v");
+		gchar **tag = NULL;
+
+		if (key == NULL || value == NULL) {
+			return;
+		}
+		if (strcmp(key, "highway") == 0) {
+			tag = &ctx->highway;
+		} else if (strcmp(key, "oneway") == 0) {
+			tag = &ctx->oneway;
+		} else if (strcmp(key, "maxspeed") == 0) {
+			tag = &ctx->maxspeed;
+		} else if (strcmp(key, "junction") == 0) {
+			tag = &ctx->junction;
+		} else if (strcmp(key, "access") == 0 || strcmp(key, "motor_vehicle") == 0) {
+			tag = &ctx->access;
+		}
+		if (tag) {
+			g_free(*tag);
+			*tag = g_strdup(value);
+		}
+	}
+}
+
+/* Returns the speed of the way in m/s, or 0 if cars may not use it */
+static double way_speed(build_s *ctx)
+{
+	double speed = 0;
+	guint i;
+
+	if (ctx->highway == NULL
+	    || (ctx->access && (strcmp(ctx->access, "no") == 0 || strcmp(ctx->access, "private") == 0))) {
+		return 0;
+	}
+	for (i = 0; i < G_N_ELEMENTS(speeds); i++) {
+		if (strcmp(ctx->highway, speeds[i].highway) == 0) {
+			speed = speeds[i].speed;
+			break;
+		}
+	}
+	if (speed > 0 && ctx->maxspeed) {
+		gchar *end = NULL;
+		double maxspeed = g_ascii_strtod(ctx->maxspeed, &end);
+
+		if (maxspeed > 0) {
+			speed = (end && strstr(end, "mph")) ? maxspeed * 1.609344 : maxspeed;
+		}
+	}
+
+	return speed / 3.6;
+}
+
+static int way_oneway(build_s *ctx)
+{
+	if (ctx->oneway) {
+		if (strcmp(ctx->oneway, "yes") == 0 || strcmp(ctx->oneway, "true") == 0 || strcmp(ctx->oneway, "1") == 0) {
+			return 1;
+		}
+		if (strcmp(ctx->oneway, "-1") == 0 || strcmp(ctx->oneway, "reverse") == 0) {
+			return -1;
+		}
+		return 0;
+	}
+	if ((ctx->junction && strcmp(ctx->junction, "roundabout") == 0)
+	    || strcmp(ctx->highway, "motorway") == 0 || strcmp(ctx->highway, "motorway_link") == 0) {
+		return 1;
+	}
+
+	return 0;
+}
+
+static void end_element(GMarkupParseContext *context, const gchar *element_name, gpointer user_data, GError **error)
+{
+	build_s *ctx = (build_s *) user_data;
+	build_way_s way;
+
+	if (strcmp(element_name, "way") != 0) {
+		return;
+	}
+
+	way.first = ctx->way_first;
+	way.count = ctx->refs->len - ctx->way_first;
+	way.speed = way_speed(ctx);
+	if (way.speed > 0 && way.count >= 2) {
+		way.oneway = way_oneway(ctx);
+		g_array_append_val(ctx->ways, way);
+	} else {
+		g_array_set_size(ctx->refs, ctx->way_first);
+	}
+	clear_tags(ctx);
+	ctx->in_way = FALSE;
+}
+
+static gboolean parse_osm(build_s *ctx, const char *path)
+{
+	static const GMarkupParser parser = { start_element, end_element, NULL, NULL, NULL };
+	GMarkupParseContext *context;
+	GError *error = NULL;
+	gchar *buffer;
+	gboolean ok = TRUE;
+	size_t size;
+	FILE *fp;
+
+	fp = fopen(path, "rb");
+	if (fp == NULL) {
+		printf("Fail to open %s\n", path);
+		return FALSE;
+	}
+
+	buffer = (gchar *) malloc(BUILD_CHUNK_SIZE);
+	context = g_markup_parse_context_new(&parser, 0, ctx, NULL);
+	while (ok && (size = fread(buffer, 1, BUILD_CHUNK_SIZE, fp)) > 0) {
+		ok = g_markup_parse_context_parse(context, buffer, size, &error);
+	}
+	ok = ok && g_markup_parse_context_end_parse(context, &error);
+	if (!ok) {
+		printf("Fail to parse %s : %s\n", path, error ? error->message : "unknown error");
+		if (error) {
+			g_error_free(error);
+		}
+	}
+	g_markup_parse_context_free(context);
+	free(buffer);
+	fclose(fp);
+
+	return ok;
+}
+
+static gint compare_node(gconstpointer a, gconstpointer b)
+{
+	gint64 first = ((const build_node_s *)a)->id;
+	gint64 second = ((const build_node_s *)b)->id;
+
+	return first < second ? -1 : first > second;
+}
+
+static guint32 find_node(build_s *ctx, gint64 id)
+{
+	guint low = 0;
+	guint high = ctx->nodes->len;
+
+	while (low < high) {
+		guint middle = low + (high - low) / 2;
+		gint64 current = g_array_index(ctx->nodes, build_node_s, middle).id;
+
+		if (current == id) {
+			return middle;
+		}
+		if (current < id) {
+			low = middle + 1;
+		} else {
+			high = middle;
+		}
+	}
+
+	return BUILD_NO_NODE;
+}
+
+/* Graph nodes are the way ends, the intersections and the ends of the parts of a way with unknown nodes */
+static void select_graph_nodes(build_s *ctx)
+{
+	guint8 *uses = (guint8 *) calloc(ctx->nodes->len ? ctx->nodes->len : 1, sizeof(guint8));
+	guint32 node;
+	guint i;
+	guint j;
+
+	g_array_sort(ctx->nodes, compare_node);
+	ctx->ref_node = (guint32 *) malloc(sizeof(guint32) * (ctx->refs->len ? ctx->refs->len : 1));
+	for (i = 0; i < ctx->refs->len; i++) {
+		ctx->ref_node[i] = find_node(ctx, g_array_index(ctx->refs, gint64, i));
+	}
+
+	for (i = 0; i < ctx->ways->len; i++) {
+		build_way_s *way = &g_array_index(ctx->ways, build_way_s, i);
+		const guint32 *refs = ctx->ref_node + way->first;
+
+		for (j = 0; j < way->count; j++) {
+			if (refs[j] == BUILD_NO_NODE) {
+				continue;
+			}
+			if (j == 0 || j == way->count - 1 || refs[j - 1] == BUILD_NO_NODE || refs[j + 1] == BUILD_NO_NODE) {
+				uses[refs[j]] = 2;
+			} else if (uses[refs[j]] < 2) {
+				uses[refs[j]]++;
+			}
+		}
+		/* Split closed ways, so that no edge goes from a node to itself */
+		if (way->count > 2 && refs[0] == refs[way->count - 1] && refs[way->count / 2] != BUILD_NO_NODE) {
+			uses[refs[way->count / 2]] = 2;
+		}
+	}
+
+	ctx->graph_node = (guint32 *) malloc(sizeof(guint32) * (ctx->nodes->len ? ctx->nodes->len : 1));
+	ctx->node_count = 0;
+	for (node = 0; node < ctx->nodes->len; node++) {
+		ctx->graph_node[node] = uses[node] >= 2 ? ctx->node_count++ : BUILD_NO_NODE;
+	}
+	free(uses);
+}
+
+static void add_edges(build_s *ctx, const build_way_s *way, guint32 source, guint32 target, double distance,
+		      guint32 shape_first)
+{
+	build_edge_s edge;
+
+	edge.distance = (float)distance;
+	edge.duration = (float)(distance / way->speed);
+	edge.shape_first = shape_first;
+	edge.shape_count = ctx->shape->len - shape_first;
+
+	if (way->oneway >= 0) {
+		edge.source = source;
+		edge.target = target;
+		edge.reversed = FALSE;
+		g_array_append_val(ctx->edges, edge);
+	}
+	if (way->oneway <= 0) {
+		edge.source = target;
+		edge.target = source;
+		edge.reversed = TRUE;
+		g_array_append_val(ctx->edges, edge);
+	}
+}
+
+static void build_edges(build_s *ctx)
+{
+	guint i;
+	guint j;
+
+	for (i = 0; i < ctx->ways->len; i++) {
+		build_way_s *way = &g_array_index(ctx->ways, build_way_s, i);
+		guint32 source = BUILD_NO_NODE;
+		guint32 shape_first = 0;
+		double distance = 0;
+		build_node_s *last = NULL;
+
+		for (j = 0; j < way->count; j++) {
+			guint32 ref = ctx->ref_node[way->first + j];
+			build_node_s *node;
+
+			if (ref == BUILD_NO_NODE) {
+				if (source != BUILD_NO_NODE) {
+					g_array_set_size(ctx->shape, shape_first);
+				}
+				source = BUILD_NO_NODE;
+				continue;
+			}
+
+			node = &g_array_index(ctx->nodes, build_node_s, ref);
+			if (source == BUILD_NO_NODE) {
+				source = ctx->graph_node[ref];
+				shape_first = ctx->shape->len;
+				distance = 0;
+				last = node;
+				continue;
+			}
+
+			distance += route_graph_distance(last->lat / 1000000.0, last->lon / 1000000.0,
+							 node->lat / 1000000.0, node->lon / 1000000.0);
+			last = node;
+			if (ctx->graph_node[ref] == BUILD_NO_NODE) {
+				build_point_s point = { node->lat, node->lon };
+				g_array_append_val(ctx->shape, point);
+				continue;
+			}
+
+			add_edges(ctx, way, source, ctx->graph_node[ref], distance, shape_first);
+			source = ctx->graph_node[ref];
+			shape_first = ctx->shape->len;
+			distance = 0;
+		}
+	}
+}
+
+/* Gets the point @index of @edge, counting its source node as 0 and its target node as shape_count + 1 */
+static build_point_s edge_point(build_s *ctx, const build_edge_s *edge, const build_point_s *node_point, guint32 index)
+{
+	if (index == 0) {
+		return node_point[edge->source];
+	}
+	if (index == edge->shape_count + 1) {
+		return node_point[edge->target];
+	}
+
+	return g_array_index(ctx->shape, build_point_s,
+			     edge->shape_first + (edge->reversed ? edge->shape_count - index : index - 1));
+}
+
+static gboolean write_u32(FILE *fp, const guint32 *data, gsize count)
+{
+	return fwrite(data, sizeof(guint32), count, fp) == count;
+}
+
+static gboolean write_graph(build_s *ctx, const char *path)
+{
+	guint32 n = ctx->node_count;
+	guint32 m = ctx->edges->len;
+	route_graph_header_s header;
+	build_point_s *node_point = (build_point_s *) malloc(sizeof(build_point_s) * n);
+	build_edge_s *edges = (build_edge_s *) malloc(sizeof(build_edge_s) * (m ? m : 1));
+	guint32 *first_edge = (guint32 *) calloc(n + 1, sizeof(guint32));
+	guint32 *first_in_edge = (guint32 *) calloc(n + 1, sizeof(guint32));
+	guint32 *column = (guint32 *) malloc(sizeof(guint32) * (m + 1));
+	float *weight = (float *) malloc(sizeof(float) * (m ? m : 1));
+	gint32 min_lat = G_MAXINT32;
+	gint32 min_lon = G_MAXINT32;
+	gint32 max_lat = G_MININT32;
+	gint32 max_lon = G_MININT32;
+	guint32 shape_count = 0;
+	guint32 node;
+	guint32 edge;
+	guint32 row;
+	guint32 col;
+	guint32 i;
+	gboolean ok;
+	FILE *fp;
+
+	for (node = 0; node < ctx->nodes->len; node++) {
+		build_node_s *osm = &g_array_index(ctx->nodes, build_node_s, node);
+
+		if (ctx->graph_node[node] != BUILD_NO_NODE) {
+			node_point[ctx->graph_node[node]].lat = osm->lat;
+			node_point[ctx->graph_node[node]].lon = osm->lon;
+		}
+	}
+
+	/* Outgoing edges, grouped by source in the order they were built */
+	for (edge = 0; edge < m; edge++) {
+		first_edge[g_array_index(ctx->edges, build_edge_s, edge).source + 1]++;
+		first_in_edge[g_array_index(ctx->edges, build_edge_s, edge).target + 1]++;
+	}
+	for (node = 0; node < n; node++) {
+		first_edge[node + 1] += first_edge[node];
+		first_in_edge[node + 1] += first_in_edge[node];
+	}
+	guint32 *fill = (guint32 *) malloc(sizeof(guint32) * n);
+	memcpy(fill, first_edge, sizeof(guint32) * n);
+	for (edge = 0; edge < m; edge++) {
+		build_edge_s *e = &g_array_index(ctx->edges, build_edge_s, edge);
+		edges[fill[e->source]++] = *e;
+		shape_count += e->shape_count;
+	}
+
+	/* The grid cell size follows the density of the edges, for a few edges per cell */
+	for (edge = 0; edge < m; edge++) {
+		for (i = 0; i < edges[edge].shape_count + 2; i++) {
+			build_point_s point = edge_point(ctx, &edges[edge], node_point, i);
+			min_lat = MIN(min_lat, point.lat);
+			min_lon = MIN(min_lon, point.lon);
+			max_lat = MAX(max_lat, point.lat);
+			max_lon = MAX(max_lon, point.lon);
+		}
+	}
+	for (node = 0; node < n; node++) {
+		min_lat = MIN(min_lat, node_point[node].lat);
+		min_lon = MIN(min_lon, node_point[node].lon);
+		max_lat = MAX(max_lat, node_point[node].lat);
+		max_lon = MAX(max_lon, node_point[node].lon);
+	}
+	double area = ((double)max_lat - min_lat) * ((double)max_lon - min_lon);
+	gint32 cell_size = MAX(BUILD_MIN_CELL_SIZE, (gint32) sqrt(area * BUILD_EDGES_PER_CELL / (m ? m : 1)));
+	guint32 columns = (guint32)(((gint64) max_lon - min_lon) / cell_size + 1);
+	guint32 rows = (guint32)(((gint64) max_lat - min_lat) / cell_size + 1);
+	guint32 cells = columns * rows;
+	guint32 *grid_first = (guint32 *) calloc(cells + 1, sizeof(guint32));
+	guint32 *grid_edge;
+	guint32 *edge_cells = (guint32 *) malloc(sizeof(guint32) * 4 * (m ? m : 1));
+
+	for (edge = 0; edge < m; edge++) {
+		guint32 *range = edge_cells + 4 * edge;
+		gint32 lat1 = G_MAXINT32, lon1 = G_MAXINT32, lat2 = G_MININT32, lon2 = G_MININT32;
+
+		for (i = 0; i < edges[edge].shape_count + 2; i++) {
+			build_point_s point = edge_point(ctx, &edges[edge], node_point, i);
+			lat1 = MIN(lat1, point.lat);
+			lon1 = MIN(lon1, point.lon);
+			lat2 = MAX(lat2, point.lat);
+			lon2 = MAX(lon2, point.lon);
+		}
+		range[0] = (guint32)(((gint64) lon1 - min_lon) / cell_size);
+		range[1] = (guint32)(((gint64) lat1 - min_lat) / cell_size);
+		range[2] = (guint32)(((gint64) lon2 - min_lon) / cell_size);
+		range[3] = (guint32)(((gint64) lat2 - min_lat) / cell_size);
+		for (row = range[1]; row <= range[3]; row++) {
+			for (col = range[0]; col <= range[2]; col++) {
+				grid_first[row * columns + col + 1]++;
+			}
+		}
+	}
+	for (i = 0; i < cells; i++) {
+		grid_first[i + 1] += grid_first[i];
+	}
+	grid_edge = (guint32 *) malloc(sizeof(guint32) * (grid_first[cells] ? grid_first[cells] : 1));
+	guint32 *grid_fill = (guint32 *) malloc(sizeof(guint32) * cells);
+	memcpy(grid_fill, grid_first, sizeof(guint32) * cells);
+	for (edge = 0; edge < m; edge++) {
+		guint32 *range = edge_cells + 4 * edge;
+		for (row = range[1]; row <= range[3]; row++) {
+			for (col = range[0]; col <= range[2]; col++) {
+				grid_edge[grid_fill[row * columns + col]++] = edge;
+			}
+		}
+	}
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, ROUTE_GRAPH_MAGIC, 4);
+	header.version = ROUTE_GRAPH_VERSION;
+	header.node_count = n;
+	header.edge_count = m;
+	header.shape_count = shape_count;
+	header.grid_columns = columns;
+	header.grid_rows = rows;
+	header.grid_entry_count = grid_first[cells];
+	header.grid_min_lat = min_lat;
+	header.grid_min_lon = min_lon;
+	header.grid_cell_size = cell_size;
+	for (edge = 0; edge < m; edge++) {
+		if (edges[edge].duration > 0 && edges[edge].distance / edges[edge].duration > header.max_speed) {
+			header.max_speed = edges[edge].distance / edges[edge].duration;
+		}
+	}
+
+	fp = fopen(path, "wb");
+	if (fp == NULL) {
+		printf("Fail to open %s\n", path);
+		ok = FALSE;
+		goto out;
+	}
+
+	ok = fwrite(&header, sizeof(header), 1, fp) == 1;
+	for (node = 0; node < n; node++) {
+		column[node] = (guint32) node_point[node].lat;
+	}
+	ok = ok && write_u32(fp, column, n);
+	for (node = 0; node < n; node++) {
+		column[node] = (guint32) node_point[node].lon;
+	}
+	ok = ok && write_u32(fp, column, n);
+	ok = ok && write_u32(fp, first_edge, n + 1);
+
+#define WRITE_EDGE_FIELD(field, array, type) \
+	for (edge = 0; edge < m; edge++) { array[edge] = (type) edges[edge].field; } \
+	ok = ok && fwrite(array, sizeof(type), m, fp) == m;
+
+	WRITE_EDGE_FIELD(target, column, guint32);
+	WRITE_EDGE_FIELD(distance, weight, float);
+	WRITE_EDGE_FIELD(duration, weight, float);
+	WRITE_EDGE_FIELD(source, column, guint32);
+#undef WRITE_EDGE_FIELD
+
+	/* Incoming edges, grouped by target */
+	ok = ok && write_u32(fp, first_in_edge, n + 1);
+	memcpy(fill, first_in_edge, sizeof(guint32) * n);
+	for (edge = 0; edge < m; edge++) {
+		column[fill[edges[edge].target]++] = edge;
+	}
+	ok = ok && write_u32(fp, column, m);
+
+	column[0] = 0;
+	for (edge = 0; edge < m; edge++) {
+		column[edge + 1] = column[edge] + edges[edge].shape_count;
+	}
+	ok = ok && write_u32(fp, column, m + 1);
+	for (edge = 0; edge < m && ok; edge++) {
+		for (i = 1; i <= edges[edge].shape_count && ok; i++) {
+			gint32 lat = edge_point(ctx, &edges[edge], node_point, i).lat;
+			ok = fwrite(&lat, sizeof(gint32), 1, fp) == 1;
+		}
+	}
+	for (edge = 0; edge < m && ok; edge++) {
+		for (i = 1; i <= edges[edge].shape_count && ok; i++) {
+			gint32 lon = edge_point(ctx, &edges[edge], node_point, i).lon;
+			ok = fwrite(&lon, sizeof(gint32), 1, fp) == 1;
+		}
+	}
+
+	ok = ok && write_u32(fp, grid_first, cells + 1) && write_u32(fp, grid_edge, grid_first[cells]);
+	ok = (fclose(fp) == 0) && ok;
+	if (!ok) {
+		printf("Fail to write %s\n", path);
+	}
+
+ out:
+	free(node_point);
+	free(edges);
+	free(first_edge);
+	free(first_in_edge);
+	free(fill);
+	free(column);
+	free(weight);
+	free(grid_first);
+	free(grid_edge);
+	free(grid_fill);
+	free(edge_cells);
+
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	build_s ctx;
+	int ret = 1;
+
+	if (argc != 3) {
+		printf("usage: %s <input osm> <output graph>\n", argv[0]);
+		return 1;
+	}
+	if (g_str_has_suffix(argv[1], ".pbf")) {
+		printf("PBF input is not supported, convert it to OSM XML first (e.g. osmium cat %s -o input.osm)\n", argv[1]);
+		return 1;
+	}
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.nodes = g_array_new(FALSE, FALSE, sizeof(build_node_s));
+	ctx.ways = g_array_new(FALSE, FALSE, sizeof(build_way_s));
+	ctx.refs = g_array_new(FALSE, FALSE, sizeof(gint64));
+	ctx.edges = g_array_new(FALSE, FALSE, sizeof(build_edge_s));
+	ctx.shape = g_array_new(FALSE, FALSE, sizeof(build_point_s));
+
+	if (parse_osm(&ctx, argv[1])) {
+		printf("%u nodes, %u routable ways\n", ctx.nodes->len, ctx.ways->len);
+		select_graph_nodes(&ctx);
+		build_edges(&ctx);
+		printf("%u graph nodes, %u edges, %u shape points\n", ctx.node_count, ctx.edges->len, ctx.shape->len);
+		if (ctx.node_count == 0) {
+			printf("No routable road in %s\n", argv[1]);
+		} else if (write_graph(&ctx, argv[2])) {
+			ret = 0;
+		}
+	}
+
+	clear_tags(&ctx);
+	free(ctx.ref_node);
+	free(ctx.graph_node);
+	g_array_free(ctx.nodes, TRUE);
+	g_array_free(ctx.ways, TRUE);
+	g_array_free(ctx.refs, TRUE);
+	g_array_free(ctx.edges, TRUE);
+	g_array_free(ctx.shape, TRUE);
+
+	return ret;
+}
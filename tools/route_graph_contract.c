@@ -0,0 +1,453 @@
+/*
+* Copyright (c) 2011 Samsung Electronics Co., Ltd All Rights Reserved
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+*/
+
+/*
+ * Builds the Contraction Hierarchy of a road graph file for the offline route service.
+ *
+ * usage: route_graph_contract [-m duration|distance] <input graph> <output graph>
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <glib.h>
+
+#include <route_private.h>
+
+#define CONTRACT_WITNESS_SETTLE_LIMIT 500
+
+typedef struct {
+	guint32 source;
+	guint32 target;
+	double weight;
+	guint32 first;
+	guint32 second;
+} contract_arc_s;
+
+typedef struct {
+	double key;
+	guint32 node;
+} contract_heap_item_s;
+
+typedef struct {
+	route_graph_s *graph;
+	GArray *arcs;
+	GArray **out;
+	GArray **in;
+	gboolean *contracted;
+	guint32 *deleted_neighbors;
+	guint32 *rank;
+
+	/* witness search */
+	double *dist;
+	guint32 *stamp;
+	guint32 generation;
+	GArray *heap;
+} contract_s;
+
+static void heap_push(GArray *heap, double key, guint32 node)
+{
+	contract_heap_item_s item = { key, node };
+	guint i;
+
+	g_array_append_val(heap, item);
+	for (i = heap->len - 1; i > 0; i = (i - 1) / 2) {
+		if (g_array_index(heap, contract_heap_item_s, (i - 1) / 2).key <= key) {
+			break;
+		}
+		g_array_index(heap, contract_heap_item_s, i) = g_array_index(heap, contract_heap_item_s, (i - 1) / 2);
+	}
+	g_array_index(heap, contract_heap_item_s, i) = item;
+}
+
+static contract_heap_item_s heap_pop(GArray *heap)
+{
+	contract_heap_item_s top = g_array_index(heap, contract_heap_item_s, 0);
+	contract_heap_item_s last = g_array_index(heap, contract_heap_item_s, heap->len - 1);
+	guint i = 0;
+
+	g_array_set_size(heap, heap->len - 1);
+	if (heap->len == 0) {
+		return top;
+	}
+	while (2 * i + 1 < heap->len) {
+		guint child = 2 * i + 1;
+		if (child + 1 < heap->len
+		    && g_array_index(heap, contract_heap_item_s, child + 1).key < g_array_index(heap, contract_heap_item_s, child).key) {
+			child++;
+		}
+		if (last.key <= g_array_index(heap, contract_heap_item_s, child).key) {
+			break;
+		}
+		g_array_index(heap, contract_heap_item_s, i) = g_array_index(heap, contract_heap_item_s, child);
+		i = child;
+	}
+	g_array_index(heap, contract_heap_item_s, i) = last;
+
+	return top;
+}
+
+static contract_arc_s *arc_at(contract_s *ctx, guint32 arc)
+{
+	return &g_array_index(ctx->arcs, contract_arc_s, arc);
+}
+
+static guint32 add_arc(contract_s *ctx, guint32 source, guint32 target, double weight, guint32 first, guint32 second)
+{
+	contract_arc_s arc = { source, target, weight, first, second };
+	guint32 index = ctx->arcs->len;
+
+	g_array_append_val(ctx->arcs, arc);
+	g_array_append_val(ctx->out[source], index);
+	g_array_append_val(ctx->in[target], index);
+
+	return index;
+}
+
+static double witness_distance(contract_s *ctx, guint32 node)
+{
+	return ctx->stamp[node] == ctx->generation ? ctx->dist[node] : G_MAXDOUBLE;
+}
+
+/* Dijkstra from @source over the uncontracted nodes other than @via, bounded by @limit */
+static void witness_search(contract_s *ctx, guint32 source, guint32 via, double limit)
+{
+	int settled = 0;
+	guint i;
+
+	ctx->generation++;
+	g_array_set_size(ctx->heap, 0);
+	ctx->stamp[source] = ctx->generation;
+	ctx->dist[source] = 0;
+	heap_push(ctx->heap, 0, source);
+
+	while (ctx->heap->len && settled++ < CONTRACT_WITNESS_SETTLE_LIMIT) {
+		contract_heap_item_s item = heap_pop(ctx->heap);
+		if (item.key > witness_distance(ctx, item.node)) {
+			continue;
+		}
+		if (item.key > limit) {
+			break;
+		}
+		for (i = 0; i < ctx->out[item.node]->len; i++) {
+			contract_arc_s *arc = arc_at(ctx, g_array_index(ctx->out[item.node], guint32, i));
+			double dist = item.key + arc->weight;
+
+			if (arc->target == via || ctx->contracted[arc->target] || dist >= witness_distance(ctx, arc->target)) {
+				continue;
+			}
+			ctx->stamp[arc->target] = ctx->generation;
+			ctx->dist[arc->target] = dist;
+			heap_push(ctx->heap, dist, arc->target);
+		}
+	}
+}
+
+/* Returns the number of shortcuts contracting @node needs, and adds them unless @simulate */
+static int contract_node(contract_s *ctx, guint32 node, gboolean simulate)
+{
+	int shortcuts = 0;
+	guint i;
+	guint j;
+
+	for (i = 0; i < ctx->in[node]->len; i++) {
+		guint32 in_arc = g_array_index(ctx->in[node], guint32, i);
+		guint32 source = arc_at(ctx, in_arc)->source;
+		double in_weight = arc_at(ctx, in_arc)->weight;
+		double max_out = 0;
+
+		if (ctx->contracted[source]) {
+			continue;
+		}
+		for (j = 0; j < ctx->out[node]->len; j++) {
+			contract_arc_s *out = arc_at(ctx, g_array_index(ctx->out[node], guint32, j));
+			if (!ctx->contracted[out->target] && out->target != source && out->weight > max_out) {
+				max_out = out->weight;
+			}
+		}
+
+		witness_search(ctx, source, node, in_weight + max_out);
+
+		for (j = 0; j < ctx->out[node]->len; j++) {
+			guint32 out_arc = g_array_index(ctx->out[node], guint32, j);
+			guint32 target = arc_at(ctx, out_arc)->target;
+			double weight = in_weight + arc_at(ctx, out_arc)->weight;
+
+			if (ctx->contracted[target] || target == source || witness_distance(ctx, target) <= weight) {
+				continue;
+			}
+			shortcuts++;
+			if (!simulate) {
+				add_arc(ctx, source, target, weight, in_arc, out_arc);
+			}
+		}
+	}
+
+	return shortcuts;
+}
+
+static double priority(contract_s *ctx, guint32 node)
+{
+	int degree = 0;
+	guint i;
+
+	for (i = 0; i < ctx->in[node]->len; i++) {
+		degree += !ctx->contracted[arc_at(ctx, g_array_index(ctx->in[node], guint32, i))->source];
+	}
+	for (i = 0; i < ctx->out[node]->len; i++) {
+		degree += !ctx->contracted[arc_at(ctx, g_array_index(ctx->out[node], guint32, i))->target];
+	}
+
+	return contract_node(ctx, node, TRUE) - degree + ctx->deleted_neighbors[node];
+}
+
+static void add_original_arcs(contract_s *ctx, route_graph_metric_e metric)
+{
+	route_graph_s *graph = ctx->graph;
+	guint32 *last_arc = (guint32 *) malloc(sizeof(guint32) * graph->node_count);
+	guint32 node;
+	guint32 edge;
+
+	memset(last_arc, 0xff, sizeof(guint32) * graph->node_count);
+	for (node = 0; node < graph->node_count; node++) {
+		guint32 first_arc = ctx->arcs->len;
+
+		for (edge = graph->first_edge[node]; edge < graph->first_edge[node + 1]; edge++) {
+			guint32 target = graph->edge_target[edge];
+			double weight = metric == ROUTE_GRAPH_METRIC_DISTANCE ? graph->edge_distance[edge] : graph->edge_duration[edge];
+
+			if (target == node) {
+				continue;
+			}
+			/* Keep only the cheapest of parallel edges */
+			if (last_arc[target] != ROUTE_GRAPH_NO_ARC && last_arc[target] >= first_arc) {
+				contract_arc_s *arc = arc_at(ctx, last_arc[target]);
+				if (weight < arc->weight) {
+					arc->weight = weight;
+					arc->first = edge;
+				}
+				continue;
+			}
+			last_arc[target] = add_arc(ctx, node, target, weight, edge, ROUTE_GRAPH_NO_ARC);
+		}
+	}
+	free(last_arc);
+}
+
+static void contract(contract_s *ctx)
+{
+	guint32 n = ctx->graph->node_count;
+	guint32 order = 0;
+	GArray *queue = g_array_new(FALSE, FALSE, sizeof(contract_heap_item_s));
+	guint32 node;
+	guint i;
+
+	for (node = 0; node < n; node++) {
+		heap_push(queue, priority(ctx, node), node);
+	}
+
+	while (queue->len) {
+		contract_heap_item_s item = heap_pop(queue);
+		double current = priority(ctx, item.node);
+
+		/* Lazy update: contract only if the node is still the cheapest one */
+		if (queue->len && current > g_array_index(queue, contract_heap_item_s, 0).key) {
+			heap_push(queue, current, item.node);
+			continue;
+		}
+
+		contract_node(ctx, item.node, FALSE);
+		ctx->contracted[item.node] = TRUE;
+		ctx->rank[item.node] = order++;
+
+		for (i = 0; i < ctx->in[item.node]->len; i++) {
+			ctx->deleted_neighbors[arc_at(ctx, g_array_index(ctx->in[item.node], guint32, i))->source]++;
+		}
+		for (i = 0; i < ctx->out[item.node]->len; i++) {
+			ctx->deleted_neighbors[arc_at(ctx, g_array_index(ctx->out[item.node], guint32, i))->target]++;
+		}
+		if (order % 10000 == 0) {
+			printf("contracted %u / %u nodes, %u arcs\n", order, n, ctx->arcs->len);
+		}
+	}
+	g_array_free(queue, TRUE);
+}
+
+static gboolean write_u32(FILE *fp, const guint32 *data, gsize count)
+{
+	return fwrite(data, sizeof(guint32), count, fp) == count;
+}
+
+static gboolean write_graph(contract_s *ctx, route_graph_metric_e metric, const char *path)
+{
+	route_graph_s *graph = ctx->graph;
+	guint32 n = graph->node_count;
+	guint32 arc_count = ctx->arcs->len;
+	route_graph_ch_header_s header;
+	guint32 *column = (guint32 *) malloc(sizeof(guint32) * (arc_count ? arc_count : 1));
+	float *weight = (float *) malloc(sizeof(float) * (arc_count ? arc_count : 1));
+	guint32 *up_first = (guint32 *) calloc(n + 1, sizeof(guint32));
+	guint32 *down_first = (guint32 *) calloc(n + 1, sizeof(guint32));
+	guint32 *up_arc = (guint32 *) malloc(sizeof(guint32) * (arc_count ? arc_count : 1));
+	guint32 *down_arc = (guint32 *) malloc(sizeof(guint32) * (arc_count ? arc_count : 1));
+	gboolean ok;
+	guint32 arc;
+	guint32 node;
+	FILE *fp;
+
+	memcpy(header.magic, ROUTE_GRAPH_CH_MAGIC, 4);
+	header.metric = metric;
+	header.arc_count = arc_count;
+	header.reserved = 0;
+
+	/* Upward arcs are searched from their source, downward arcs backward from their target. */
+	for (arc = 0; arc < arc_count; arc++) {
+		contract_arc_s *a = arc_at(ctx, arc);
+		if (ctx->rank[a->source] < ctx->rank[a->target]) {
+			up_first[a->source + 1]++;
+		} else {
+			down_first[a->target + 1]++;
+		}
+	}
+	for (node = 0; node < n; node++) {
+		up_first[node + 1] += up_first[node];
+		down_first[node + 1] += down_first[node];
+	}
+	guint32 *up_fill = (guint32 *) malloc(sizeof(guint32) * n);
+	guint32 *down_fill = (guint32 *) malloc(sizeof(guint32) * n);
+	memcpy(up_fill, up_first, sizeof(guint32) * n);
+	memcpy(down_fill, down_first, sizeof(guint32) * n);
+	for (arc = 0; arc < arc_count; arc++) {
+		contract_arc_s *a = arc_at(ctx, arc);
+		if (ctx->rank[a->source] < ctx->rank[a->target]) {
+			up_arc[up_fill[a->source]++] = arc;
+		} else {
+			down_arc[down_fill[a->target]++] = arc;
+		}
+	}
+	free(up_fill);
+	free(down_fill);
+
+	fp = fopen(path, "wb");
+	if (fp == NULL) {
+		printf("Fail to open %s\n", path);
+		ok = FALSE;
+		goto out;
+	}
+
+	ok = fwrite(graph->data, 1, graph->base_size, fp) == graph->base_size;
+	ok = ok && fwrite(&header, sizeof(header), 1, fp) == 1;
+	ok = ok && write_u32(fp, ctx->rank, n);
+
+#define WRITE_ARC_FIELD(field) \
+	for (arc = 0; arc < arc_count; arc++) { column[arc] = arc_at(ctx, arc)->field; } \
+	ok = ok && write_u32(fp, column, arc_count);
+
+	WRITE_ARC_FIELD(source);
+	WRITE_ARC_FIELD(target);
+	for (arc = 0; arc < arc_count; arc++) {
+		weight[arc] = (float)arc_at(ctx, arc)->weight;
+	}
+	ok = ok && fwrite(weight, sizeof(float), arc_count, fp) == arc_count;
+	WRITE_ARC_FIELD(first);
+	WRITE_ARC_FIELD(second);
+#undef WRITE_ARC_FIELD
+
+	ok = ok && write_u32(fp, up_first, n + 1) && write_u32(fp, up_arc, up_first[n]);
+	ok = ok && write_u32(fp, down_first, n + 1) && write_u32(fp, down_arc, down_first[n]);
+	ok = (fclose(fp) == 0) && ok;
+	if (!ok) {
+		printf("Fail to write %s\n", path);
+	}
+
+ out:
+	free(column);
+	free(weight);
+	free(up_first);
+	free(down_first);
+	free(up_arc);
+	free(down_arc);
+
+	return ok;
+}
+
+int main(int argc, char **argv)
+{
+	route_graph_metric_e metric = ROUTE_GRAPH_METRIC_DURATION;
+	contract_s ctx;
+	guint32 node;
+	int arg = 1;
+
+	if (argc > 2 && strcmp(argv[1], "-m") == 0) {
+		if (strcmp(argv[2], "distance") == 0) {
+			metric = ROUTE_GRAPH_METRIC_DISTANCE;
+		} else if (strcmp(argv[2], "duration") != 0) {
+			printf("Unknown metric : %s\n", argv[2]);
+			return 1;
+		}
+		arg = 3;
+	}
+	if (argc - arg != 2) {
+		printf("usage: %s [-m duration|distance] <input graph> <output graph>\n", argv[0]);
+		return 1;
+	}
+
+	memset(&ctx, 0, sizeof(ctx));
+	ctx.graph = route_graph_load(argv[arg]);
+	if (ctx.graph == NULL) {
+		printf("Fail to load %s\n", argv[arg]);
+		return 1;
+	}
+
+	guint32 n = ctx.graph->node_count;
+	ctx.arcs = g_array_new(FALSE, FALSE, sizeof(contract_arc_s));
+	ctx.out = (GArray **) malloc(sizeof(GArray *) * n);
+	ctx.in = (GArray **) malloc(sizeof(GArray *) * n);
+	for (node = 0; node < n; node++) {
+		ctx.out[node] = g_array_new(FALSE, FALSE, sizeof(guint32));
+		ctx.in[node] = g_array_new(FALSE, FALSE, sizeof(guint32));
+	}
+	ctx.contracted = (gboolean *) calloc(n, sizeof(gboolean));
+	ctx.deleted_neighbors = (guint32 *) calloc(n, sizeof(guint32));
+	ctx.rank = (guint32 *) calloc(n, sizeof(guint32));
+	ctx.dist = (double *) malloc(sizeof(double) * n);
+	ctx.stamp = (guint32 *) calloc(n, sizeof(guint32));
+	ctx.heap = g_array_new(FALSE, FALSE, sizeof(contract_heap_item_s));
+
+	add_original_arcs(&ctx, metric);
+	printf("%u nodes, %u edges, %u arcs\n", n, ctx.graph->edge_count, ctx.arcs->len);
+	contract(&ctx);
+	printf("%u arcs after contraction\n", ctx.arcs->len);
+
+	int ret = write_graph(&ctx, metric, argv[arg + 1]) ? 0 : 1;
+
+	for (node = 0; node < n; node++) {
+		g_array_free(ctx.out[node], TRUE);
+		g_array_free(ctx.in[node], TRUE);
+	}
+	free(ctx.out);
+	free(ctx.in);
+	free(ctx.contracted);
+	free(ctx.deleted_neighbors);
+	free(ctx.rank);
+	free(ctx.dist);
+	free(ctx.stamp);
+	g_array_free(ctx.heap, TRUE);
+	g_array_free(ctx.arcs, TRUE);
+	route_graph_free(ctx.graph);
+
+	return ret;
+}